@@ -0,0 +1,53 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using System.IO;
+using UnrealBuildTool;
+
+// libwebp (dec, enc, demux, mux, sharpyuv) compiled from source as part of the plugin.
+// Used on Linux, where there is no prebuilt library; Win64 keeps linking lib/libwebp.lib.
+//
+// Expected layout, written by update_libwebp.py from an upstream release:
+//   ThirdParty/libwebp/webp/       public headers (already used by WebPImageSupport)
+//   ThirdParty/libwebp/src/        upstream src/ (dec, demux, dsp, enc, mux, utils)
+//   ThirdParty/libwebp/sharpyuv/   upstream sharpyuv/
+//   ThirdParty/libwebp/simd/       upstream src/dsp/*_sse41.c and *_avx2.c, each compiled for its own ISA
+// Headers in webp/ must come from the same release as src/.
+public class LibWebP : ModuleRules
+{
+    public LibWebP(ReadOnlyTargetRules Target) : base(Target)
+    {
+        // Plain C, no engine dependencies and no PCH
+        PCHUsage = ModuleRules.PCHUsageMode.NoPCHs;
+        bUseUnity = false;                 // libwebp reuses static helper names across files
+        bDisableStaticAnalysis = true;
+        bEnableUndefinedIdentifierWarnings = false;
+        ShadowVariableWarningLevel = WarningLevel.Off;
+
+        PublicIncludePaths.Add(ModuleDirectory);    // #include "webp/decode.h"
+        PrivateIncludePaths.Add(ModuleDirectory);   // upstream uses "src/..." and "sharpyuv/..." includes
+
+        string SrcDir = Path.Combine(ModuleDirectory, "src");
+        string SharpYuvDir = Path.Combine(ModuleDirectory, "sharpyuv");
+        string SimdDir = Path.Combine(ModuleDirectory, "simd");
+        bool bX64 = Target.Architecture == UnrealArch.X64;
+        if (!Directory.Exists(SrcDir) || !Directory.Exists(SharpYuvDir) || (bX64 && !Directory.Exists(SimdDir)))
+        {
+            // Carrying on would only move the failure to link time, as hundreds of unresolved WebP* symbols
+            throw new BuildException("LibWebP: libwebp sources not found in " + ModuleDirectory + ". Run update_libwebp.py on an upstream release "
+                + "matching webp/ (decoder ABI 0x0209, encoder ABI 0x0210).");
+        }
+
+        // Multi-threaded decoding/encoding (WebPDecoderOptions.use_threads / WebPConfig.thread_level)
+        PrivateDefinitions.Add("WEBP_USE_THREAD");
+
+        // SSE2 (x64) and NEON (arm64) are part of the target baseline, so libwebp's dsp/cpu.h enables those kernels
+        // from the compiler's own __SSE2__ / __ARM_NEON. The SSE4.1 and AVX2 kernels in simd/ carry their ISA inside
+        // the file (a clang target pragma, see update_libwebp.py), so they are built whatever MinCpuArchX64 is;
+        // WEBP_HAVE_* tells the generic dsp init functions to hand them to the cpuid dispatch (VP8GetCPUInfo).
+        if (bX64)
+        {
+            PrivateDefinitions.Add("WEBP_HAVE_SSE41");
+            PrivateDefinitions.Add("WEBP_HAVE_AVX2");
+        }
+    }
+}
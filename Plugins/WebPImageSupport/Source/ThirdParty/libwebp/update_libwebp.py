@@ -0,0 +1,91 @@
+import argparse
+import os
+import re
+import shutil
+
+# Copies an upstream libwebp release into this folder for the Linux source build (LibWebP.Build.cs):
+#
+#   python update_libwebp.py path/to/libwebp-x.y.z
+#
+# src/ and sharpyuv/ are copied as-is, except the x64 kernels that need more than the SSE2 baseline
+# (src/dsp/*_sse41.c, *_avx2.c). UBT can't give single files their own -msse4.1 / -mavx2, so those are moved to
+# simd/ with the target ISA applied inside the file instead. libwebp's cpuid dispatch (VP8GetCPUInfo) only calls
+# them on CPUs that have the ISA.
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+# File suffix -> (clang target feature, libwebp macro that enables the kernel in the file)
+SIMD_SETS = {
+    "_sse41.c": ("sse4.1", "WEBP_USE_SSE41"),
+    "_avx2.c": ("avx2", "WEBP_USE_AVX2"),
+}
+
+SIMD_TEMPLATE = """// Generated by update_libwebp.py from upstream {source}; do not edit.
+// Compiled for {feature} whatever the target's baseline; only reached through libwebp's cpuid dispatch.
+#include <immintrin.h>  // Before the pragma: the intrinsic headers carry their own target attributes
+#define {macro}
+#pragma clang attribute push (__attribute__((target("{feature}"))), apply_to = function)
+#line 1 "{source}"
+{body}
+#pragma clang attribute pop
+"""
+
+
+def copy_sources(upstream, name):
+    source = os.path.join(upstream, name)
+    if not os.path.isdir(source):
+        raise SystemExit("Not a libwebp release: missing " + source)
+    destination = os.path.join(HERE, name)
+    shutil.rmtree(destination, ignore_errors=True)
+    # Sources and headers only; the upstream makefiles and CMake lists aren't used
+    shutil.copytree(source, destination, ignore=lambda _, files: [
+        f for f in files if os.path.isfile(os.path.join(_, f)) and not f.endswith((".c", ".h"))])
+
+
+def move_simd_kernels():
+    simd_dir = os.path.join(HERE, "simd")
+    shutil.rmtree(simd_dir, ignore_errors=True)
+    os.makedirs(simd_dir)
+    dsp_dir = os.path.join(HERE, "src", "dsp")
+    for file_name in sorted(os.listdir(dsp_dir)):
+        for suffix, (feature, macro) in SIMD_SETS.items():
+            if not file_name.endswith(suffix):
+                continue
+            path = os.path.join(dsp_dir, file_name)
+            with open(path, "r", encoding="utf-8") as f:
+                body = f.read()
+            with open(os.path.join(simd_dir, file_name), "w", encoding="utf-8", newline="\n") as f:
+                f.write(SIMD_TEMPLATE.format(source="src/dsp/" + file_name, feature=feature, macro=macro, body=body))
+            os.remove(path)
+            print("simd/" + file_name + " (" + feature + ")")
+
+
+def copy_public_headers(upstream):
+    # The plugin includes webp/*.h from here; keep them from the same release as src/
+    source = os.path.join(upstream, "src", "webp")
+    for file_name in os.listdir(source):
+        if file_name.endswith(".h"):
+            shutil.copy2(os.path.join(source, file_name), os.path.join(HERE, "webp", file_name))
+
+
+def read_abi(header, macro):
+    with open(os.path.join(HERE, "webp", header), "r", encoding="utf-8") as f:
+        match = re.search(r"#define\s+" + macro + r"\s+(0x[0-9a-fA-F]+)", f.read())
+    return match.group(1) if match else "?"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Vendor an upstream libwebp release for the LibWebP module.")
+    parser.add_argument("upstream", help="Extracted libwebp release (the folder containing src/ and sharpyuv/)")
+    args = parser.parse_args()
+
+    copy_sources(args.upstream, "src")
+    copy_sources(args.upstream, "sharpyuv")
+    move_simd_kernels()
+    copy_public_headers(args.upstream)
+    print("libwebp decoder ABI " + read_abi("decode.h", "WEBP_DECODER_ABI_VERSION")
+          + ", encoder ABI " + read_abi("encode.h", "WEBP_ENCODER_ABI_VERSION"))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,58 @@
+// WebPBenchmarkCommandlet.cpp
+#include "WebPBenchmarkCommandlet.h"
+#include "WebPBenchmark.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWebPBenchmarkCommandlet, Log, All);
+
+UWebPBenchmarkCommandlet::UWebPBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UWebPBenchmarkCommandlet::Main(const FString& Params)
+{
+    FWebPBenchmarkContext Context;
+    Context.bQuick = FParse::Param(*Params, TEXT("Quick"));
+    FParse::Value(*Params, TEXT("Iterations="), Context.Iterations);
+    FParse::Value(*Params, TEXT("Warmup="), Context.WarmupIterations);
+    Context.Iterations = FMath::Max(Context.Iterations, 1);
+    Context.WarmupIterations = FMath::Max(Context.WarmupIterations, 0);
+
+    TArray<FString> SuiteNames;
+    FString SuiteList;
+    if (FParse::Value(*Params, TEXT("Suite="), SuiteList, false))
+    {
+        SuiteList.ParseIntoArray(SuiteNames, TEXT(","));
+    }
+    else
+    {
+        SuiteNames = FWebPBenchmarkRegistry::Get().GetSuiteNames();
+    }
+
+    bool bAllSucceeded = true;
+    for (const FString& SuiteName : SuiteNames)
+    {
+        bAllSucceeded &= FWebPBenchmarkRegistry::Get().RunSuite(SuiteName.TrimStartAndEnd(), Context);
+    }
+
+    Context.LogSummary();
+
+    FString OutputPath;
+    if (!FParse::Value(*Params, TEXT("Output="), OutputPath))
+    {
+        OutputPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / FString::Printf(TEXT("WebP-%s.json"), *FDateTime::Now().ToString());
+    }
+    if (!FFileHelper::SaveStringToFile(Context.ToJson(), *OutputPath))
+    {
+        UE_LOG(LogWebPBenchmarkCommandlet, Error, TEXT("Failed to write benchmark report to %s"), *OutputPath);
+        return 1;
+    }
+    UE_LOG(LogWebPBenchmarkCommandlet, Display, TEXT("Wrote %d benchmark results to %s"), Context.GetResults().Num(), *OutputPath);
+
+    return bAllSucceeded ? 0 : 1;
+}
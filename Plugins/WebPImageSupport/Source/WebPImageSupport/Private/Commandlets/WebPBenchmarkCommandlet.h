@@ -0,0 +1,24 @@
+// WebPBenchmarkCommandlet.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "WebPBenchmarkCommandlet.generated.h"
+
+/**
+ * Headless benchmark runner: UnrealEditor-Cmd VNM -run=WebPBenchmark [-Suite=Decode,Encode] [-Iterations=N] [-Quick] [-Output=File.json]
+ * Runs the suites registered with FWebPBenchmarkRegistry and writes the JSON report so builds can be compared.
+ * Add -WebPNoAsm to run libwebp on its plain C kernels (compare against a run without it).
+ */
+UCLASS()
+class UWebPBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UWebPBenchmarkCommandlet();
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+};
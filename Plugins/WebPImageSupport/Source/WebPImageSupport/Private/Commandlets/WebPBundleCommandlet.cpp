@@ -0,0 +1,131 @@
+// WebPBundleCommandlet.cpp
+#include "WebPBundleCommandlet.h"
+#include "WebPBundle.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWebPBundleCommandlet, Log, All);
+
+UWebPBundleCommandlet::UWebPBundleCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UWebPBundleCommandlet::Main(const FString& Params)
+{
+    FString SourceDir;
+    FString OutputPath;
+    if (!FParse::Value(*Params, TEXT("Source="), SourceDir) || !FParse::Value(*Params, TEXT("Output="), OutputPath))
+    {
+        UE_LOG(LogWebPBundleCommandlet, Error, TEXT("Usage: -run=WebPBundle -Source=<Dir> -Output=<File.webpbundle> [-Dedupe=None|Bytes|Pixels] [-Report=<File.csv>] [-Trim [-TrimQuality=95]] [-Verify]"));
+        return 1;
+    }
+    FPaths::NormalizeDirectoryName(SourceDir);
+
+    EWebPBundleDedupe Dedupe = EWebPBundleDedupe::Bytes;
+    FString DedupeName;
+    if (FParse::Value(*Params, TEXT("Dedupe="), DedupeName))
+    {
+        if (DedupeName == TEXT("None")) { Dedupe = EWebPBundleDedupe::None; }
+        else if (DedupeName == TEXT("Pixels")) { Dedupe = EWebPBundleDedupe::Pixels; }
+        else if (DedupeName != TEXT("Bytes"))
+        {
+            UE_LOG(LogWebPBundleCommandlet, Error, TEXT("Unknown -Dedupe=%s (None, Bytes or Pixels)"), *DedupeName);
+            return 1;
+        }
+    }
+
+    TArray<FString> Files;
+    IFileManager::Get().FindFilesRecursive(Files, *SourceDir, TEXT("*.webp"), true, false);
+    Files.Sort();
+
+    const bool bTrim = FParse::Param(*Params, TEXT("Trim"));
+    int32 TrimQuality = 95;
+    FParse::Value(*Params, TEXT("TrimQuality="), TrimQuality);
+
+    FWebPBundleBuilder Builder;
+    Builder.SetDedupe(Dedupe);
+    Builder.SetTrim(bTrim, FMath::Clamp(TrimQuality, 0, 100));
+    int32 Errors = 0;
+    for (const FString& File : Files)
+    {
+        FString RelativeName = File;
+        FPaths::MakePathRelativeTo(RelativeName, *(SourceDir + TEXT("/")));
+
+        FString Error;
+        if (!Builder.AddFile(RelativeName, File, &Error))
+        {
+            UE_LOG(LogWebPBundleCommandlet, Error, TEXT("%s"), *Error);
+            ++Errors;
+        }
+    }
+
+    FString WriteError;
+    if (!Builder.Write(OutputPath, &WriteError))
+    {
+        UE_LOG(LogWebPBundleCommandlet, Error, TEXT("%s"), *WriteError);
+        return 1;
+    }
+    UE_LOG(LogWebPBundleCommandlet, Display, TEXT("Wrote %d images to %s (%d skipped)"), Builder.Num(), *OutputPath, Errors);
+
+    const FWebPBundleBuilder::FDedupeReport Report = Builder.GetDedupeReport();
+    UE_LOG(LogWebPBundleCommandlet, Display, TEXT("Dedupe: %d unique blobs, %d byte-identical and %d pixel-identical duplicates, %.2f of %.2f MB saved (%.1f%%)"),
+        Report.UniqueBlobs, Report.ByteDuplicates, Report.PixelDuplicates, Report.GetBytesSaved() / (1024.0 * 1024.0), Report.SourceBytes / (1024.0 * 1024.0),
+        Report.SourceBytes > 0 ? 100.0 * Report.GetBytesSaved() / Report.SourceBytes : 0.0);
+
+    if (bTrim)
+    {
+        const FWebPBundleBuilder::FTrimReport Trim = Builder.GetTrimReport();
+        UE_LOG(LogWebPBundleCommandlet, Display, TEXT("Trim: %d images trimmed, decoded pixels %.1f -> %.1f MP (%.1f%% fewer)"),
+            Trim.Trimmed, Trim.CanvasPixels / 1.0e6, Trim.StoredPixels / 1.0e6,
+            Trim.CanvasPixels > 0 ? 100.0 * (Trim.CanvasPixels - Trim.StoredPixels) / Trim.CanvasPixels : 0.0);
+    }
+
+    FString ReportPath;
+    if (FParse::Value(*Params, TEXT("Report="), ReportPath))
+    {
+        TArray<FString> Lines;
+        Lines.Add(TEXT("name,canonical,match,bytes_saved"));
+        for (const FWebPBundleBuilder::FDuplicate& Duplicate : Report.Duplicates)
+        {
+            Lines.Add(FString::Printf(TEXT("%s,%s,%s,%lld"), *Duplicate.Name, *Duplicate.CanonicalName,
+                Duplicate.bPixelMatch ? TEXT("pixels") : TEXT("bytes"), Duplicate.SourceBytes));
+        }
+        Lines.Add(FString::Printf(TEXT("TOTAL,,,%lld"), Report.GetBytesSaved()));
+        if (!FFileHelper::SaveStringArrayToFile(Lines, *ReportPath))
+        {
+            UE_LOG(LogWebPBundleCommandlet, Error, TEXT("Failed to write %s"), *ReportPath);
+            return 1;
+        }
+    }
+
+    if (FParse::Param(*Params, TEXT("Verify")))
+    {
+        FWebPBundleReader Reader;
+        if (!Reader.Open(OutputPath))
+        {
+            return 1;
+        }
+        for (const FString& File : Files)
+        {
+            FString RelativeName = File;
+            FPaths::MakePathRelativeTo(RelativeName, *(SourceDir + TEXT("/")));
+            // Pixel dedupe may point an entry at a smaller encoding of the same image, never a larger one; trimming
+            // re-encodes, so only the presence of the entry can be checked
+            const FWebPBundleEntry* Entry = Reader.Find(RelativeName);
+            const int64 FileSize = IFileManager::Get().FileSize(*File);
+            const int64 DataSize = Entry ? Reader.GetData(*Entry).Num() : 0;
+            if (!Entry || (!bTrim && (Dedupe == EWebPBundleDedupe::Pixels ? DataSize > FileSize : DataSize != FileSize)))
+            {
+                UE_LOG(LogWebPBundleCommandlet, Error, TEXT("Verify failed for %s"), *RelativeName);
+                ++Errors;
+            }
+        }
+    }
+
+    return Errors == 0 ? 0 : 1;
+}
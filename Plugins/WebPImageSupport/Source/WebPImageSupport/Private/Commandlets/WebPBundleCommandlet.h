@@ -0,0 +1,28 @@
+// WebPBundleCommandlet.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "WebPBundleCommandlet.generated.h"
+
+/**
+ * Packs a directory of .webp files into a .webpbundle:
+ * UnrealEditor-Cmd VNM -run=WebPBundle -Source=<Dir> -Output=<File.webpbundle> [-Dedupe=None|Bytes|Pixels] [-Report=<File.csv>]
+ *     [-Trim [-TrimQuality=95]] [-Verify]
+ * Entry names are the paths relative to Source, normalized by WebPBundle::NormalizeName.
+ * Duplicates share one blob (byte-identical by default, -Dedupe=Pixels also matches re-encodes); the bytes saved
+ * are logged, and -Report lists every duplicate with the entry it maps to.
+ * -Trim crops sprites to their non-transparent bounds and stores the canvas placement next to the index.
+ */
+UCLASS()
+class UWebPBundleCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UWebPBundleCommandlet();
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+};
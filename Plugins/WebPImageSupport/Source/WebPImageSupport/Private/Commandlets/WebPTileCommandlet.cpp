@@ -0,0 +1,105 @@
+// WebPTileCommandlet.cpp
+#include "WebPTileCommandlet.h"
+#include "WebPTiledImage.h"
+#include "WebPBufferPool.h"
+#include "WebpImageWrapper.h"
+#include "ImageCore.h"
+#include "ImageUtils.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWebPTileCommandlet, Log, All);
+
+UWebPTileCommandlet::UWebPTileCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+static bool LoadSourceImage(const FString& SourcePath, FImage& OutImage)
+{
+    if (FPaths::GetExtension(SourcePath).Equals(TEXT("webp"), ESearchCase::IgnoreCase))
+    {
+        TArray64<uint8> Compressed;
+        FWebpImageWrapper Wrapper;
+        if (!FFileHelper::LoadFileToArray(Compressed, *SourcePath) || !Wrapper.SetCompressed(Compressed.GetData(), Compressed.Num()))
+        {
+            return false;
+        }
+        OutImage.Init((int32)Wrapper.GetWidth(), (int32)Wrapper.GetHeight(), ERawImageFormat::BGRA8, EGammaSpace::sRGB);
+        return Wrapper.DecodeInto(ERGBFormat::BGRA, 8, OutImage.RawData.GetData(), Wrapper.GetWidth() * 4, OutImage.RawData.Num());
+    }
+
+    FImage Loaded;
+    if (!FImageUtils::LoadImage(*SourcePath, Loaded))
+    {
+        return false;
+    }
+    Loaded.ChangeFormat(ERawImageFormat::BGRA8, EGammaSpace::sRGB);
+    OutImage = MoveTemp(Loaded);
+    return true;
+}
+
+int32 UWebPTileCommandlet::Main(const FString& Params)
+{
+    FString SourcePath;
+    FString OutputPath;
+    if (!FParse::Value(*Params, TEXT("Source="), SourcePath) || !FParse::Value(*Params, TEXT("Output="), OutputPath))
+    {
+        UE_LOG(LogWebPTileCommandlet, Error, TEXT("Usage: -run=WebPTile -Source=<Image> -Output=<File.webptiles> [-TileSize=512] [-Quality=90] [-Lossless] [-Verify]"));
+        return 1;
+    }
+
+    int32 TileSize = FWebPTiledImageBuilder::DefaultTileSize;
+    int32 Quality = 90;
+    FParse::Value(*Params, TEXT("TileSize="), TileSize);
+    FParse::Value(*Params, TEXT("Quality="), Quality);
+
+    FWebPEncodeOptions Options;
+    Options.bLossless = FParse::Param(*Params, TEXT("Lossless"));
+
+    FImage Source;
+    if (!LoadSourceImage(SourcePath, Source))
+    {
+        UE_LOG(LogWebPTileCommandlet, Error, TEXT("Failed to load %s"), *SourcePath);
+        return 1;
+    }
+
+    const double StartSeconds = FPlatformTime::Seconds();
+    TArray64<uint8> File;
+    FString Error;
+    if (!FWebPTiledImageBuilder::Encode(Source.RawData.GetData(), Source.SizeX, Source.SizeY, (int64)Source.SizeX * 4, TileSize,
+                                        Options, Quality, File, &Error))
+    {
+        UE_LOG(LogWebPTileCommandlet, Error, TEXT("%s"), *Error);
+        return 1;
+    }
+    if (!FFileHelper::SaveArrayToFile(File, *OutputPath))
+    {
+        UE_LOG(LogWebPTileCommandlet, Error, TEXT("Failed to write %s"), *OutputPath);
+        return 1;
+    }
+
+    FWebPTiledImage Tiled;
+    Tiled.InitializeView(TConstArrayView64<uint8>(File.GetData(), File.Num()));
+    UE_LOG(LogWebPTileCommandlet, Display, TEXT("Wrote %s: %dx%d in %dx%d tiles of %d, %lld bytes (%.2fs)"), *OutputPath,
+        Source.SizeX, Source.SizeY, Tiled.GetNumTilesX(), Tiled.GetNumTilesY(), Tiled.GetTileSize(), File.Num(),
+        FPlatformTime::Seconds() - StartSeconds);
+
+    if (FParse::Param(*Params, TEXT("Verify")))
+    {
+        FWebPTiledImage Reader;
+        TArray64<uint8> Decoded;
+        if (!Reader.LoadFile(OutputPath) || !Reader.DecodeAll(ERGBFormat::BGRA, FWebPDecodeOptions(), Decoded)
+            || Reader.GetWidth() != Source.SizeX || Reader.GetHeight() != Source.SizeY)
+        {
+            UE_LOG(LogWebPTileCommandlet, Error, TEXT("Verify failed for %s"), *OutputPath);
+            return 1;
+        }
+        FWebPBufferPool::Get().Release(Decoded);
+    }
+
+    return 0;
+}
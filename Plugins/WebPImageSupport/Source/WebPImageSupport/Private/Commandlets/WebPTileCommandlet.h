@@ -0,0 +1,24 @@
+// WebPTileCommandlet.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "WebPTileCommandlet.generated.h"
+
+/**
+ * Cuts a large image into a tiled .webptiles file (see FWebPTiledImage):
+ * UnrealEditor-Cmd VNM -run=WebPTile -Source=<Image> -Output=<File.webptiles> [-TileSize=512] [-Quality=90] [-Lossless] [-Verify]
+ * Source may be .webp or anything FImageUtils::LoadImage reads (png, jpg, exr, ...).
+ */
+UCLASS()
+class UWebPTileCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UWebPTileCommandlet();
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+};
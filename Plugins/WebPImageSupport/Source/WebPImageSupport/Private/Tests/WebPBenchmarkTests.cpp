@@ -0,0 +1,43 @@
+// WebPBenchmarkTests.cpp
+// Automation "Perf" wrappers around the registered benchmark suites (Session Frontend > Automation, filter "Perf").
+#include "WebPBenchmark.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FWebPBenchmarkPerfTest, "WebP.Perf.Benchmark",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+void FWebPBenchmarkPerfTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+    for (const FString& SuiteName : FWebPBenchmarkRegistry::Get().GetSuiteNames())
+    {
+        OutBeautifiedNames.Add(SuiteName);
+        OutTestCommands.Add(SuiteName);
+    }
+}
+
+bool FWebPBenchmarkPerfTest::RunTest(const FString& Parameters)
+{
+    FWebPBenchmarkContext Context;
+    Context.bQuick = true;
+    Context.Iterations = 5;
+    Context.WarmupIterations = 1;
+
+    if (!FWebPBenchmarkRegistry::Get().RunSuite(Parameters, Context))
+    {
+        AddError(FString::Printf(TEXT("Benchmark suite '%s' is not registered."), *Parameters));
+        return false;
+    }
+
+    for (const FWebPBenchmarkResult& Result : Context.GetResults())
+    {
+        AddInfo(FString::Printf(TEXT("%s: %.2f MB/s, p50 %.3f ms, p99 %.3f ms"), *Result.Case,
+            Result.GetMegabytesPerSecond(), Result.GetPercentileMs(50.0), Result.GetPercentileMs(99.0)));
+        TestTrue(FString::Printf(TEXT("%s produced samples"), *Result.Case), Result.LatenciesSeconds.Num() > 0);
+    }
+    AddInfo(Context.ToJson());
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,165 @@
+// WebPContainerTests.cpp
+// Bundles and tiled images come off disk: a header that points outside the file, or whose offset + size wraps around,
+// must be rejected on open instead of being read later.
+#include "WebPBundle.h"
+#include "WebPTiledImage.h"
+#include "WebPSyntheticImage.h"
+#include "WebpImageWrapper.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace WebPContainerTests
+{
+    template <typename T>
+    T& At(TArray64<uint8>& Bytes, int64 Offset)
+    {
+        return *reinterpret_cast<T*>(Bytes.GetData() + Offset);
+    }
+
+    typedef TFunction<void(TArray64<uint8>&)> FCorruption;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWebPBundleMalformedTest, "WebP.Containers.Bundle.Malformed",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FWebPBundleMalformedTest::RunTest(const FString& Parameters)
+{
+    using namespace WebPContainerTests;
+
+    // The reader maps files, so every variant goes through disk
+    const FString Filename = FPaths::AutomationTransientDir() / TEXT("WebPContainerTests.webpbundle");
+    TArray64<uint8> Valid;
+    {
+        FWebPBundleBuilder Builder;
+        for (int32 Seed = 0; Seed < 3; ++Seed)
+        {
+            TArray64<uint8> Pixels;
+            FWebPSyntheticImage::Generate(40 + Seed, 24, EWebPSyntheticContent::Photo, Seed, Pixels);
+            TArray64<uint8> Compressed = FWebPSyntheticImage::Encode(Pixels.GetData(), 40 + Seed, 24, 80);
+            if (!TestTrue(TEXT("Builder accepts the entry"), Builder.Add(FString::Printf(TEXT("image_%d"), Seed), MoveTemp(Compressed))))
+            {
+                return false;
+            }
+        }
+        if (!TestTrue(TEXT("Builder writes the bundle"), Builder.Write(Filename)) || !FFileHelper::LoadFileToArray(Valid, *Filename))
+        {
+            return false;
+        }
+    }
+
+    FWebPBundleReader Reader;
+    if (!TestTrue(TEXT("Unmodified bundle opens"), Reader.Open(Filename)))
+    {
+        return false;
+    }
+    Reader.Close();
+
+    const int64 EntriesOffset = (int64)At<FWebPBundleHeader>(Valid, 0).IndexOffset;
+    const int64 FileSize = Valid.Num();
+    const TPair<const TCHAR*, FCorruption> Corruptions[] =
+    {
+        { TEXT("truncated header"), [](TArray64<uint8>& B) { B.SetNum(sizeof(FWebPBundleHeader) - 1); } },
+        { TEXT("bad magic"), [](TArray64<uint8>& B) { At<FWebPBundleHeader>(B, 0).Magic ^= 1; } },
+        { TEXT("version 0"), [](TArray64<uint8>& B) { At<FWebPBundleHeader>(B, 0).Version = 0; } },
+        { TEXT("future version"), [](TArray64<uint8>& B) { At<FWebPBundleHeader>(B, 0).Version = WebPBundle::Version + 1; } },
+        { TEXT("flags in a version 1 bundle"), [](TArray64<uint8>& B) { At<FWebPBundleHeader>(B, 0).Flags = 1; } },
+        { TEXT("index past the end"), [FileSize](TArray64<uint8>& B) { At<FWebPBundleHeader>(B, 0).IndexOffset = Align(FileSize, 8); } },
+        { TEXT("index offset wraps"), [](TArray64<uint8>& B) { At<FWebPBundleHeader>(B, 0).IndexOffset = ~7ull; } },
+        { TEXT("entry count too large"), [](TArray64<uint8>& B) { At<FWebPBundleHeader>(B, 0).EntryCount = MAX_uint32; } },
+        { TEXT("misaligned index"), [](TArray64<uint8>& B) { At<FWebPBundleHeader>(B, 0).IndexOffset += 1; } },
+        { TEXT("names past the end"), [](TArray64<uint8>& B) { At<FWebPBundleHeader>(B, 0).NamesSize = B.Num(); } },
+        { TEXT("names offset wraps"), [](TArray64<uint8>& B) { At<FWebPBundleHeader>(B, 0).NamesOffset = MAX_uint64 - 1; } },
+        { TEXT("blob past the end"), [EntriesOffset](TArray64<uint8>& B) { At<FWebPBundleEntry>(B, EntriesOffset).DataSize = (uint32)B.Num(); } },
+        { TEXT("blob offset wraps"), [EntriesOffset](TArray64<uint8>& B) { At<FWebPBundleEntry>(B, EntriesOffset).DataOffset = MAX_uint64 - 3; } },
+        { TEXT("index not sorted"), [EntriesOffset](TArray64<uint8>& B) { Swap(At<FWebPBundleEntry>(B, EntriesOffset), At<FWebPBundleEntry>(B, EntriesOffset + sizeof(FWebPBundleEntry))); } },
+    };
+    for (const TPair<const TCHAR*, FCorruption>& Corruption : Corruptions)
+    {
+        TArray64<uint8> Bytes = Valid;
+        Corruption.Value(Bytes);
+        FFileHelper::SaveArrayToFile(Bytes, *Filename);
+        TestFalse(FString::Printf(TEXT("Bundle with %s is rejected"), Corruption.Key), Reader.Open(Filename));
+        Reader.Close();
+    }
+
+    // Names aren't read on open; a wrapping name range must still come back empty instead of reading out of bounds
+    {
+        TArray64<uint8> Bytes = Valid;
+        FWebPBundleEntry& Entry = At<FWebPBundleEntry>(Bytes, EntriesOffset);
+        Entry.NameOffset = MAX_uint32 - 7;
+        Entry.NameLength = 16;
+        FFileHelper::SaveArrayToFile(Bytes, *Filename);
+        if (TestTrue(TEXT("Bundle with a bad name range opens"), Reader.Open(Filename)))
+        {
+            TestTrue(TEXT("Wrapping name range reads as empty"), Reader.GetName(Reader.GetEntries()[0]).IsEmpty());
+        }
+        Reader.Close();
+    }
+
+    IFileManager::Get().Delete(*Filename);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWebPTiledMalformedTest, "WebP.Containers.Tiled.Malformed",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FWebPTiledMalformedTest::RunTest(const FString& Parameters)
+{
+    using namespace WebPContainerTests;
+
+    // 3x2 tiles of 32, the right and bottom ones clipped
+    const int32 Width = 80;
+    const int32 Height = 40;
+    TArray64<uint8> Pixels;
+    FWebPSyntheticImage::Generate(Width, Height, EWebPSyntheticContent::Photo, 3, Pixels);
+    TArray64<uint8> Valid;
+    if (!TestTrue(TEXT("Tiled encode"), FWebPTiledImageBuilder::Encode(Pixels.GetData(), Width, Height, (int64)Width * 4, 32,
+        FWebPEncodeOptions(), 80, Valid)))
+    {
+        return false;
+    }
+
+    {
+        FWebPTiledImage Image;
+        if (!TestTrue(TEXT("Unmodified tiled image opens"), Image.InitializeView(Valid)))
+        {
+            return false;
+        }
+    }
+
+    const int64 TilesOffset = sizeof(FWebPTiledHeader);
+    const TPair<const TCHAR*, FCorruption> Corruptions[] =
+    {
+        { TEXT("truncated header"), [](TArray64<uint8>& B) { B.SetNum(sizeof(FWebPTiledHeader) - 1); } },
+        { TEXT("truncated tile table"), [](TArray64<uint8>& B) { B.SetNum(sizeof(FWebPTiledHeader) + sizeof(FWebPTileEntry)); } },
+        { TEXT("bad magic"), [](TArray64<uint8>& B) { At<FWebPTiledHeader>(B, 0).Magic ^= 1; } },
+        { TEXT("wrong version"), [](TArray64<uint8>& B) { At<FWebPTiledHeader>(B, 0).Version = WebPTiled::Version + 1; } },
+        { TEXT("zero width"), [](TArray64<uint8>& B) { At<FWebPTiledHeader>(B, 0).Width = 0; } },
+        { TEXT("zero tile size"), [](TArray64<uint8>& B) { At<FWebPTiledHeader>(B, 0).TileSize = 0; } },
+        { TEXT("tile count not matching the size"), [](TArray64<uint8>& B) { At<FWebPTiledHeader>(B, 0).TilesX += 1; } },
+        { TEXT("huge grid"), [](TArray64<uint8>& B)
+            {
+                FWebPTiledHeader& Header = At<FWebPTiledHeader>(B, 0);
+                Header.Width = Header.Height = MAX_uint32;
+                Header.TileSize = 1;
+                Header.TilesX = Header.TilesY = MAX_uint32;
+            } },
+        { TEXT("empty tile"), [TilesOffset](TArray64<uint8>& B) { At<FWebPTileEntry>(B, TilesOffset).DataSize = 0; } },
+        { TEXT("tile past the end"), [TilesOffset](TArray64<uint8>& B) { At<FWebPTileEntry>(B, TilesOffset).DataSize = (uint32)B.Num() + 1; } },
+        { TEXT("tile offset wraps"), [TilesOffset](TArray64<uint8>& B) { At<FWebPTileEntry>(B, TilesOffset).DataOffset = MAX_uint64 - 3; } },
+    };
+    for (const TPair<const TCHAR*, FCorruption>& Corruption : Corruptions)
+    {
+        TArray64<uint8> Bytes = Valid;
+        Corruption.Value(Bytes);
+        FWebPTiledImage Image;
+        TestFalse(FString::Printf(TEXT("Tiled image with %s is rejected"), Corruption.Key), Image.InitializeView(Bytes));
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,180 @@
+// WebPKernelTests.cpp
+// Every SIMD backend this machine can run must match the scalar kernels byte for byte. Widths straddle the vector
+// widths (8 / 16 / 32 / 64 pixels) so the vector loops and their scalar tails both run, on unaligned rows.
+#include "WebPSimd.h"
+#include "WebPGray.h"
+#include "WebPPacked.h"
+#include "WebPTrim.h"
+#include "WebPAlphaMask.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace WebPKernelTests
+{
+    static const int32 Widths[] = { 1, 2, 3, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 129, 1021 };
+
+    // The scalar reference is always first in GetAvailableBackends
+    static TArray<EWebPSimdBackend> GetSimdBackends()
+    {
+        TArray<EWebPSimdBackend> Backends = WebPSimd::GetAvailableBackends();
+        Backends.RemoveAt(0);
+        return Backends;
+    }
+
+    static void FillRandom(TArray64<uint8>& Bytes, int64 Num, int32 Seed)
+    {
+        FRandomStream Random(Seed);
+        Bytes.SetNumUninitialized(Num);
+        for (uint8& Byte : Bytes)
+        {
+            Byte = (uint8)Random.RandHelper(256);
+        }
+    }
+
+    // First index where A and B differ, INDEX_NONE if they match
+    static int64 FindMismatch(const uint8* A, const uint8* B, int64 Num)
+    {
+        for (int64 Index = 0; Index < Num; ++Index)
+        {
+            if (A[Index] != B[Index])
+            {
+                return Index;
+            }
+        }
+        return INDEX_NONE;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWebPGrayKernelTest, "WebP.Kernels.Gray",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FWebPGrayKernelTest::RunTest(const FString& Parameters)
+{
+    using namespace WebPKernelTests;
+    for (EWebPSimdBackend Backend : GetSimdBackends())
+    {
+        for (int32 Width : Widths)
+        {
+            // One byte in, so no row starts on a vector boundary
+            TArray64<uint8> Source;
+            FillRandom(Source, Width + 1, Width);
+            TArray64<uint8> Expected = Source;
+            TArray64<uint8> Actual = Source;
+            WebPGray::ExpandLumaRow(EWebPSimdBackend::Scalar, Expected.GetData() + 1, Width);
+            WebPGray::ExpandLumaRow(Backend, Actual.GetData() + 1, Width);
+
+            const int64 Mismatch = FindMismatch(Expected.GetData(), Actual.GetData(), Actual.Num());
+            TestEqual(FString::Printf(TEXT("%s width %d: first mismatch"), WebPSimd::ToString(Backend), Width), Mismatch, (int64)INDEX_NONE);
+        }
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWebPPackedKernelTest, "WebP.Kernels.Packed",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FWebPPackedKernelTest::RunTest(const FString& Parameters)
+{
+    using namespace WebPKernelTests;
+    for (EWebPSimdBackend Backend : GetSimdBackends())
+    {
+        for (const EWebPPackedFormat Format : { EWebPPackedFormat::RGB565, EWebPPackedFormat::RGBA4444 })
+        {
+            for (int32 Width : Widths)
+            {
+                // Two bytes in: pixels stay 16-bit aligned, rows don't start on a vector boundary
+                TArray64<uint8> Source;
+                FillRandom(Source, (int64)Width * 2 + 2, Width);
+                TArray64<uint8> Expected = Source;
+                TArray64<uint8> Actual = Source;
+                WebPPacked::ToNativeRow(EWebPSimdBackend::Scalar, Format, Expected.GetData() + 2, Width);
+                WebPPacked::ToNativeRow(Backend, Format, Actual.GetData() + 2, Width);
+
+                const int64 Mismatch = FindMismatch(Expected.GetData(), Actual.GetData(), Actual.Num());
+                TestEqual(FString::Printf(TEXT("%s %s width %d: first mismatch"), WebPSimd::ToString(Backend),
+                    Format == EWebPPackedFormat::RGB565 ? TEXT("RGB565") : TEXT("RGBA4444"), Width), Mismatch, (int64)INDEX_NONE);
+            }
+        }
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWebPTrimKernelTest, "WebP.Kernels.Trim",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FWebPTrimKernelTest::RunTest(const FString& Parameters)
+{
+    using namespace WebPKernelTests;
+    const TArray<EWebPSimdBackend> Backends = WebPSimd::GetAvailableBackends();
+    FRandomStream Random(44);
+    for (int32 Width : Widths)
+    {
+        const int32 Height = 1 + Width % 13;
+        const int64 Stride = (int64)Width * 4 + 4; // Padded rows: the padding is opaque and must be ignored
+
+        TArray64<uint8> Pixels;
+        Pixels.SetNumZeroed(Stride * Height);
+        for (int32 Y = 0; Y < Height; ++Y)
+        {
+            Pixels[Y * Stride + (int64)Width * 4 + 3] = 255;
+        }
+
+        // Empty, one pixel in each corner, then a random opaque block
+        TArray<FIntRect> Contents = { FIntRect() };
+        Contents.Add(FIntRect(0, 0, 1, 1));
+        Contents.Add(FIntRect(Width - 1, Height - 1, Width, Height));
+        const FIntPoint Min(Random.RandHelper(Width), Random.RandHelper(Height));
+        Contents.Add(FIntRect(Min, FIntPoint(Min.X + 1 + Random.RandHelper(Width - Min.X), Min.Y + 1 + Random.RandHelper(Height - Min.Y))));
+
+        for (const FIntRect& Content : Contents)
+        {
+            TArray64<uint8> Image = Pixels;
+            for (int32 Y = Content.Min.Y; Y < Content.Max.Y; ++Y)
+            {
+                for (int32 X = Content.Min.X; X < Content.Max.X; ++X)
+                {
+                    Image[Y * Stride + (int64)X * 4 + 3] = 1;
+                }
+            }
+            for (EWebPSimdBackend Backend : Backends)
+            {
+                const FIntRect Bounds = WebPTrim::FindContentBounds(Backend, Image.GetData(), Width, Height, Stride);
+                TestTrue(FString::Printf(TEXT("%s %dx%d content %s: got %s"), WebPSimd::ToString(Backend), Width, Height,
+                    *Content.ToString(), *Bounds.ToString()), Bounds == Content);
+            }
+        }
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWebPAlphaMaskKernelTest, "WebP.Kernels.AlphaMask",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FWebPAlphaMaskKernelTest::RunTest(const FString& Parameters)
+{
+    using namespace WebPKernelTests;
+    for (EWebPSimdBackend Backend : GetSimdBackends())
+    {
+        for (int32 Width : Widths)
+        {
+            TArray64<uint8> Pixels;
+            FillRandom(Pixels, (int64)Width * 4 + 1, Width);
+            for (const uint8 Threshold : { (uint8)0, (uint8)1, (uint8)128, (uint8)255 })
+            {
+                const int32 NumWords = (Width + 63) / 64;
+                TArray<uint64> Expected;
+                TArray<uint64> Actual;
+                Expected.SetNumZeroed(NumWords);
+                Actual.SetNumZeroed(NumWords);
+                WebPAlphaMask::ThresholdRow(EWebPSimdBackend::Scalar, Pixels.GetData() + 1, Width, Threshold, Expected.GetData());
+                WebPAlphaMask::ThresholdRow(Backend, Pixels.GetData() + 1, Width, Threshold, Actual.GetData());
+                TestTrue(FString::Printf(TEXT("%s width %d threshold %d matches scalar"), WebPSimd::ToString(Backend), Width, Threshold),
+                    Expected == Actual);
+            }
+        }
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,182 @@
+// WebPAlphaMask.cpp
+#include "WebPAlphaMask.h"
+#include "WebPStats.h"
+#include "WebPMemory.h"
+
+namespace WebPAlphaMask
+{
+    static void ThresholdRowScalar(const uint8* Pixels, int32 NumPixels, uint8 Threshold, uint64* OutBits)
+    {
+        for (int32 First = 0; First < NumPixels; First += 64)
+        {
+            const int32 Count = FMath::Min(64, NumPixels - First);
+            uint64 Word = 0;
+            for (int32 Bit = 0; Bit < Count; ++Bit)
+            {
+                Word |= (uint64)(Pixels[(First + Bit) * 4 + 3] >= Threshold) << Bit;
+            }
+            OutBits[First / 64] = Word;
+        }
+    }
+
+#if WEBP_SIMD_AVX2
+    WEBP_TARGET_AVX2 static void ThresholdRowAVX2(const uint8* Pixels, int32 NumPixels, uint8 Threshold, uint64* OutBits)
+    {
+        // Alpha shifted down to the low byte of each 32-bit lane; a signed compare is fine for 0..255
+        const __m256i Limit = _mm256_set1_epi32((int32)Threshold - 1);
+
+        int32 Index = 0;
+        for (; Index + 64 <= NumPixels; Index += 64)
+        {
+            uint64 Word = 0;
+            for (int32 Group = 0; Group < 8; ++Group)
+            {
+                const __m256i P = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Pixels + (Index + Group * 8) * 4));
+                const __m256i Hit = _mm256_cmpgt_epi32(_mm256_srli_epi32(P, 24), Limit);
+                Word |= (uint64)(uint32)_mm256_movemask_ps(_mm256_castsi256_ps(Hit)) << (Group * 8);
+            }
+            OutBits[Index / 64] = Word;
+        }
+
+        ThresholdRowScalar(Pixels + Index * 4, NumPixels - Index, Threshold, OutBits + Index / 64);
+    }
+#endif
+
+#if WEBP_SIMD_NEON
+    static void ThresholdRowNEON(const uint8* Pixels, int32 NumPixels, uint8 Threshold, uint64* OutBits)
+    {
+        static const uint8 BitWeights[8] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+        const uint8x8_t Weights = vld1_u8(BitWeights);
+        const uint8x8_t Limit = vdup_n_u8(Threshold);
+
+        int32 Index = 0;
+        for (; Index + 64 <= NumPixels; Index += 64)
+        {
+            uint64 Word = 0;
+            for (int32 Group = 0; Group < 8; ++Group)
+            {
+                // De-interleaved: val[3] = alpha of 8 pixels
+                const uint8x8x4_t P = vld4_u8(Pixels + (Index + Group * 8) * 4);
+                const uint8x8_t Hit = vcge_u8(P.val[3], Limit);
+                Word |= (uint64)vaddv_u8(vand_u8(Hit, Weights)) << (Group * 8);
+            }
+            OutBits[Index / 64] = Word;
+        }
+
+        ThresholdRowScalar(Pixels + Index * 4, NumPixels - Index, Threshold, OutBits + Index / 64);
+    }
+#endif
+
+    void ThresholdRow(EWebPSimdBackend Backend, const uint8* Pixels, int32 NumPixels, uint8 Threshold, uint64* OutBits)
+    {
+        if (NumPixels <= 0)
+        {
+            return;
+        }
+
+        switch (Backend)
+        {
+#if WEBP_SIMD_AVX2
+        case EWebPSimdBackend::AVX2:
+            ThresholdRowAVX2(Pixels, NumPixels, Threshold, OutBits);
+            return;
+#endif
+#if WEBP_SIMD_NEON
+        case EWebPSimdBackend::NEON:
+            ThresholdRowNEON(Pixels, NumPixels, Threshold, OutBits);
+            return;
+#endif
+        default:
+            ThresholdRowScalar(Pixels, NumPixels, Threshold, OutBits);
+            return;
+        }
+    }
+
+    // Any of Count bits starting at bit First
+    static bool AnyBitInRange(const uint64* Words, int32 First, int32 Count)
+    {
+        while (Count > 0)
+        {
+            const int32 Shift = First & 63;
+            const int32 Take = FMath::Min(Count, 64 - Shift);
+            const uint64 Mask = (Take == 64 ? ~0ull : ((1ull << Take) - 1)) << Shift;
+            if ((Words[First >> 6] & Mask) != 0)
+            {
+                return true;
+            }
+            First += Take;
+            Count -= Take;
+        }
+        return false;
+    }
+}
+
+bool FWebPAlphaMask::Build(const uint8* Pixels, int32 InWidth, int32 InHeight, int64 Stride, uint8 Threshold, int32 InCellSize)
+{
+    WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_AlphaMask);
+    Reset();
+    if (!Pixels || InWidth <= 0 || InHeight <= 0 || Stride < (int64)InWidth * 4 || InCellSize < 1)
+    {
+        return false;
+    }
+
+    Width = InWidth;
+    Height = InHeight;
+    CellSize = InCellSize;
+    MaskWidth = FMath::DivideAndRoundUp(Width, CellSize);
+    MaskHeight = FMath::DivideAndRoundUp(Height, CellSize);
+    WordsPerRow = FMath::DivideAndRoundUp(MaskWidth, 64);
+    {
+        LLM_SCOPE_BYTAG(WebP_Decoded);
+        Bits.SetNumZeroed(WordsPerRow * MaskHeight);
+    }
+
+    const EWebPSimdBackend Backend = WebPSimd::GetBackend();
+    if (CellSize == 1)
+    {
+        for (int32 Row = 0; Row < Height; ++Row)
+        {
+            WebPAlphaMask::ThresholdRow(Backend, Pixels + Row * Stride, Width, Threshold, &Bits[Row * WordsPerRow]);
+        }
+        return true;
+    }
+
+    // Downsampled: OR the full-resolution bits of a cell row's pixel rows, then collapse each CellSize run to one bit
+    const int32 FullWords = FMath::DivideAndRoundUp(Width, 64);
+    TArray<uint64, TInlineAllocator<64>> RowBits;
+    TArray<uint64, TInlineAllocator<64>> CellRowBits;
+    RowBits.SetNumUninitialized(FullWords);
+    CellRowBits.SetNumUninitialized(FullWords);
+
+    for (int32 CellY = 0; CellY < MaskHeight; ++CellY)
+    {
+        FMemory::Memzero(CellRowBits.GetData(), FullWords * sizeof(uint64));
+        const int32 LastRow = FMath::Min((CellY + 1) * CellSize, Height);
+        for (int32 Row = CellY * CellSize; Row < LastRow; ++Row)
+        {
+            WebPAlphaMask::ThresholdRow(Backend, Pixels + Row * Stride, Width, Threshold, RowBits.GetData());
+            for (int32 Word = 0; Word < FullWords; ++Word)
+            {
+                CellRowBits[Word] |= RowBits[Word];
+            }
+        }
+
+        uint64* Out = &Bits[CellY * WordsPerRow];
+        for (int32 CellX = 0; CellX < MaskWidth; ++CellX)
+        {
+            const int32 First = CellX * CellSize;
+            if (WebPAlphaMask::AnyBitInRange(CellRowBits.GetData(), First, FMath::Min(CellSize, Width - First)))
+            {
+                Out[CellX >> 6] |= 1ull << (CellX & 63);
+            }
+        }
+    }
+    return true;
+}
+
+void FWebPAlphaMask::Reset()
+{
+    Width = Height = MaskWidth = MaskHeight = WordsPerRow = 0;
+    CellSize = 1;
+    Bits.Empty();
+}
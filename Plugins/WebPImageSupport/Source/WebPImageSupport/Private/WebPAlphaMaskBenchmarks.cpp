@@ -0,0 +1,72 @@
+// WebPAlphaMaskBenchmarks.cpp
+// Building alpha hit-test masks from decoded sprites: scalar against the vector backend, at full resolution and with
+// 4x4 cells, plus the memory kept per image against holding on to the BGRA pixels.
+#include "WebPBenchmark.h"
+#include "WebPAlphaMask.h"
+#include "WebPSimd.h"
+#include "WebPSyntheticImage.h"
+
+#if WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
+
+namespace WebPAlphaMaskBenchmarks
+{
+    static void Run(FWebPBenchmarkContext& Context)
+    {
+        const FIntPoint Size = Context.bQuick ? FIntPoint(512, 1024) : FIntPoint(1024, 2048); // Standing character sprite
+        TArray64<uint8> Pixels;
+        FWebPSyntheticImage::Generate(Size.X, Size.Y, EWebPSyntheticContent::Sprite, 77, Pixels);
+
+        const TArray<EWebPSimdBackend> Backends = WebPSimd::GetAvailableBackends();
+
+        const int32 CellSizes[] = { 1, 4 };
+        for (int32 CellSize : CellSizes)
+        {
+            FWebPAlphaMask Reference;
+            WebPSimd::SetBackendOverride(EWebPSimdBackend::Scalar);
+            Reference.Build(Pixels.GetData(), Size.X, Size.Y, (int64)Size.X * 4, 128, CellSize);
+
+            for (EWebPSimdBackend Backend : Backends)
+            {
+                WebPSimd::SetBackendOverride(Backend);
+
+                FWebPBenchmarkResult& Result = Context.AddResult(TEXT("AlphaMask"),
+                    FString::Printf(TEXT("build %dx%d cell %d %s"), Size.X, Size.Y, CellSize, WebPSimd::ToString(Backend)));
+                Result.AddSizeParams(Size.X, Size.Y);
+                Result.Params.Add(TEXT("cell"), LexToString(CellSize));
+                Result.AddBackendParam(Backend);
+                Result.BytesPerIteration = Pixels.Num();
+
+                FWebPAlphaMask Mask;
+                Context.Measure(Result, [&]()
+                {
+                    Mask.Build(Pixels.GetData(), Size.X, Size.Y, (int64)Size.X * 4, 128, CellSize);
+                });
+
+                // Backends must agree bit for bit; sampled on a grid rather than walking every pixel
+                bool bMatchesScalar = true;
+                for (int32 Y = 0; Y < Size.Y && bMatchesScalar; Y += 3)
+                {
+                    for (int32 X = 0; X < Size.X; X += 3)
+                    {
+                        if (Mask.HitTest(X, Y) != Reference.HitTest(X, Y))
+                        {
+                            bMatchesScalar = false;
+                            break;
+                        }
+                    }
+                }
+
+                Result.Metrics.Add(TEXT("mask_bytes"), (double)Mask.GetAllocatedSize());
+                Result.Metrics.Add(TEXT("pixel_bytes"), (double)Pixels.Num());
+                Result.Metrics.Add(TEXT("mask_to_pixels_ratio"), (double)Mask.GetAllocatedSize() / Pixels.Num());
+                Result.Metrics.Add(TEXT("matches_scalar"), bMatchesScalar ? 1.0 : 0.0);
+            }
+        }
+
+        WebPSimd::SetBackendOverride(TOptional<EWebPSimdBackend>());
+    }
+
+    static FWebPBenchmarkSuiteRegistrar AlphaMaskSuite(TEXT("AlphaMask"), &Run);
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
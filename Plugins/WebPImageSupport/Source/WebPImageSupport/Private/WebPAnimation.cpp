@@ -0,0 +1,281 @@
+// WebPAnimation.cpp
+#include "WebPAnimation.h"
+#include "WebPBufferPool.h"
+#include "WebPStats.h"
+#include "WebPMemory.h"
+#include "WebpImageWrapper.h"
+#include "webp/decode.h"
+#include "webp/demux.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWebPAnimation, Log, All);
+
+bool FWebPAnimation::InitializeView(TConstArrayView64<uint8> Data)
+{
+    Frames.Reset();
+    CanvasSize = FIntPoint::ZeroValue;
+    LoopCount = 0;
+    TotalDurationMs = 0;
+
+    WebPData WebP;
+    WebP.bytes = Data.GetData();
+    WebP.size = (size_t)Data.Num();
+    WebPDemuxer* Demux = WebPDemux(&WebP);
+    if (!Demux)
+    {
+        return false;
+    }
+
+    CanvasSize = FIntPoint((int32)WebPDemuxGetI(Demux, WEBP_FF_CANVAS_WIDTH), (int32)WebPDemuxGetI(Demux, WEBP_FF_CANVAS_HEIGHT));
+    LoopCount = (int32)WebPDemuxGetI(Demux, WEBP_FF_LOOP_COUNT);
+
+    // Fragments point into Data (the demuxer does not copy), so they stay valid after the demuxer is gone
+    WebPIterator Iter;
+    if (WebPDemuxGetFrame(Demux, 1, &Iter))
+    {
+        do
+        {
+            FWebPAnimationFrame& Frame = Frames.AddDefaulted_GetRef();
+            Frame.Rect = FIntRect(Iter.x_offset, Iter.y_offset, Iter.x_offset + Iter.width, Iter.y_offset + Iter.height);
+            Frame.DurationMs = Iter.duration;
+            Frame.Dispose = Iter.dispose_method == WEBP_MUX_DISPOSE_BACKGROUND ? EWebPFrameDispose::Background : EWebPFrameDispose::None;
+            Frame.Blend = Iter.blend_method == WEBP_MUX_NO_BLEND ? EWebPFrameBlend::NoBlend : EWebPFrameBlend::AlphaBlend;
+            Frame.bHasAlpha = Iter.has_alpha != 0;
+            Frame.Bitstream = TConstArrayView64<uint8>(Iter.fragment.bytes, (int64)Iter.fragment.size);
+            TotalDurationMs += Frame.DurationMs;
+        }
+        while (WebPDemuxNextFrame(&Iter));
+        WebPDemuxReleaseIterator(&Iter);
+    }
+    WebPDemuxDelete(Demux);
+
+    const FIntRect CanvasRect(FIntPoint::ZeroValue, CanvasSize);
+    for (const FWebPAnimationFrame& Frame : Frames)
+    {
+        if (!CanvasRect.Contains(Frame.Rect.Min) || Frame.Rect.Max.X > CanvasSize.X || Frame.Rect.Max.Y > CanvasSize.Y)
+        {
+            UE_LOG(LogWebPAnimation, Warning, TEXT("Animation frame outside its %dx%d canvas"), CanvasSize.X, CanvasSize.Y);
+            Frames.Reset();
+            return false;
+        }
+    }
+    return Frames.Num() > 0;
+}
+
+FWebPAnimationCanvas::FWebPAnimationCanvas(const FWebPAnimation& InAnimation)
+    : Animation(InAnimation)
+{
+    LLM_SCOPE_BYTAG(WebP_Decoded);
+    const FIntPoint Size = Animation.GetCanvasSize();
+    Pixels = FWebPBufferPool::Get().Acquire((int64)Size.X * Size.Y * 4);
+}
+
+FWebPAnimationCanvas::~FWebPAnimationCanvas()
+{
+    FWebPBufferPool::Get().Release(Pixels);
+    FWebPBufferPool::Get().Release(Scratch);
+}
+
+void FWebPAnimationCanvas::Clear(const FIntRect& Rect)
+{
+    const int64 Stride = GetStride();
+    for (int32 Y = Rect.Min.Y; Y < Rect.Max.Y; ++Y)
+    {
+        FMemory::Memzero(Pixels.GetData() + Y * Stride + (int64)Rect.Min.X * 4, (int64)Rect.Width() * 4);
+    }
+}
+
+// libwebp's non-premultiplied "over" (anim_decode.c), so results match WebPAnimDecoder
+static void BlendRowNonPremultiplied(uint8* Dst, const uint8* Src, int32 NumPixels)
+{
+    for (int32 Pixel = 0; Pixel < NumPixels; ++Pixel, Dst += 4, Src += 4)
+    {
+        const uint32 SrcA = Src[3];
+        if (SrcA == 255)
+        {
+            FMemory::Memcpy(Dst, Src, 4);
+            continue;
+        }
+        if (SrcA == 0)
+        {
+            continue;
+        }
+        const uint32 DstFactorA = (Dst[3] * (256 - SrcA)) >> 8;
+        const uint32 BlendA = SrcA + DstFactorA;
+        const uint32 Scale = (1u << 24) / BlendA;
+        for (int32 Channel = 0; Channel < 3; ++Channel)
+        {
+            Dst[Channel] = (uint8)(((Src[Channel] * SrcA + Dst[Channel] * DstFactorA) * Scale) >> 24);
+        }
+        Dst[3] = (uint8)BlendA;
+    }
+}
+
+FIntRect FWebPAnimationCanvas::GetDirtyRect(const FWebPAnimation& Animation, int32 FrameIndex)
+{
+    if (FrameIndex == 0)
+    {
+        return FIntRect(FIntPoint::ZeroValue, Animation.GetCanvasSize());
+    }
+    FIntRect Dirty = Animation.GetFrame(FrameIndex).Rect;
+    const FWebPAnimationFrame& Previous = Animation.GetFrame(FrameIndex - 1);
+    if (Previous.Dispose == EWebPFrameDispose::Background)
+    {
+        Dirty.Union(Previous.Rect);
+    }
+    return Dirty;
+}
+
+void FWebPAnimationCanvas::Restore(int32 InFrameIndex, const uint8* InPixels)
+{
+    check(InFrameIndex >= 0 && InFrameIndex < Animation.GetNumFrames());
+    FMemory::Memcpy(Pixels.GetData(), InPixels, Pixels.Num());
+    FrameIndex = InFrameIndex;
+}
+
+bool FWebPAnimationCanvas::DecodeNextFrame(FIntRect& OutDirtyRect)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FWebPAnimationCanvas_DecodeNextFrame, WebPChannel);
+    if (!Animation.IsValid())
+    {
+        return false;
+    }
+
+    const int32 Previous = FrameIndex;
+    FrameIndex = (FrameIndex + 1) % Animation.GetNumFrames();
+    const FWebPAnimationFrame& Frame = Animation.GetFrame(FrameIndex);
+
+    OutDirtyRect = GetDirtyRect(Animation, FrameIndex);
+    if (FrameIndex == 0)
+    {
+        FMemory::Memzero(Pixels.GetData(), Pixels.Num());
+    }
+    else if (Animation.GetFrame(Previous).Dispose == EWebPFrameDispose::Background)
+    {
+        Clear(Animation.GetFrame(Previous).Rect);
+    }
+
+    WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_Decode);
+    const int64 Stride = GetStride();
+    const int64 Offset = Frame.Rect.Min.Y * Stride + (int64)Frame.Rect.Min.X * 4;
+    const int32 Width = Frame.Rect.Width();
+    const int32 Height = Frame.Rect.Height();
+
+    // Opaque or overwriting frames go straight into the canvas at its stride
+    if (Frame.Blend == EWebPFrameBlend::NoBlend || !Frame.bHasAlpha)
+    {
+        return WebPDecodeBGRAInto(Frame.Bitstream.GetData(), Frame.Bitstream.Num(), Pixels.GetData() + Offset,
+                                  Pixels.Num() - Offset, (int)Stride) != nullptr;
+    }
+
+    const int64 ScratchStride = (int64)Width * 4;
+    if (Scratch.Num() < ScratchStride * Height)
+    {
+        LLM_SCOPE_BYTAG(WebP_Scratch);
+        FWebPBufferPool::Get().Release(Scratch);
+        Scratch = FWebPBufferPool::Get().Acquire(ScratchStride * Height);
+    }
+    if (!WebPDecodeBGRAInto(Frame.Bitstream.GetData(), Frame.Bitstream.Num(), Scratch.GetData(), Scratch.Num(), (int)ScratchStride))
+    {
+        return false;
+    }
+    for (int32 Row = 0; Row < Height; ++Row)
+    {
+        BlendRowNonPremultiplied(Pixels.GetData() + Offset + Row * Stride, Scratch.GetData() + Row * ScratchStride, Width);
+    }
+    return true;
+}
+
+static void AppendLE(TArray64<uint8>& Out, uint32 Value, int32 NumBytes)
+{
+    for (int32 Byte = 0; Byte < NumBytes; ++Byte)
+    {
+        Out.Add((uint8)(Value >> (Byte * 8)));
+    }
+}
+
+static void AppendFourCC(TArray64<uint8>& Out, const char* FourCC)
+{
+    Out.Append(reinterpret_cast<const uint8*>(FourCC), 4);
+}
+
+FWebPAnimationBuilder::FWebPAnimationBuilder(FIntPoint InCanvasSize, int32 InLoopCount)
+    : CanvasSize(InCanvasSize)
+    , LoopCount(InLoopCount)
+{
+}
+
+bool FWebPAnimationBuilder::AddFrame(const uint8* BGRA, const FIntRect& Rect, int32 DurationMs, EWebPFrameDispose Dispose,
+                                     EWebPFrameBlend Blend, const FWebPEncodeOptions& Options, int32 Quality, FString* OutError)
+{
+    if (!BGRA || Rect.Width() <= 0 || Rect.Height() <= 0 || (Rect.Min.X & 1) || (Rect.Min.Y & 1)
+        || Rect.Min.X < 0 || Rect.Min.Y < 0 || Rect.Max.X > CanvasSize.X || Rect.Max.Y > CanvasSize.Y)
+    {
+        if (OutError) { *OutError = TEXT("Frame rectangle must lie inside the canvas and start on even coordinates"); }
+        return false;
+    }
+
+    FWebpImageWrapper Encoder;
+    Encoder.SetEncodeOptions(Options);
+    TArray64<uint8> Encoded;
+    if (Encoder.SetRawView(BGRA, (int64)Rect.Width() * Rect.Height() * 4, Rect.Width(), Rect.Height(), ERGBFormat::BGRA, 8))
+    {
+        Encoded = Encoder.GetCompressed(Quality);
+    }
+    if (Encoded.Num() < 12)
+    {
+        if (OutError) { *OutError = FString::Printf(TEXT("Failed to encode frame %d"), NumAddedFrames); }
+        return false;
+    }
+
+    // Frame data is the still image's chunks minus the RIFF header and VP8X (ALPH + VP8, or VP8L)
+    TArray64<uint8> FrameData;
+    for (int64 Pos = 12; Pos + 8 <= Encoded.Num();)
+    {
+        const uint32 ChunkSize = Encoded[Pos + 4] | (Encoded[Pos + 5] << 8) | (Encoded[Pos + 6] << 16) | ((uint32)Encoded[Pos + 7] << 24);
+        const int64 PaddedSize = 8 + ChunkSize + (ChunkSize & 1);
+        if (FMemory::Memcmp(&Encoded[Pos], "VP8X", 4) != 0)
+        {
+            bHasAlpha |= FMemory::Memcmp(&Encoded[Pos], "ALPH", 4) == 0 || FMemory::Memcmp(&Encoded[Pos], "VP8L", 4) == 0;
+            FrameData.Append(&Encoded[Pos], FMath::Min(PaddedSize, Encoded.Num() - Pos));
+        }
+        Pos += PaddedSize;
+    }
+
+    AppendFourCC(FrameChunks, "ANMF");
+    AppendLE(FrameChunks, (uint32)(16 + FrameData.Num()), 4);
+    AppendLE(FrameChunks, Rect.Min.X / 2, 3);
+    AppendLE(FrameChunks, Rect.Min.Y / 2, 3);
+    AppendLE(FrameChunks, Rect.Width() - 1, 3);
+    AppendLE(FrameChunks, Rect.Height() - 1, 3);
+    AppendLE(FrameChunks, FMath::Clamp(DurationMs, 0, 0xFFFFFF), 3);
+    AppendLE(FrameChunks, (Blend == EWebPFrameBlend::NoBlend ? 0x02 : 0) | (Dispose == EWebPFrameDispose::Background ? 0x01 : 0), 1);
+    FrameChunks.Append(FrameData);
+    ++NumAddedFrames;
+    return true;
+}
+
+TArray64<uint8> FWebPAnimationBuilder::Finish() const
+{
+    TArray64<uint8> Out;
+    Out.Reserve(12 + 18 + 14 + FrameChunks.Num());
+    AppendFourCC(Out, "RIFF");
+    AppendLE(Out, 0, 4); // Patched below
+    AppendFourCC(Out, "WEBP");
+
+    AppendFourCC(Out, "VP8X");
+    AppendLE(Out, 10, 4);
+    AppendLE(Out, 0x02 | (bHasAlpha ? 0x10 : 0), 4); // Animation, alpha
+    AppendLE(Out, CanvasSize.X - 1, 3);
+    AppendLE(Out, CanvasSize.Y - 1, 3);
+
+    AppendFourCC(Out, "ANIM");
+    AppendLE(Out, 6, 4);
+    AppendLE(Out, 0, 4); // Background colour: transparent (players ignore it anyway)
+    AppendLE(Out, FMath::Clamp(LoopCount, 0, 0xFFFF), 2);
+
+    Out.Append(FrameChunks);
+
+    const uint32 RiffSize = (uint32)(Out.Num() - 8);
+    FMemory::Memcpy(&Out[4], &RiffSize, 4);
+    return Out;
+}
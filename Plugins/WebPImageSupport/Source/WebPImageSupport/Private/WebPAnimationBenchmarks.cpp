@@ -0,0 +1,121 @@
+// WebPAnimationBenchmarks.cpp
+// Animated WebP playback cost per frame: reconstructing the canvas with FWebPAnimationCanvas, then staging either
+// just the changed rectangle (what FVNAnimationPlayer uploads) or the whole canvas (the naive path).
+#include "WebPBenchmark.h"
+#include "WebPAnimation.h"
+#include "WebPSyntheticImage.h"
+#include "WebpImageWrapper.h"
+
+#if WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
+
+namespace WebPAnimationBenchmarks
+{
+    struct FLoop
+    {
+        const TCHAR* Name;
+        FIntRect ChangedRect;   // Canvas area the loop animates
+        int32 NumFrames;
+    };
+
+    static TArray64<uint8> Crop(const TArray64<uint8>& Pixels, int32 Width, const FIntRect& Rect)
+    {
+        TArray64<uint8> Out;
+        Out.SetNumUninitialized((int64)Rect.Area() * 4);
+        for (int32 Row = 0; Row < Rect.Height(); ++Row)
+        {
+            FMemory::Memcpy(Out.GetData() + (int64)Row * Rect.Width() * 4,
+                Pixels.GetData() + ((int64)(Rect.Min.Y + Row) * Width + Rect.Min.X) * 4, (int64)Rect.Width() * 4);
+        }
+        return Out;
+    }
+
+    // Full sprite as frame 0, then frames that only replace ChangedRect
+    static TArray64<uint8> BuildAnimation(FIntPoint Canvas, const FLoop& Loop)
+    {
+        TArray64<uint8> Base;
+        FWebPSyntheticImage::Generate(Canvas.X, Canvas.Y, EWebPSyntheticContent::Sprite, 1, Base);
+
+        FWebPAnimationBuilder Builder(Canvas);
+        const FIntRect Full(FIntPoint::ZeroValue, Canvas);
+        if (!Builder.AddFrame(Base.GetData(), Full, 80, EWebPFrameDispose::None, EWebPFrameBlend::NoBlend, FWebPEncodeOptions(), 85))
+        {
+            return TArray64<uint8>();
+        }
+        for (int32 Frame = 1; Frame < Loop.NumFrames; ++Frame)
+        {
+            TArray64<uint8> Variant;
+            FWebPSyntheticImage::Generate(Canvas.X, Canvas.Y, EWebPSyntheticContent::Photo, 10 + Frame, Variant);
+            const TArray64<uint8> Patch = Crop(Variant, Canvas.X, Loop.ChangedRect);
+            if (!Builder.AddFrame(Patch.GetData(), Loop.ChangedRect, 80, EWebPFrameDispose::None, EWebPFrameBlend::NoBlend, FWebPEncodeOptions(), 85))
+            {
+                return TArray64<uint8>();
+            }
+        }
+        return Builder.Finish();
+    }
+
+    static void Run(FWebPBenchmarkContext& Context)
+    {
+        const FIntPoint Canvas = Context.bQuick ? FIntPoint(512, 768) : FIntPoint(1024, 1536);
+        const FLoop Loops[] = {
+            { TEXT("blink"), FIntRect(Canvas.X * 3 / 8 & ~1, Canvas.Y / 5 & ~1, (Canvas.X * 5 / 8) & ~1, (Canvas.Y / 5 + Canvas.Y / 24) & ~1), 6 },
+            { TEXT("lipsync"), FIntRect(Canvas.X * 7 / 16 & ~1, Canvas.Y * 2 / 7 & ~1, (Canvas.X * 9 / 16) & ~1, (Canvas.Y * 2 / 7 + Canvas.Y / 32) & ~1), 4 },
+        };
+        const int64 CanvasStride = (int64)Canvas.X * 4;
+        const int64 CanvasBytes = CanvasStride * Canvas.Y;
+
+        for (const FLoop& Loop : Loops)
+        {
+            const TArray64<uint8> File = BuildAnimation(Canvas, Loop);
+            FWebPAnimation Animation;
+            if (File.Num() == 0 || !Animation.InitializeView(TConstArrayView64<uint8>(File.GetData(), File.Num())))
+            {
+                continue;
+            }
+
+            const bool DirtySettings[] = { true, false };
+            for (bool bDirtyOnly : DirtySettings)
+            {
+                FWebPBenchmarkResult& Result = Context.AddResult(TEXT("AnimationUpload"),
+                    FString::Printf(TEXT("%s %dx%d %s"), Loop.Name, Canvas.X, Canvas.Y, bDirtyOnly ? TEXT("dirty-rect") : TEXT("full-canvas")));
+                Result.Params.Add(TEXT("loop"), Loop.Name);
+                Result.AddSizeParams(Canvas.X, Canvas.Y);
+                Result.Params.Add(TEXT("upload"), bDirtyOnly ? TEXT("dirty-rect") : TEXT("full-canvas"));
+                Result.Metrics.Add(TEXT("compressed_bytes"), (double)File.Num());
+
+                // One iteration = one steady-state frame (frame 0 is the one-off full upload when playback starts)
+                FWebPAnimationCanvas AnimCanvas(Animation);
+                TArray64<uint8> Staging;
+                Staging.SetNumUninitialized(CanvasBytes);
+                int64 StagedBytes = 0;
+                int32 StagedFrames = 0;
+                Context.Measure(Result, [&]()
+                {
+                    FIntRect Dirty;
+                    if (!AnimCanvas.DecodeNextFrame(Dirty) || AnimCanvas.GetFrameIndex() == 0)
+                    {
+                        return;
+                    }
+                    const FIntRect Upload = bDirtyOnly ? Dirty : FIntRect(FIntPoint::ZeroValue, Canvas);
+                    const int64 Pitch = (int64)Upload.Width() * 4;
+                    for (int32 Row = 0; Row < Upload.Height(); ++Row)
+                    {
+                        FMemory::Memcpy(Staging.GetData() + Row * Pitch,
+                            AnimCanvas.GetPixels().GetData() + (Upload.Min.Y + Row) * CanvasStride + Upload.Min.X * 4, Pitch);
+                    }
+                    StagedBytes += Pitch * Upload.Height();
+                    ++StagedFrames;
+                });
+
+                const double BytesPerFrame = StagedFrames > 0 ? (double)StagedBytes / StagedFrames : 0.0;
+                Result.BytesPerIteration = (int64)BytesPerFrame;
+                Result.Metrics.Add(TEXT("uploaded_bytes_per_frame"), BytesPerFrame);
+                Result.Metrics.Add(TEXT("full_canvas_bytes"), (double)CanvasBytes);
+            }
+        }
+    }
+
+    static FWebPBenchmarkSuiteRegistrar AnimationUploadSuite(TEXT("AnimationUpload"), &Run);
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
@@ -0,0 +1,181 @@
+// WebPBenchmark.cpp
+#include "WebPBenchmark.h"
+#include "WebPSimd.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "webp/decode.h"
+#include "webp/encode.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWebPBenchmark, Log, All);
+
+void FWebPBenchmarkResult::AddSizeParams(int32 Width, int32 Height)
+{
+    Params.Add(TEXT("width"), LexToString(Width));
+    Params.Add(TEXT("height"), LexToString(Height));
+}
+
+void FWebPBenchmarkResult::AddBackendParam(EWebPSimdBackend Backend)
+{
+    Params.Add(TEXT("cpu"), WebPSimd::ToString(Backend));
+}
+
+double FWebPBenchmarkResult::GetPercentileMs(double Percentile) const
+{
+    if (LatenciesSeconds.Num() == 0)
+    {
+        return 0.0;
+    }
+    TArray<double> Sorted = LatenciesSeconds;
+    Sorted.Sort();
+    // Nearest-rank percentile; good enough for the sample counts we run
+    const int32 Rank = FMath::Clamp(FMath::CeilToInt(Percentile / 100.0 * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+    return Sorted[Rank] * 1000.0;
+}
+
+double FWebPBenchmarkResult::GetMeanMs() const
+{
+    if (LatenciesSeconds.Num() == 0)
+    {
+        return 0.0;
+    }
+    double Total = 0.0;
+    for (double Latency : LatenciesSeconds)
+    {
+        Total += Latency;
+    }
+    return Total / LatenciesSeconds.Num() * 1000.0;
+}
+
+double FWebPBenchmarkResult::GetMegabytesPerSecond() const
+{
+    const double MeanSeconds = GetMeanMs() / 1000.0;
+    return MeanSeconds > 0.0 ? (BytesPerIteration / (1024.0 * 1024.0)) / MeanSeconds : 0.0;
+}
+
+FWebPBenchmarkResult& FWebPBenchmarkContext::AddResult(const FString& Suite, const FString& Case)
+{
+    FWebPBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+    Result.Suite = Suite;
+    Result.Case = Case;
+    return Result;
+}
+
+void FWebPBenchmarkContext::Measure(FWebPBenchmarkResult& OutResult, TFunctionRef<void()> Body) const
+{
+    for (int32 Index = 0; Index < WarmupIterations; ++Index)
+    {
+        Body();
+    }
+
+    OutResult.LatenciesSeconds.Reserve(OutResult.LatenciesSeconds.Num() + Iterations);
+    for (int32 Index = 0; Index < Iterations; ++Index)
+    {
+        const double Start = FPlatformTime::Seconds();
+        Body();
+        OutResult.LatenciesSeconds.Add(FPlatformTime::Seconds() - Start);
+    }
+}
+
+FString FWebPBenchmarkContext::ToJson() const
+{
+    TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+
+    TSharedRef<FJsonObject> Build = MakeShared<FJsonObject>();
+    Build->SetStringField(TEXT("project"), FApp::GetProjectName());
+    Build->SetStringField(TEXT("build_version"), FApp::GetBuildVersion());
+    Build->SetStringField(TEXT("configuration"), LexToString(FApp::GetBuildConfiguration()));
+    Build->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+    Build->SetStringField(TEXT("cpu"), FPlatformMisc::GetCPUBrand().TrimStartAndEnd());
+    Build->SetNumberField(TEXT("cores"), FPlatformMisc::NumberOfCores());
+    Build->SetNumberField(TEXT("logical_cores"), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+    Build->SetStringField(TEXT("libwebp_decoder"), FString::Printf(TEXT("%06x"), WebPGetDecoderVersion()));
+    Build->SetStringField(TEXT("libwebp_encoder"), FString::Printf(TEXT("%06x"), WebPGetEncoderVersion()));
+    Build->SetNumberField(TEXT("iterations"), Iterations);
+    Root->SetObjectField(TEXT("build"), Build);
+
+    TArray<TSharedPtr<FJsonValue>> ResultValues;
+    for (const FWebPBenchmarkResult& Result : Results)
+    {
+        TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+        Entry->SetStringField(TEXT("suite"), Result.Suite);
+        Entry->SetStringField(TEXT("case"), Result.Case);
+
+        TSharedRef<FJsonObject> Params = MakeShared<FJsonObject>();
+        for (const TPair<FString, FString>& Param : Result.Params)
+        {
+            Params->SetStringField(Param.Key, Param.Value);
+        }
+        Entry->SetObjectField(TEXT("params"), Params);
+
+        Entry->SetNumberField(TEXT("samples"), Result.LatenciesSeconds.Num());
+        Entry->SetNumberField(TEXT("bytes_per_iteration"), (double)Result.BytesPerIteration);
+        Entry->SetNumberField(TEXT("mb_per_s"), Result.GetMegabytesPerSecond());
+        Entry->SetNumberField(TEXT("mean_ms"), Result.GetMeanMs());
+        Entry->SetNumberField(TEXT("p50_ms"), Result.GetPercentileMs(50.0));
+        Entry->SetNumberField(TEXT("p90_ms"), Result.GetPercentileMs(90.0));
+        Entry->SetNumberField(TEXT("p99_ms"), Result.GetPercentileMs(99.0));
+        Entry->SetNumberField(TEXT("max_ms"), Result.GetPercentileMs(100.0));
+
+        for (const TPair<FString, double>& Metric : Result.Metrics)
+        {
+            Entry->SetNumberField(Metric.Key, Metric.Value);
+        }
+        ResultValues.Add(MakeShared<FJsonValueObject>(Entry));
+    }
+    Root->SetArrayField(TEXT("results"), ResultValues);
+
+    FString Output;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+    FJsonSerializer::Serialize(Root, Writer);
+    return Output;
+}
+
+void FWebPBenchmarkContext::LogSummary() const
+{
+    for (const FWebPBenchmarkResult& Result : Results)
+    {
+        UE_LOG(LogWebPBenchmark, Display, TEXT("%-10s %-48s %9.2f MB/s  p50 %8.3f ms  p90 %8.3f ms  p99 %8.3f ms"),
+            *Result.Suite, *Result.Case, Result.GetMegabytesPerSecond(),
+            Result.GetPercentileMs(50.0), Result.GetPercentileMs(90.0), Result.GetPercentileMs(99.0));
+    }
+}
+
+FWebPBenchmarkRegistry& FWebPBenchmarkRegistry::Get()
+{
+    static FWebPBenchmarkRegistry Registry;
+    return Registry;
+}
+
+void FWebPBenchmarkRegistry::Register(const FString& Name, FWebPBenchmarkSuiteFunc Func)
+{
+    Suites.Add(Name, MoveTemp(Func));
+}
+
+void FWebPBenchmarkRegistry::Unregister(const FString& Name)
+{
+    Suites.Remove(Name);
+}
+
+TArray<FString> FWebPBenchmarkRegistry::GetSuiteNames() const
+{
+    TArray<FString> Names;
+    Suites.GetKeys(Names);
+    Names.Sort();
+    return Names;
+}
+
+bool FWebPBenchmarkRegistry::RunSuite(const FString& Name, FWebPBenchmarkContext& Context) const
+{
+    const FWebPBenchmarkSuiteFunc* Func = Suites.Find(Name);
+    if (!Func)
+    {
+        UE_LOG(LogWebPBenchmark, Error, TEXT("Unknown benchmark suite '%s'."), *Name);
+        return false;
+    }
+    UE_LOG(LogWebPBenchmark, Display, TEXT("Running benchmark suite '%s'..."), *Name);
+    (*Func)(Context);
+    return true;
+}
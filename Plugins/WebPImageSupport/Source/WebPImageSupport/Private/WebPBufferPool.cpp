@@ -0,0 +1,414 @@
+// WebPBufferPool.cpp
+#include "WebPBufferPool.h"
+#include "WebPStats.h"
+#include "Algo/BinarySearch.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+
+namespace WebPBufferPool
+{
+    static constexpr int32 ClassesPerOctave = 4;
+
+    // MinPooledBytes * {4,5,6,7}/4 per octave, up to and including MaxPooledBytes
+    static const TArray<int64>& GetClassSizes()
+    {
+        static const TArray<int64> Sizes = []()
+        {
+            TArray<int64> Result;
+            for (int64 Octave = FWebPBufferPool::MinPooledBytes; Octave <= FWebPBufferPool::MaxPooledBytes; Octave *= 2)
+            {
+                for (int32 Step = 0; Step < ClassesPerOctave; ++Step)
+                {
+                    const int64 Size = Octave / ClassesPerOctave * (ClassesPerOctave + Step);
+                    if (Size <= FWebPBufferPool::MaxPooledBytes)
+                    {
+                        Result.Add(Size);
+                    }
+                }
+            }
+            return Result;
+        }();
+        return Sizes;
+    }
+
+    static void AtomicMax(std::atomic<int64>& Target, int64 Value)
+    {
+        int64 Current = Target.load(std::memory_order_relaxed);
+        while (Value > Current && !Target.compare_exchange_weak(Current, Value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    static int32 GMaxCachedMB = 256;
+    static FAutoConsoleVariableRef CVarMaxCachedMB(
+        TEXT("WebP.BufferPool.MaxCachedMB"),
+        GMaxCachedMB,
+        TEXT("Idle bytes (MB) the WebP buffer pool keeps for reuse before releases start freeing."),
+        FConsoleVariableDelegate::CreateLambda([](IConsoleVariable*)
+        {
+            FWebPBufferPool::Get().SetMaxCachedBytes((int64)FMath::Max(GMaxCachedMB, 0) * 1024 * 1024);
+        }));
+
+    static int32 GEnabled = 1;
+    static FAutoConsoleVariableRef CVarEnabled(
+        TEXT("WebP.BufferPool.Enable"),
+        GEnabled,
+        TEXT("0 makes the WebP buffer pool allocate and free directly (for A/B comparisons)."),
+        FConsoleVariableDelegate::CreateLambda([](IConsoleVariable*)
+        {
+            FWebPBufferPool::Get().SetEnabled(GEnabled != 0);
+        }));
+}
+
+// Small buffers released on a thread are most often re-acquired by the same thread (wrapper compressed copies,
+// loose file reads), so they skip the shared lock. Large buffers always go to the shared buckets: decoded pixels
+// are typically released on the game thread and re-acquired on a worker.
+struct FWebPBufferPool::FThreadCache
+{
+    static constexpr int32 MaxBuffers = 4;
+
+    struct FEntry
+    {
+        int32 Class = INDEX_NONE;
+        TArray64<uint8> Buffer;
+    };
+    TArray<FEntry, TInlineAllocator<MaxBuffers>> Entries;
+    uint32 Epoch = 0;
+
+    void Empty()
+    {
+        int64 Freed = 0;
+        for (const FEntry& Entry : Entries)
+        {
+            Freed += Entry.Buffer.Max();
+        }
+        Entries.Empty();
+        FWebPBufferPool::Get().AddCached(-Freed);
+    }
+
+    ~FThreadCache()
+    {
+        // Thread exit: the buffers are freed with the array, only the accounting has to follow
+        Empty();
+    }
+};
+
+FWebPBufferPool& FWebPBufferPool::Get()
+{
+    // Never destroyed: thread caches report back to it during thread (and process) exit
+    static FWebPBufferPool* Pool = new FWebPBufferPool();
+    return *Pool;
+}
+
+FWebPBufferPool::FWebPBufferPool()
+{
+    Buckets.SetNum(GetNumClasses());
+    FCoreDelegates::GetMemoryTrimDelegate().AddLambda([this]() { Trim(); });
+}
+
+FWebPBufferPool::FThreadCache& FWebPBufferPool::GetThreadCache()
+{
+    static thread_local FThreadCache Cache;
+    const uint32 Epoch = TrimEpoch.load(std::memory_order_acquire);
+    if (Cache.Epoch != Epoch)
+    {
+        Cache.Empty(); // Trimmed from another thread since this one last looked
+        Cache.Epoch = Epoch;
+    }
+    return Cache;
+}
+
+int32 FWebPBufferPool::GetNumClasses()
+{
+    return WebPBufferPool::GetClassSizes().Num();
+}
+
+int64 FWebPBufferPool::GetClassSize(int32 ClassIndex)
+{
+    return WebPBufferPool::GetClassSizes()[ClassIndex];
+}
+
+int32 FWebPBufferPool::GetClassForRequest(int64 Size)
+{
+    if (Size < MinPooledBytes || Size > MaxPooledBytes)
+    {
+        return INDEX_NONE;
+    }
+    return Algo::LowerBound(WebPBufferPool::GetClassSizes(), Size);
+}
+
+int32 FWebPBufferPool::GetClassForCapacity(int64 Capacity)
+{
+    if (Capacity < MinPooledBytes || Capacity > MaxPooledBytes)
+    {
+        return INDEX_NONE;
+    }
+    return Algo::UpperBound(WebPBufferPool::GetClassSizes(), Capacity) - 1;
+}
+
+TArray64<uint8> FWebPBufferPool::Acquire(int64 Size)
+{
+    TArray64<uint8> Buffer;
+    if (Size <= 0)
+    {
+        return Buffer;
+    }
+
+    const int32 Class = GetClassForRequest(Size);
+    if (Class == INDEX_NONE)
+    {
+        Buffer.SetNumUninitialized(Size);
+        return Buffer;
+    }
+
+    Acquires.fetch_add(1, std::memory_order_relaxed);
+    bool bReused = false;
+
+    if (!IsEnabled())
+    {
+        // Still accounted, so footprint can be compared with the pool on and off
+        Misses.fetch_add(1, std::memory_order_relaxed);
+        Buffer.SetNumUninitialized(Size);
+        AddOutstanding(Buffer.Max());
+        return Buffer;
+    }
+
+    if (GetClassSize(Class) <= MaxThreadCachedBytes)
+    {
+        FThreadCache& Cache = GetThreadCache();
+        for (int32 Index = 0; Index < Cache.Entries.Num(); ++Index)
+        {
+            if (Cache.Entries[Index].Class == Class)
+            {
+                Buffer = MoveTemp(Cache.Entries[Index].Buffer);
+                Cache.Entries.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+                ThreadCacheHits.fetch_add(1, std::memory_order_relaxed);
+                bReused = true;
+                break;
+            }
+        }
+    }
+
+    if (!bReused)
+    {
+        FScopeLock Lock(&Mutex);
+        // A buffer one class up is only one size step larger and saves a fresh allocation when sizes straddle a boundary
+        for (int32 Candidate = Class; Candidate <= FMath::Min(Class + 1, Buckets.Num() - 1) && !bReused; ++Candidate)
+        {
+            if (Buckets[Candidate].Num() > 0)
+            {
+                Buffer = Buckets[Candidate].Pop(EAllowShrinking::No);
+                SharedHits.fetch_add(1, std::memory_order_relaxed);
+                bReused = true;
+            }
+        }
+    }
+
+    if (bReused)
+    {
+        AddCached(-Buffer.Max());
+        INC_DWORD_STAT(STAT_WebP_PoolHits);
+    }
+    else
+    {
+        Misses.fetch_add(1, std::memory_order_relaxed);
+        INC_DWORD_STAT(STAT_WebP_PoolMisses);
+        Buffer.Reserve(GetClassSize(Class)); // Full class capacity so the buffer can serve any request in its class later
+    }
+
+    Buffer.SetNumUninitialized(Size, EAllowShrinking::No);
+    AddOutstanding(Buffer.Max());
+    return Buffer;
+}
+
+void FWebPBufferPool::Release(TArray64<uint8>& Buffer)
+{
+    const int64 Capacity = Buffer.Max();
+    if (Capacity == 0)
+    {
+        return;
+    }
+
+    const int32 Class = GetClassForCapacity(Capacity);
+    if (Class == INDEX_NONE)
+    {
+        Buffer.Empty();
+        return;
+    }
+
+    AddOutstanding(-Capacity);
+    if (!IsEnabled())
+    {
+        Buffer.Empty();
+        Discards.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Buffer.Reset();
+
+    if (CachedBytes.load(std::memory_order_relaxed) + Capacity > MaxCachedBytes.load(std::memory_order_relaxed))
+    {
+        Buffer.Empty();
+        Discards.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (Capacity <= MaxThreadCachedBytes)
+    {
+        FThreadCache& Cache = GetThreadCache();
+        if (Cache.Entries.Num() < FThreadCache::MaxBuffers)
+        {
+            FThreadCache::FEntry& Entry = Cache.Entries.AddDefaulted_GetRef();
+            Entry.Class = Class;
+            Entry.Buffer = MoveTemp(Buffer);
+            Releases.fetch_add(1, std::memory_order_relaxed);
+            AddCached(Capacity);
+            return;
+        }
+    }
+
+    {
+        FScopeLock Lock(&Mutex);
+        Buckets[Class].Add(MoveTemp(Buffer));
+    }
+    Releases.fetch_add(1, std::memory_order_relaxed);
+    AddCached(Capacity);
+}
+
+void FWebPBufferPool::Trim()
+{
+    int64 Freed = 0;
+    {
+        FScopeLock Lock(&Mutex);
+        for (TArray<TArray64<uint8>>& Bucket : Buckets)
+        {
+            for (const TArray64<uint8>& Buffer : Bucket)
+            {
+                Freed += Buffer.Max();
+            }
+            Bucket.Empty();
+        }
+    }
+
+    AddCached(-Freed);
+
+    // Every thread cache is now stale; this thread's goes right away, the others' on their next access
+    TrimEpoch.fetch_add(1, std::memory_order_release);
+    GetThreadCache();
+}
+
+void FWebPBufferPool::SetMaxCachedBytes(int64 Bytes)
+{
+    MaxCachedBytes.store(FMath::Max<int64>(Bytes, 0), std::memory_order_relaxed);
+    if (CachedBytes.load(std::memory_order_relaxed) > Bytes)
+    {
+        Trim();
+    }
+}
+
+int64 FWebPBufferPool::GetMaxCachedBytes() const
+{
+    return MaxCachedBytes.load(std::memory_order_relaxed);
+}
+
+void FWebPBufferPool::SetEnabled(bool bInEnabled)
+{
+    bEnabled.store(bInEnabled, std::memory_order_relaxed);
+    if (!bInEnabled)
+    {
+        Trim();
+    }
+}
+
+bool FWebPBufferPool::IsEnabled() const
+{
+    return bEnabled.load(std::memory_order_relaxed);
+}
+
+void FWebPBufferPool::AddCached(int64 Delta)
+{
+    const int64 NewCached = CachedBytes.fetch_add(Delta, std::memory_order_relaxed) + Delta;
+    SET_MEMORY_STAT(STAT_WebP_PoolCachedBytes, NewCached);
+    UpdatePeaks();
+}
+
+void FWebPBufferPool::AddOutstanding(int64 Delta)
+{
+    OutstandingBytes.fetch_add(Delta, std::memory_order_relaxed);
+    UpdatePeaks();
+}
+
+void FWebPBufferPool::UpdatePeaks()
+{
+    const int64 Cached = CachedBytes.load(std::memory_order_relaxed);
+    // Buffers allocated elsewhere and released here can push outstanding below zero
+    const int64 Outstanding = FMath::Max<int64>(OutstandingBytes.load(std::memory_order_relaxed), 0);
+    WebPBufferPool::AtomicMax(PeakCachedBytes, Cached);
+    WebPBufferPool::AtomicMax(PeakFootprintBytes, Cached + Outstanding);
+}
+
+FWebPBufferPool::FStats FWebPBufferPool::GetStats() const
+{
+    FStats Stats;
+    Stats.Acquires = Acquires.load(std::memory_order_relaxed);
+    Stats.ThreadCacheHits = ThreadCacheHits.load(std::memory_order_relaxed);
+    Stats.SharedHits = SharedHits.load(std::memory_order_relaxed);
+    Stats.Misses = Misses.load(std::memory_order_relaxed);
+    Stats.Releases = Releases.load(std::memory_order_relaxed);
+    Stats.Discards = Discards.load(std::memory_order_relaxed);
+    Stats.CachedBytes = CachedBytes.load(std::memory_order_relaxed);
+    Stats.OutstandingBytes = FMath::Max<int64>(OutstandingBytes.load(std::memory_order_relaxed), 0);
+    Stats.PeakCachedBytes = PeakCachedBytes.load(std::memory_order_relaxed);
+    Stats.PeakFootprintBytes = PeakFootprintBytes.load(std::memory_order_relaxed);
+    return Stats;
+}
+
+void FWebPBufferPool::ResetStats()
+{
+    Acquires = 0;
+    ThreadCacheHits = 0;
+    SharedHits = 0;
+    Misses = 0;
+    Releases = 0;
+    Discards = 0;
+    // Byte counters track live state; only the peaks restart from it
+    PeakCachedBytes = CachedBytes.load(std::memory_order_relaxed);
+    PeakFootprintBytes = PeakCachedBytes + FMath::Max<int64>(OutstandingBytes.load(std::memory_order_relaxed), 0);
+}
+
+void FWebPBufferPool::Dump(FOutputDevice& Ar) const
+{
+    const FStats Stats = GetStats();
+    const double ToMB = 1.0 / (1024.0 * 1024.0);
+
+    Ar.Logf(TEXT("WebP buffer pool (%s): %lld acquires, %.1f%% reused (%lld thread cache, %lld shared), %lld misses, %lld releases, %lld discards"),
+        IsEnabled() ? TEXT("enabled") : TEXT("disabled"), Stats.Acquires, Stats.GetReuseRate() * 100.0,
+        Stats.ThreadCacheHits, Stats.SharedHits, Stats.Misses, Stats.Releases, Stats.Discards);
+    Ar.Logf(TEXT("  cached %.2f MB (peak %.2f MB, limit %.2f MB), outstanding %.2f MB, peak footprint %.2f MB"),
+        Stats.CachedBytes * ToMB, Stats.PeakCachedBytes * ToMB, GetMaxCachedBytes() * ToMB,
+        Stats.OutstandingBytes * ToMB, Stats.PeakFootprintBytes * ToMB);
+
+    FScopeLock Lock(&Mutex);
+    for (int32 Class = 0; Class < Buckets.Num(); ++Class)
+    {
+        if (Buckets[Class].Num() > 0)
+        {
+            Ar.Logf(TEXT("    %10.2f MB class: %d idle"), GetClassSize(Class) * ToMB, Buckets[Class].Num());
+        }
+    }
+}
+
+static FAutoConsoleCommandWithOutputDevice GWebPBufferPoolCommand(
+    TEXT("WebP.BufferPool"),
+    TEXT("Prints WebP buffer pool reuse rate, cached bytes and peak footprint."),
+    FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+    {
+        FWebPBufferPool::Get().Dump(Ar);
+    }));
+
+static FAutoConsoleCommand GWebPBufferPoolTrimCommand(
+    TEXT("WebP.BufferPool.Trim"),
+    TEXT("Frees every idle buffer in the WebP buffer pool."),
+    FConsoleCommandDelegate::CreateLambda([]()
+    {
+        FWebPBufferPool::Get().Trim();
+    }));
@@ -0,0 +1,106 @@
+// WebPBufferPoolBenchmarks.cpp
+// Scene-load churn with FWebPBufferPool on and off: decode a scene's worth of images while older decoded images
+// fall out of a small LRU window, like the VN image cache does during chapter playback.
+#include "WebPBenchmark.h"
+#include "WebPBufferPool.h"
+#include "WebPSyntheticImage.h"
+#include "WebpImageWrapper.h"
+
+#if WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
+
+namespace WebPBufferPoolBenchmarks
+{
+    struct FSceneImage
+    {
+        int32 Width;
+        int32 Height;
+        EWebPSyntheticContent Content;
+    };
+
+    static void Run(FWebPBenchmarkContext& Context)
+    {
+        // Background, three character sprites, two UI parts; varied sizes so buffers land in different classes
+        const FSceneImage SceneImages[] = {
+            { 1920, 1080, EWebPSyntheticContent::Photo },
+            { 640, 1040, EWebPSyntheticContent::Sprite },
+            { 600, 1000, EWebPSyntheticContent::Sprite },
+            { 700, 1080, EWebPSyntheticContent::Sprite },
+            { 512, 128, EWebPSyntheticContent::Gradient },
+            { 256, 256, EWebPSyntheticContent::Flat },
+        };
+        const int32 LiveWindow = Context.bQuick ? 8 : 16;
+        const int32 ScenesPerIteration = Context.bQuick ? 4 : 12;
+
+        TArray<TArray64<uint8>> Compressed;
+        int64 DecodedBytesPerScene = 0;
+        for (int32 Index = 0; Index < UE_ARRAY_COUNT(SceneImages); ++Index)
+        {
+            const FSceneImage& Image = SceneImages[Index];
+            TArray64<uint8> Pixels;
+            FWebPSyntheticImage::Generate(Image.Width, Image.Height, Image.Content, 100 + Index, Pixels);
+
+            TArray64<uint8> Encoded = FWebPSyntheticImage::Encode(Pixels.GetData(), Image.Width, Image.Height, 80);
+            if (Encoded.Num() > 0)
+            {
+                Compressed.Add(MoveTemp(Encoded));
+                DecodedBytesPerScene += (int64)Image.Width * Image.Height * 4;
+            }
+        }
+
+        FWebPBufferPool& Pool = FWebPBufferPool::Get();
+        const bool bWasEnabled = Pool.IsEnabled();
+        const bool PoolSettings[] = { false, true };
+
+        for (bool bPooled : PoolSettings)
+        {
+            Pool.SetEnabled(bPooled);
+            Pool.Trim();
+            Pool.ResetStats();
+
+            FWebPBenchmarkResult& Result = Context.AddResult(TEXT("BufferPool"),
+                FString::Printf(TEXT("%d scenes window=%d pool=%d"), ScenesPerIteration, LiveWindow, bPooled ? 1 : 0));
+            Result.Params.Add(TEXT("pool"), bPooled ? TEXT("true") : TEXT("false"));
+            Result.Params.Add(TEXT("window"), LexToString(LiveWindow));
+            Result.Params.Add(TEXT("scenes"), LexToString(ScenesPerIteration));
+            Result.BytesPerIteration = DecodedBytesPerScene * ScenesPerIteration;
+
+            TArray<TArray64<uint8>> Live; // Oldest first
+            Context.Measure(Result, [&]()
+            {
+                for (int32 Scene = 0; Scene < ScenesPerIteration; ++Scene)
+                {
+                    for (const TArray64<uint8>& Bytes : Compressed)
+                    {
+                        FWebpImageWrapper Wrapper;
+                        TArray64<uint8>& Decoded = Live.AddDefaulted_GetRef();
+                        if (Wrapper.SetCompressed(Bytes.GetData(), Bytes.Num()))
+                        {
+                            Wrapper.ReleaseRaw(ERGBFormat::BGRA, 8, Decoded);
+                        }
+                        if (Live.Num() > LiveWindow)
+                        {
+                            Pool.Release(Live[0]);
+                            Live.RemoveAt(0);
+                        }
+                    }
+                }
+            });
+            for (TArray64<uint8>& Buffer : Live)
+            {
+                Pool.Release(Buffer);
+            }
+
+            const FWebPBufferPool::FStats Stats = Pool.GetStats();
+            Result.Metrics.Add(TEXT("reuse_rate"), Stats.GetReuseRate());
+            Result.Metrics.Add(TEXT("pool_misses"), (double)Stats.Misses);
+            Result.Metrics.Add(TEXT("pool_discards"), (double)Stats.Discards);
+            Result.Metrics.Add(TEXT("peak_footprint_mb"), Stats.PeakFootprintBytes / (1024.0 * 1024.0));
+        }
+
+        Pool.SetEnabled(bWasEnabled);
+    }
+
+    static FWebPBenchmarkSuiteRegistrar BufferPoolSuite(TEXT("BufferPool"), &Run);
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
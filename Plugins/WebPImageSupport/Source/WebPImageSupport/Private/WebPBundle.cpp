@@ -0,0 +1,522 @@
+// WebPBundle.cpp
+#include "WebPBundle.h"
+#include "WebPStats.h"
+#include "WebPMemory.h"
+#include "WebPTrim.h"
+#include "WebpImageWrapper.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Algo/BinarySearch.h"
+#include "Hash/CityHash.h"
+#include "Misc/ScopeExit.h"
+#include "webp/decode.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWebPBundle, Log, All);
+
+FString WebPBundle::NormalizeName(FStringView Name)
+{
+    FString Result(Name);
+    Result.ReplaceInline(TEXT("\\"), TEXT("/"));
+    Result.ToLowerInline();
+    while (Result.StartsWith(TEXT("/")))
+    {
+        Result.RightChopInline(1);
+    }
+    if (Result.EndsWith(TEXT(".webp")))
+    {
+        Result.LeftChopInline(5);
+    }
+    return Result;
+}
+
+uint64 WebPBundle::HashName(FStringView Name)
+{
+    const FTCHARToUTF8 Utf8(Name.GetData(), Name.Len());
+    return CityHash64(Utf8.Get(), Utf8.Length());
+}
+
+FWebPBundleReader::FWebPBundleReader() = default;
+
+FWebPBundleReader::~FWebPBundleReader()
+{
+    Close();
+}
+
+bool FWebPBundleReader::Open(const FString& InFilename)
+{
+    WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_FileRead);
+    Close();
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    int64 FileSize = 0;
+
+    MappedHandle.Reset(PlatformFile.OpenMapped(*InFilename));
+    if (MappedHandle.IsValid())
+    {
+        FileSize = MappedHandle->GetFileSize();
+        MappedRegion.Reset(MappedHandle->MapRegion(0, FileSize));
+    }
+
+    if (MappedRegion.IsValid())
+    {
+        Base = MappedRegion->GetMappedPtr();
+    }
+    else
+    {
+        // Pak files and some platforms can't map; one read is still far cheaper than per-image opens
+        MappedHandle.Reset();
+        LLM_SCOPE_BYTAG(WebP_Compressed);
+        if (!FFileHelper::LoadFileToArray(FallbackData, *InFilename))
+        {
+            UE_LOG(LogWebPBundle, Error, TEXT("Failed to open bundle %s"), *InFilename);
+            return false;
+        }
+        FileSize = FallbackData.Num();
+        Base = FallbackData.GetData();
+    }
+
+    Filename = InFilename;
+    if (!Validate(FileSize))
+    {
+        UE_LOG(LogWebPBundle, Error, TEXT("%s is not a valid WebP bundle"), *InFilename);
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool FWebPBundleReader::Validate(int64 FileSize)
+{
+    if (FileSize < (int64)sizeof(FWebPBundleHeader))
+    {
+        return false;
+    }
+
+    const FWebPBundleHeader* CandidateHeader = reinterpret_cast<const FWebPBundleHeader*>(Base);
+    if (CandidateHeader->Magic != WebPBundle::Magic
+        || CandidateHeader->Version < WebPBundle::MinVersion || CandidateHeader->Version > WebPBundle::Version
+        || (CandidateHeader->Version < WebPBundle::PlacementsVersion && CandidateHeader->Flags != 0))
+    {
+        return false;
+    }
+
+    // Offsets are checked against FileSize minus the size, like tiles, so a crafted header can't overflow the sum
+    const uint64 Size = (uint64)FileSize;
+    const uint64 IndexBytes = (uint64)CandidateHeader->EntryCount * sizeof(FWebPBundleEntry);
+    if (CandidateHeader->IndexOffset % alignof(FWebPBundleEntry) != 0
+        || IndexBytes > Size || CandidateHeader->IndexOffset > Size - IndexBytes
+        || CandidateHeader->NamesSize > Size || CandidateHeader->NamesOffset > Size - CandidateHeader->NamesSize)
+    {
+        return false;
+    }
+    const uint64 IndexEnd = CandidateHeader->IndexOffset + IndexBytes;
+
+    const FWebPBundleEntry* FirstEntry = reinterpret_cast<const FWebPBundleEntry*>(Base + CandidateHeader->IndexOffset);
+    TConstArrayView<FWebPBundleEntry> CandidateEntries(FirstEntry, CandidateHeader->EntryCount);
+    for (int32 Index = 0; Index < CandidateEntries.Num(); ++Index)
+    {
+        const FWebPBundleEntry& Entry = CandidateEntries[Index];
+        if (Entry.DataSize > Size || Entry.DataOffset > Size - Entry.DataSize
+            || (Index > 0 && CandidateEntries[Index - 1].NameHash >= Entry.NameHash))
+        {
+            return false;
+        }
+    }
+
+    TConstArrayView<FWebPBundlePlacement> CandidatePlacements;
+    if (EnumHasAnyFlags((EWebPBundleFlags)CandidateHeader->Flags, EWebPBundleFlags::HasPlacements))
+    {
+        if ((uint64)CandidateHeader->EntryCount * sizeof(FWebPBundlePlacement) > Size - IndexEnd)
+        {
+            return false;
+        }
+        CandidatePlacements = TConstArrayView<FWebPBundlePlacement>(reinterpret_cast<const FWebPBundlePlacement*>(Base + IndexEnd), CandidateHeader->EntryCount);
+    }
+
+    Header = CandidateHeader;
+    Entries = CandidateEntries;
+    Placements = CandidatePlacements;
+    return true;
+}
+
+void FWebPBundleReader::Close()
+{
+    Header = nullptr;
+    Base = nullptr;
+    Entries = TConstArrayView<FWebPBundleEntry>();
+    Placements = TConstArrayView<FWebPBundlePlacement>();
+    MappedRegion.Reset(); // Region before handle
+    MappedHandle.Reset();
+    FallbackData.Empty();
+    Filename.Reset();
+}
+
+const FWebPBundleEntry* FWebPBundleReader::Find(uint64 NameHash) const
+{
+    const int32 Index = Algo::BinarySearchBy(Entries, NameHash, &FWebPBundleEntry::NameHash);
+    return Index != INDEX_NONE ? &Entries[Index] : nullptr;
+}
+
+TConstArrayView64<uint8> FWebPBundleReader::GetData(const FWebPBundleEntry& Entry) const
+{
+    check(IsOpen());
+    return TConstArrayView64<uint8>(Base + Entry.DataOffset, Entry.DataSize);
+}
+
+void FWebPBundleReader::PreloadHint(const FWebPBundleEntry& Entry) const
+{
+    if (MappedRegion.IsValid())
+    {
+        MappedRegion->PreloadHint((int64)Entry.DataOffset, Entry.DataSize);
+    }
+}
+
+FString FWebPBundleReader::GetName(const FWebPBundleEntry& Entry) const
+{
+    // uint32 fields: the sum could wrap, the difference can't
+    if (!IsOpen() || Entry.NameLength > Header->NamesSize || Entry.NameOffset > Header->NamesSize - Entry.NameLength)
+    {
+        return FString();
+    }
+    const ANSICHAR* Utf8 = reinterpret_cast<const ANSICHAR*>(Base + Header->NamesOffset + Entry.NameOffset);
+    const FUTF8ToTCHAR Converted(Utf8, Entry.NameLength);
+    return FString(Converted.Length(), Converted.Get());
+}
+
+FWebPBundlePlacement FWebPBundleReader::GetPlacement(const FWebPBundleEntry& Entry) const
+{
+    const int32 Index = UE_PTRDIFF_TO_INT32(&Entry - Entries.GetData());
+    if (Placements.IsValidIndex(Index))
+    {
+        return Placements[Index];
+    }
+    return { 0, 0, (uint16)Entry.Width, (uint16)Entry.Height };
+}
+
+bool FWebPBundleBuilder::Add(const FString& Name, TArray64<uint8>&& CompressedBytes, FString* OutError)
+{
+    const FString Normalized = WebPBundle::NormalizeName(Name);
+
+    WebPBitstreamFeatures Features;
+    if (CompressedBytes.Num() == 0 || CompressedBytes.Num() > MAX_uint32
+        || WebPGetFeatures(CompressedBytes.GetData(), CompressedBytes.Num(), &Features) != VP8_STATUS_OK)
+    {
+        if (OutError) { *OutError = FString::Printf(TEXT("%s is not a valid WebP image"), *Name); }
+        return false;
+    }
+
+    const uint64 Hash = WebPBundle::HashName(Normalized);
+    if (const int32* Existing = HashToIndex.Find(Hash))
+    {
+        if (OutError)
+        {
+            *OutError = Pending[*Existing].Name == Normalized
+                ? FString::Printf(TEXT("Duplicate entry %s"), *Normalized)
+                : FString::Printf(TEXT("Hash collision between %s and %s"), *Pending[*Existing].Name, *Normalized);
+        }
+        return false;
+    }
+
+    EWebPBundleEntryFlags Flags = EWebPBundleEntryFlags::None;
+    if (Features.has_alpha) { Flags |= EWebPBundleEntryFlags::HasAlpha; }
+    if (Features.has_animation) { Flags |= EWebPBundleEntryFlags::Animated; }
+    if (Features.format == 2) { Flags |= EWebPBundleEntryFlags::Lossless; }
+
+    const int64 SourceBytes = CompressedBytes.Num();
+    uint32 Width = Features.width;
+    uint32 Height = Features.height;
+    FWebPBundlePlacement Placement = { 0, 0, (uint16)Width, (uint16)Height };
+    if (bTrim && !TrimTransparentBorder(Normalized, CompressedBytes, Flags, Width, Height, Placement, OutError))
+    {
+        return false;
+    }
+
+    // Dedupe sees the trimmed image: the same character at different canvas offsets still shares a blob
+    bool bPixelMatch = false;
+    const int32 CanonicalIndex = FindDuplicate(CompressedBytes, Flags, bPixelMatch);
+
+    FPending& Entry = Pending.AddDefaulted_GetRef();
+    Entry.Name = Normalized;
+    Entry.Hash = Hash;
+    Entry.Width = Width;
+    Entry.Height = Height;
+    Entry.Flags = Flags;
+    Entry.Placement = Placement;
+    Entry.SourceBytes = SourceBytes;
+    Entry.CanonicalIndex = CanonicalIndex;
+    Entry.bPixelMatch = bPixelMatch;
+    if (CanonicalIndex == INDEX_NONE)
+    {
+        Entry.Bytes = MoveTemp(CompressedBytes);
+    }
+    HashToIndex.Add(Hash, Pending.Num() - 1);
+    return true;
+}
+
+bool FWebPBundleBuilder::TrimTransparentBorder(const FString& Name, TArray64<uint8>& Bytes, EWebPBundleEntryFlags Flags,
+                                               uint32& InOutWidth, uint32& InOutHeight, FWebPBundlePlacement& OutPlacement, FString* OutError)
+{
+    // Animation frames already carry their own rectangles; opaque images have nothing to trim
+    if (EnumHasAnyFlags(Flags, EWebPBundleEntryFlags::Animated) || !EnumHasAnyFlags(Flags, EWebPBundleEntryFlags::HasAlpha))
+    {
+        return true;
+    }
+
+    int32 Width = 0;
+    int32 Height = 0;
+    uint8* Pixels = WebPDecodeBGRA(Bytes.GetData(), Bytes.Num(), &Width, &Height);
+    if (!Pixels)
+    {
+        if (OutError) { *OutError = FString::Printf(TEXT("Failed to decode %s for trimming"), *Name); }
+        return false;
+    }
+    ON_SCOPE_EXIT { WebPFree(Pixels); };
+
+    const int64 Stride = (int64)Width * 4;
+    const FIntRect Bounds = WebPTrim::FindContentBounds(Pixels, Width, Height, Stride);
+    const int64 CanvasArea = (int64)Width * Height;
+    if (Bounds.IsEmpty() || (double)(CanvasArea - Bounds.Area()) < CanvasArea * TrimMinSavedFraction)
+    {
+        return true; // Fully transparent placeholders are left alone too: a 0x0 image isn't a valid WebP
+    }
+
+    const bool bLossless = EnumHasAnyFlags(Flags, EWebPBundleEntryFlags::Lossless);
+    FWebPEncodeOptions Options;
+    Options.bLossless = bLossless;
+    FWebpImageWrapper Wrapper;
+    Wrapper.SetEncodeOptions(Options);
+    TArray64<uint8> Encoded;
+    // Encoded straight out of the canvas: the crop is just an origin and a stride
+    const uint8* Origin = Pixels + Bounds.Min.Y * Stride + (int64)Bounds.Min.X * 4;
+    if (Wrapper.SetRawView(Origin, Stride * (Bounds.Height() - 1) + (int64)Bounds.Width() * 4, Bounds.Width(), Bounds.Height(),
+                           ERGBFormat::BGRA, 8, (int32)Stride))
+    {
+        Encoded = Wrapper.GetCompressed(bLossless ? 100 : TrimLossyQuality);
+    }
+    if (Encoded.Num() == 0)
+    {
+        if (OutError) { *OutError = FString::Printf(TEXT("Failed to re-encode trimmed %s"), *Name); }
+        return false;
+    }
+
+    Bytes = MoveTemp(Encoded);
+    InOutWidth = Bounds.Width();
+    InOutHeight = Bounds.Height();
+    OutPlacement = { (uint16)Bounds.Min.X, (uint16)Bounds.Min.Y, (uint16)Width, (uint16)Height };
+    return true;
+}
+
+int32 FWebPBundleBuilder::FindDuplicate(const TArray64<uint8>& Bytes, EWebPBundleEntryFlags Flags, bool& bOutPixelMatch)
+{
+    // Anything without a match is registered under Pending.Num(), the index Add gives it next
+    bOutPixelMatch = false;
+    if (DedupeMode == EWebPBundleDedupe::None)
+    {
+        return INDEX_NONE;
+    }
+
+    const uint64 ContentHash = CityHash64(reinterpret_cast<const char*>(Bytes.GetData()), Bytes.Num());
+    TArray<int32, TInlineAllocator<4>> Candidates;
+    ContentHashToIndex.MultiFind(ContentHash, Candidates);
+    for (int32 Candidate : Candidates)
+    {
+        const TArray64<uint8>& Other = Pending[Candidate].Bytes;
+        if (Other.Num() == Bytes.Num() && FMemory::Memcmp(Other.GetData(), Bytes.GetData(), Bytes.Num()) == 0)
+        {
+            return Candidate;
+        }
+    }
+
+    // Pixel matching is for stills; comparing animations would mean compositing every frame
+    if (DedupeMode == EWebPBundleDedupe::Pixels && !EnumHasAnyFlags(Flags, EWebPBundleEntryFlags::Animated))
+    {
+        int32 Width = 0;
+        int32 Height = 0;
+        uint8* Pixels = WebPDecodeBGRA(Bytes.GetData(), Bytes.Num(), &Width, &Height);
+        if (Pixels)
+        {
+            ON_SCOPE_EXIT { WebPFree(Pixels); };
+            const int64 PixelBytes = (int64)Width * Height * 4;
+            const uint64 PixelHash = CityHash64WithSeed(reinterpret_cast<const char*>(Pixels), PixelBytes, ((uint64)Width << 32) | (uint32)Height);
+
+            Candidates.Reset();
+            PixelHashToIndex.MultiFind(PixelHash, Candidates);
+            for (int32 Candidate : Candidates)
+            {
+                // Decoded again rather than kept: holding every image's pixels would not fit a whole content tree
+                FPending& Canonical = Pending[Candidate];
+                int32 OtherWidth = 0;
+                int32 OtherHeight = 0;
+                uint8* OtherPixels = WebPDecodeBGRA(Canonical.Bytes.GetData(), Canonical.Bytes.Num(), &OtherWidth, &OtherHeight);
+                const bool bSame = OtherPixels && OtherWidth == Width && OtherHeight == Height
+                    && FMemory::Memcmp(OtherPixels, Pixels, PixelBytes) == 0;
+                WebPFree(OtherPixels);
+                if (!bSame)
+                {
+                    continue;
+                }
+
+                if (Bytes.Num() < Canonical.Bytes.Num())
+                {
+                    // Same pixels in fewer bytes: this encoding becomes the shared blob
+                    Canonical.Bytes = Bytes;
+                    Canonical.Flags = Flags;
+                    ContentHashToIndex.Add(ContentHash, Candidate);
+                }
+                bOutPixelMatch = true;
+                return Candidate;
+            }
+            PixelHashToIndex.Add(PixelHash, Pending.Num());
+        }
+    }
+
+    ContentHashToIndex.Add(ContentHash, Pending.Num());
+    return INDEX_NONE;
+}
+
+FWebPBundleBuilder::FDedupeReport FWebPBundleBuilder::GetDedupeReport() const
+{
+    FDedupeReport Report;
+    Report.Entries = Pending.Num();
+    for (const FPending& Entry : Pending)
+    {
+        Report.SourceBytes += Entry.SourceBytes;
+        if (Entry.CanonicalIndex == INDEX_NONE)
+        {
+            ++Report.UniqueBlobs;
+            Report.BlobBytes += Entry.Bytes.Num();
+            continue;
+        }
+
+        ++(Entry.bPixelMatch ? Report.PixelDuplicates : Report.ByteDuplicates);
+        FDuplicate& Duplicate = Report.Duplicates.AddDefaulted_GetRef();
+        Duplicate.Name = Entry.Name;
+        Duplicate.CanonicalName = Pending[Entry.CanonicalIndex].Name;
+        Duplicate.SourceBytes = Entry.SourceBytes;
+        Duplicate.bPixelMatch = Entry.bPixelMatch;
+    }
+    Report.Duplicates.Sort([](const FDuplicate& A, const FDuplicate& B) { return A.Name < B.Name; });
+    return Report;
+}
+
+FWebPBundleBuilder::FTrimReport FWebPBundleBuilder::GetTrimReport() const
+{
+    FTrimReport Report;
+    for (const FPending& Entry : Pending)
+    {
+        Report.CanvasPixels += (int64)Entry.Placement.CanvasWidth * Entry.Placement.CanvasHeight;
+        Report.StoredPixels += (int64)Entry.Width * Entry.Height;
+        if (Entry.Width != Entry.Placement.CanvasWidth || Entry.Height != Entry.Placement.CanvasHeight)
+        {
+            ++Report.Trimmed;
+        }
+    }
+    return Report;
+}
+
+bool FWebPBundleBuilder::AddFile(const FString& Name, const FString& InFilename, FString* OutError)
+{
+    TArray64<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *InFilename))
+    {
+        if (OutError) { *OutError = FString::Printf(TEXT("Failed to read %s"), *InFilename); }
+        return false;
+    }
+    return Add(Name, MoveTemp(Bytes), OutError);
+}
+
+bool FWebPBundleBuilder::Write(const FString& InFilename, FString* OutError) const
+{
+    TArray<const FPending*> Sorted;
+    Sorted.Reserve(Pending.Num());
+    for (const FPending& Entry : Pending)
+    {
+        Sorted.Add(&Entry);
+    }
+    Sorted.Sort([](const FPending& A, const FPending& B) { return A.Hash < B.Hash; });
+
+    // Name table
+    TArray<uint8> Names;
+    TArray<TPair<uint32, uint32>> NameRanges;
+    for (const FPending* Entry : Sorted)
+    {
+        const FTCHARToUTF8 Utf8(*Entry->Name);
+        NameRanges.Emplace(Names.Num(), Utf8.Length());
+        Names.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+    }
+
+    // Placement table only when something was trimmed, so untrimmed bundles stay byte-identical to before
+    const bool bHasPlacements = Pending.ContainsByPredicate([](const FPending& Entry)
+    {
+        return Entry.Width != Entry.Placement.CanvasWidth || Entry.Height != Entry.Placement.CanvasHeight;
+    });
+
+    FWebPBundleHeader Header = {};
+    Header.Magic = WebPBundle::Magic;
+    Header.Version = bHasPlacements ? WebPBundle::PlacementsVersion : WebPBundle::MinVersion;
+    Header.EntryCount = Sorted.Num();
+    Header.Flags = (uint32)(bHasPlacements ? EWebPBundleFlags::HasPlacements : EWebPBundleFlags::None);
+    Header.IndexOffset = sizeof(FWebPBundleHeader);
+    const uint64 PlacementsOffset = Header.IndexOffset + (uint64)Sorted.Num() * sizeof(FWebPBundleEntry);
+    Header.NamesOffset = PlacementsOffset + (bHasPlacements ? (uint64)Sorted.Num() * sizeof(FWebPBundlePlacement) : 0);
+    Header.NamesSize = Names.Num();
+    Header.DataOffset = Align(Header.NamesOffset + Header.NamesSize, (uint64)WebPBundle::BlobAlignment);
+
+    // Blobs in index order; duplicates get no blob of their own
+    TArray<uint64> BlobOffsets;
+    BlobOffsets.Init(0, Pending.Num());
+    uint64 DataEnd = Header.DataOffset;
+    for (const FPending* Source : Sorted)
+    {
+        if (Source->CanonicalIndex == INDEX_NONE)
+        {
+            BlobOffsets[UE_PTRDIFF_TO_INT32(Source - Pending.GetData())] = DataEnd;
+            DataEnd = Align(DataEnd + Source->Bytes.Num(), (uint64)WebPBundle::BlobAlignment);
+        }
+    }
+
+    TArray<FWebPBundleEntry> Index;
+    Index.SetNumZeroed(Sorted.Num());
+    TArray<FWebPBundlePlacement> Placements;
+    for (int32 EntryIndex = 0; EntryIndex < Sorted.Num(); ++EntryIndex)
+    {
+        const FPending& Source = *Sorted[EntryIndex];
+        Placements.Add(Source.Placement);
+        const int32 BlobIndex = Source.CanonicalIndex != INDEX_NONE ? Source.CanonicalIndex : UE_PTRDIFF_TO_INT32(&Source - Pending.GetData());
+        const FPending& Blob = Pending[BlobIndex];
+        FWebPBundleEntry& Entry = Index[EntryIndex];
+        Entry.NameHash = Source.Hash;
+        Entry.DataOffset = BlobOffsets[BlobIndex];
+        Entry.DataSize = (uint32)Blob.Bytes.Num();
+        Entry.Width = Blob.Width;
+        Entry.Height = Blob.Height;
+        Entry.Flags = (uint32)Blob.Flags;
+        Entry.NameOffset = NameRanges[EntryIndex].Key;
+        Entry.NameLength = NameRanges[EntryIndex].Value;
+    }
+
+    TArray64<uint8> Output;
+    Output.SetNumZeroed(DataEnd);
+    FMemory::Memcpy(Output.GetData(), &Header, sizeof(Header));
+    FMemory::Memcpy(Output.GetData() + Header.IndexOffset, Index.GetData(), Index.Num() * sizeof(FWebPBundleEntry));
+    if (bHasPlacements)
+    {
+        FMemory::Memcpy(Output.GetData() + PlacementsOffset, Placements.GetData(), Placements.Num() * sizeof(FWebPBundlePlacement));
+    }
+    FMemory::Memcpy(Output.GetData() + Header.NamesOffset, Names.GetData(), Names.Num());
+    for (int32 BlobIndex = 0; BlobIndex < Pending.Num(); ++BlobIndex)
+    {
+        if (Pending[BlobIndex].CanonicalIndex == INDEX_NONE)
+        {
+            FMemory::Memcpy(Output.GetData() + BlobOffsets[BlobIndex], Pending[BlobIndex].Bytes.GetData(), Pending[BlobIndex].Bytes.Num());
+        }
+    }
+
+    if (!FFileHelper::SaveArrayToFile(Output, *InFilename))
+    {
+        if (OutError) { *OutError = FString::Printf(TEXT("Failed to write %s"), *InFilename); }
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,430 @@
+// WebPCodecBenchmarks.cpp
+// Decode / encode throughput of FWebpImageWrapper over synthetic content. Registered with FWebPBenchmarkRegistry,
+// run via the WebPBenchmark commandlet or the "Perf" automation tests.
+#include "WebPBenchmark.h"
+#include "WebPSyntheticImage.h"
+#include "WebpImageWrapper.h"
+#include "WebPIncrementalDecoder.h"
+#include "HAL/PlatformTime.h"
+
+#if WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
+
+namespace WebPCodecBenchmarks
+{
+    struct FSize { int32 Width; int32 Height; };
+
+    static TArray<FSize> GetSizes(const FWebPBenchmarkContext& Context)
+    {
+        if (Context.bQuick)
+        {
+            return { { 256, 256 }, { 1280, 720 } };
+        }
+        // Icon/sprite part, 720p UI, 1080p background, 4K CG
+        return { { 256, 256 }, { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } };
+    }
+
+    static TArray<EWebPSyntheticContent> GetContents(const FWebPBenchmarkContext& Context)
+    {
+        if (Context.bQuick)
+        {
+            return { EWebPSyntheticContent::Photo, EWebPSyntheticContent::Sprite };
+        }
+        return { EWebPSyntheticContent::Flat, EWebPSyntheticContent::Gradient, EWebPSyntheticContent::Noise,
+                 EWebPSyntheticContent::Photo, EWebPSyntheticContent::Sprite };
+    }
+
+    static const TCHAR* FormatName(ERGBFormat Format)
+    {
+        return Format == ERGBFormat::RGBA ? TEXT("rgba8") : TEXT("bgra8");
+    }
+
+    // Encodes the synthetic image once so the decode suite measures decoding only
+    static void RunDecode(FWebPBenchmarkContext& Context)
+    {
+        const ERGBFormat Formats[] = { ERGBFormat::BGRA, ERGBFormat::RGBA };
+        const bool ThreadSettings[] = { false, true };
+        const bool LosslessSettings[] = { false, true };
+
+        for (const FSize& Size : GetSizes(Context))
+        {
+            for (EWebPSyntheticContent Content : GetContents(Context))
+            {
+                TArray64<uint8> Pixels;
+                FWebPSyntheticImage::Generate(Size.Width, Size.Height, Content, 1234, Pixels);
+
+                for (bool bLossless : LosslessSettings)
+                {
+                    const TArray64<uint8> Compressed = FWebPSyntheticImage::Encode(Pixels.GetData(), Size.Width, Size.Height, 80, bLossless);
+                    if (Compressed.Num() == 0)
+                    {
+                        continue;
+                    }
+
+                    for (ERGBFormat Format : Formats)
+                    {
+                        for (bool bThreads : ThreadSettings)
+                        {
+                            const FString Case = FString::Printf(TEXT("%dx%d %s %s %s threads=%d"), Size.Width, Size.Height,
+                                FWebPSyntheticImage::ToString(Content), bLossless ? TEXT("lossless") : TEXT("lossy"), FormatName(Format), bThreads ? 1 : 0);
+
+                            FWebPBenchmarkResult& Result = Context.AddResult(TEXT("Decode"), Case);
+                            Result.AddSizeParams(Size.Width, Size.Height);
+                            Result.Params.Add(TEXT("content"), FWebPSyntheticImage::ToString(Content));
+                            Result.Params.Add(TEXT("alpha"), FWebPSyntheticImage::HasAlpha(Content) ? TEXT("true") : TEXT("false"));
+                            Result.Params.Add(TEXT("bitstream"), bLossless ? TEXT("lossless") : TEXT("lossy"));
+                            Result.Params.Add(TEXT("format"), FormatName(Format));
+                            Result.Params.Add(TEXT("threads"), bThreads ? TEXT("true") : TEXT("false"));
+                            Result.BytesPerIteration = (int64)Size.Width * Size.Height * 4;
+                            Result.Metrics.Add(TEXT("compressed_bytes"), (double)Compressed.Num());
+
+                            FWebPDecodeOptions DecodeOptions;
+                            DecodeOptions.bUseThreads = bThreads;
+
+                            Context.Measure(Result, [&]()
+                            {
+                                // Fresh wrapper per iteration: SetCompressed + decode is what a loader pays per image
+                                FWebpImageWrapper Wrapper;
+                                Wrapper.SetDecodeOptions(DecodeOptions);
+                                TArray64<uint8> Decoded;
+                                if (Wrapper.SetCompressed(Compressed.GetData(), Compressed.Num()))
+                                {
+                                    Wrapper.GetRaw(Format, 8, Decoded);
+                                }
+                            });
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    static void RunEncode(FWebPBenchmarkContext& Context)
+    {
+        struct FEncodeSetting { const TCHAR* Name; int32 Quality; int32 Method; bool bLossless; };
+        const FEncodeSetting Settings[] = {
+            { TEXT("lossy-q80-m0"), 80, 0, false },
+            { TEXT("lossy-q80-m4"), 80, 4, false },
+            { TEXT("lossless-m4"), 75, 4, true },
+        };
+        const bool ThreadSettings[] = { false, true };
+
+        for (const FSize& Size : GetSizes(Context))
+        {
+            for (EWebPSyntheticContent Content : GetContents(Context))
+            {
+                TArray64<uint8> Pixels;
+                FWebPSyntheticImage::Generate(Size.Width, Size.Height, Content, 1234, Pixels);
+
+                for (const FEncodeSetting& Setting : Settings)
+                {
+                    for (bool bThreads : ThreadSettings)
+                    {
+                        const FString Case = FString::Printf(TEXT("%dx%d %s %s threads=%d"), Size.Width, Size.Height,
+                            FWebPSyntheticImage::ToString(Content), Setting.Name, bThreads ? 1 : 0);
+
+                        FWebPBenchmarkResult& Result = Context.AddResult(TEXT("Encode"), Case);
+                        Result.AddSizeParams(Size.Width, Size.Height);
+                        Result.Params.Add(TEXT("content"), FWebPSyntheticImage::ToString(Content));
+                        Result.Params.Add(TEXT("alpha"), FWebPSyntheticImage::HasAlpha(Content) ? TEXT("true") : TEXT("false"));
+                        Result.Params.Add(TEXT("setting"), Setting.Name);
+                        Result.Params.Add(TEXT("format"), FormatName(ERGBFormat::BGRA));
+                        Result.Params.Add(TEXT("threads"), bThreads ? TEXT("true") : TEXT("false"));
+                        Result.BytesPerIteration = Pixels.Num();
+
+                        FWebPEncodeOptions EncodeOptions;
+                        EncodeOptions.Method = Setting.Method;
+                        EncodeOptions.bUseThreads = bThreads;
+                        EncodeOptions.bLossless = Setting.bLossless;
+
+                        int64 CompressedBytes = 0;
+                        Context.Measure(Result, [&]()
+                        {
+                            FWebpImageWrapper Wrapper;
+                            Wrapper.SetEncodeOptions(EncodeOptions);
+                            if (Wrapper.SetRaw(Pixels.GetData(), Pixels.Num(), Size.Width, Size.Height, ERGBFormat::BGRA, 8))
+                            {
+                                CompressedBytes = Wrapper.GetCompressed(Setting.Quality).Num();
+                            }
+                        });
+                        Result.Metrics.Add(TEXT("compressed_bytes"), (double)CompressedBytes);
+                    }
+                }
+            }
+        }
+    }
+
+    // Texture path: decode into RawData then copy into the mip, versus decoding straight into the (pre-locked) mip
+    static void RunDecodeInto(FWebPBenchmarkContext& Context)
+    {
+        for (const FSize& Size : GetSizes(Context))
+        {
+            TArray64<uint8> Pixels;
+            FWebPSyntheticImage::Generate(Size.Width, Size.Height, EWebPSyntheticContent::Photo, 1234, Pixels);
+            const TArray64<uint8> Compressed = FWebPSyntheticImage::Encode(Pixels.GetData(), Size.Width, Size.Height, 80, false);
+            if (Compressed.Num() == 0)
+            {
+                continue;
+            }
+
+            // Stands in for the texture's mip memory
+            const int64 MipStride = (int64)Size.Width * 4;
+            TArray64<uint8> Mip;
+            Mip.SetNumUninitialized(MipStride * Size.Height);
+
+            const bool DirectSettings[] = { false, true };
+            for (bool bDirect : DirectSettings)
+            {
+                FWebPBenchmarkResult& Result = Context.AddResult(TEXT("DecodeInto"),
+                    FString::Printf(TEXT("%dx%d %s"), Size.Width, Size.Height, bDirect ? TEXT("direct") : TEXT("raw+copy")));
+                Result.AddSizeParams(Size.Width, Size.Height);
+                Result.Params.Add(TEXT("path"), bDirect ? TEXT("direct") : TEXT("raw+copy"));
+                Result.BytesPerIteration = Mip.Num();
+
+                Context.Measure(Result, [&]()
+                {
+                    FWebpImageWrapper Wrapper;
+                    if (!Wrapper.SetCompressed(Compressed.GetData(), Compressed.Num()))
+                    {
+                        return;
+                    }
+                    if (bDirect)
+                    {
+                        Wrapper.DecodeInto(ERGBFormat::BGRA, 8, Mip.GetData(), MipStride, Mip.Num());
+                    }
+                    else
+                    {
+                        TArray64<uint8> Decoded;
+                        if (Wrapper.ReleaseRaw(ERGBFormat::BGRA, 8, Decoded))
+                        {
+                            FMemory::Memcpy(Mip.GetData(), Decoded.GetData(), Mip.Num());
+                        }
+                    }
+                });
+            }
+        }
+    }
+
+    // Incremental decode in 64 KB steps: time until the first 64-row band is final (what a progressive upload can
+    // show) and the overhead of the whole incremental decode against a one-shot decode of the same image.
+    // Capture path: encoding a padded readback (rows wider than the image) by copying it into RawData first (SetRaw)
+    // versus importing straight from the caller's rows (SetRawView)
+    static void RunEncodeView(FWebPBenchmarkContext& Context)
+    {
+        for (const FSize& Size : GetSizes(Context))
+        {
+            TArray64<uint8> Pixels;
+            FWebPSyntheticImage::Generate(Size.Width, Size.Height, EWebPSyntheticContent::Photo, 1234, Pixels);
+
+            // Stands in for a GPU readback with a 256-byte row pitch alignment
+            const int64 RowBytes = (int64)Size.Width * 4;
+            const int64 Stride = Align(RowBytes + 1, 256);
+            TArray64<uint8> Readback;
+            Readback.SetNumZeroed(Stride * Size.Height);
+            for (int32 Row = 0; Row < Size.Height; ++Row)
+            {
+                FMemory::Memcpy(Readback.GetData() + Row * Stride, Pixels.GetData() + Row * RowBytes, RowBytes);
+            }
+
+            FWebPEncodeOptions EncodeOptions;
+            EncodeOptions.Method = 0; // Fastest setting, where the ingest copy weighs most
+
+            const bool ViewSettings[] = { false, true };
+            for (bool bView : ViewSettings)
+            {
+                FWebPBenchmarkResult& Result = Context.AddResult(TEXT("EncodeView"),
+                    FString::Printf(TEXT("%dx%d %s"), Size.Width, Size.Height, bView ? TEXT("view") : TEXT("copy")));
+                Result.AddSizeParams(Size.Width, Size.Height);
+                Result.Params.Add(TEXT("path"), bView ? TEXT("view") : TEXT("copy"));
+                Result.BytesPerIteration = RowBytes * Size.Height;
+
+                Context.Measure(Result, [&]()
+                {
+                    FWebpImageWrapper Wrapper;
+                    Wrapper.SetEncodeOptions(EncodeOptions);
+                    const bool bSet = bView
+                        ? Wrapper.SetRawView(Readback.GetData(), Readback.Num(), Size.Width, Size.Height, ERGBFormat::BGRA, 8, (int32)Stride)
+                        : Wrapper.SetRaw(Readback.GetData(), Readback.Num(), Size.Width, Size.Height, ERGBFormat::BGRA, 8, (int32)Stride);
+                    if (bSet)
+                    {
+                        Wrapper.GetCompressed(80);
+                    }
+                });
+            }
+        }
+    }
+
+    // Save-slot thumbnails: encoding the whole capture with default settings versus rescaling it inside libwebp
+    // (ARGB, before the YUV conversion) and encoding at method 0, as FVNScreenshotEncoder does
+    static void RunThumbnail(FWebPBenchmarkContext& Context)
+    {
+        const FSize Capture = Context.bQuick ? FSize{ 1280, 720 } : FSize{ 1920, 1080 };
+        TArray64<uint8> Pixels;
+        FWebPSyntheticImage::Generate(Capture.Width, Capture.Height, EWebPSyntheticContent::Photo, 1234, Pixels);
+
+        struct FSetting { const TCHAR* Name; int32 Method; int32 ThumbnailWidth; };
+        const FSetting Settings[] = {
+            { TEXT("full-m4"), 4, 0 },
+            { TEXT("thumb320-m4"), 4, 320 },
+            { TEXT("thumb320-m0"), 0, 320 },
+        };
+        for (const FSetting& Setting : Settings)
+        {
+            FWebPBenchmarkResult& Result = Context.AddResult(TEXT("Thumbnail"),
+                FString::Printf(TEXT("%dx%d %s"), Capture.Width, Capture.Height, Setting.Name));
+            Result.AddSizeParams(Capture.Width, Capture.Height);
+            Result.Params.Add(TEXT("setting"), Setting.Name);
+            Result.BytesPerIteration = Pixels.Num();
+
+            FWebPEncodeOptions EncodeOptions;
+            EncodeOptions.Method = Setting.Method;
+            EncodeOptions.bIgnoreAlpha = true;
+            if (Setting.ThumbnailWidth > 0)
+            {
+                EncodeOptions.ScaledWidth = Setting.ThumbnailWidth;
+                EncodeOptions.ScaledHeight = FMath::Max(1, Capture.Height * Setting.ThumbnailWidth / Capture.Width);
+            }
+
+            int64 CompressedBytes = 0;
+            Context.Measure(Result, [&]()
+            {
+                FWebpImageWrapper Wrapper;
+                Wrapper.SetEncodeOptions(EncodeOptions);
+                if (Wrapper.SetRawView(Pixels.GetData(), Pixels.Num(), Capture.Width, Capture.Height, ERGBFormat::BGRA, 8))
+                {
+                    CompressedBytes = Wrapper.GetCompressed(70).Num();
+                }
+            });
+            Result.Metrics.Add(TEXT("compressed_bytes"), (double)CompressedBytes);
+        }
+    }
+
+    static void RunIncremental(FWebPBenchmarkContext& Context)
+    {
+        const int64 ChunkBytes = 64 * 1024;
+        const int32 BandRows = 64;
+
+        for (const FSize& Size : GetSizes(Context))
+        {
+            TArray64<uint8> Pixels;
+            FWebPSyntheticImage::Generate(Size.Width, Size.Height, EWebPSyntheticContent::Photo, 1234, Pixels);
+            const TArray64<uint8> Compressed = FWebPSyntheticImage::Encode(Pixels.GetData(), Size.Width, Size.Height, 90, false);
+            if (Compressed.Num() == 0)
+            {
+                continue;
+            }
+
+            const int64 Stride = (int64)Size.Width * 4;
+            TArray64<uint8> Output;
+            Output.SetNumUninitialized(Stride * Size.Height);
+
+            const bool IncrementalSettings[] = { false, true };
+            for (bool bIncremental : IncrementalSettings)
+            {
+                FWebPBenchmarkResult& Result = Context.AddResult(TEXT("Incremental"),
+                    FString::Printf(TEXT("%dx%d %s"), Size.Width, Size.Height, bIncremental ? TEXT("incremental") : TEXT("one-shot")));
+                Result.AddSizeParams(Size.Width, Size.Height);
+                Result.Params.Add(TEXT("mode"), bIncremental ? TEXT("incremental") : TEXT("one-shot"));
+                Result.BytesPerIteration = Output.Num();
+                Result.Metrics.Add(TEXT("compressed_bytes"), (double)Compressed.Num());
+
+                double FirstBandTotal = 0.0;
+                int32 FirstBandSamples = 0;
+                Context.Measure(Result, [&]()
+                {
+                    const double Start = FPlatformTime::Seconds();
+                    if (!bIncremental)
+                    {
+                        FWebpImageWrapper Wrapper;
+                        if (Wrapper.SetCompressedView(Compressed.GetData(), Compressed.Num()))
+                        {
+                            Wrapper.DecodeInto(ERGBFormat::BGRA, 8, Output.GetData(), Stride, Output.Num());
+                        }
+                        FirstBandTotal += FPlatformTime::Seconds() - Start; // Nothing to show before the end
+                        ++FirstBandSamples;
+                        return;
+                    }
+
+                    FWebPIncrementalDecoder Decoder;
+                    if (!Decoder.Begin(ERGBFormat::BGRA, FWebPDecodeOptions(), Output.GetData(), Stride, Output.Num()))
+                    {
+                        return;
+                    }
+                    bool bFirstBand = false;
+                    for (int64 Available = FMath::Min(ChunkBytes, (int64)Compressed.Num()); ; Available = FMath::Min(Available + ChunkBytes, (int64)Compressed.Num()))
+                    {
+                        const FWebPIncrementalDecoder::EStatus Status = Decoder.Update(Compressed.GetData(), Available);
+                        if (!bFirstBand && (Status == FWebPIncrementalDecoder::EStatus::Done || Decoder.GetDecodedRows() >= BandRows))
+                        {
+                            bFirstBand = true;
+                            FirstBandTotal += FPlatformTime::Seconds() - Start;
+                            ++FirstBandSamples;
+                        }
+                        if (Status != FWebPIncrementalDecoder::EStatus::NeedMoreData || Available == Compressed.Num())
+                        {
+                            break;
+                        }
+                    }
+                });
+                Result.Metrics.Add(TEXT("first_band_ms"), FirstBandSamples > 0 ? FirstBandTotal / FirstBandSamples * 1000.0 : 0.0);
+            }
+        }
+    }
+
+    // Preview cost: decoder-side downscale to a few preview sizes against the full-size decode
+    static void RunPreview(FWebPBenchmarkContext& Context)
+    {
+        const int32 PreviewSizes[] = { 0, 320, 160, 64 }; // Longer side; 0 = full size
+
+        for (const FSize& Size : GetSizes(Context))
+        {
+            TArray64<uint8> Pixels;
+            FWebPSyntheticImage::Generate(Size.Width, Size.Height, EWebPSyntheticContent::Photo, 1234, Pixels);
+            const TArray64<uint8> Compressed = FWebPSyntheticImage::Encode(Pixels.GetData(), Size.Width, Size.Height, 80, false);
+            if (Compressed.Num() == 0)
+            {
+                continue;
+            }
+
+            for (int32 MaxDimension : PreviewSizes)
+            {
+                FWebPDecodeOptions DecodeOptions;
+                const int32 LongSide = FMath::Max(Size.Width, Size.Height);
+                if (MaxDimension > 0 && MaxDimension < LongSide)
+                {
+                    DecodeOptions.ScaledWidth = FMath::Max(1, Size.Width * MaxDimension / LongSide);
+                    DecodeOptions.ScaledHeight = FMath::Max(1, Size.Height * MaxDimension / LongSide);
+                }
+                const FIntPoint OutSize = DecodeOptions.GetOutputSize(Size.Width, Size.Height);
+                TArray64<uint8> Output;
+                Output.SetNumUninitialized((int64)OutSize.X * OutSize.Y * 4);
+
+                FWebPBenchmarkResult& Result = Context.AddResult(TEXT("Preview"),
+                    FString::Printf(TEXT("%dx%d -> %dx%d"), Size.Width, Size.Height, OutSize.X, OutSize.Y));
+                Result.AddSizeParams(Size.Width, Size.Height);
+                Result.Params.Add(TEXT("out_width"), LexToString(OutSize.X));
+                Result.Params.Add(TEXT("out_height"), LexToString(OutSize.Y));
+                Result.BytesPerIteration = Output.Num();
+
+                Context.Measure(Result, [&]()
+                {
+                    FWebpImageWrapper Wrapper;
+                    Wrapper.SetDecodeOptions(DecodeOptions);
+                    if (Wrapper.SetCompressedView(Compressed.GetData(), Compressed.Num()))
+                    {
+                        Wrapper.DecodeInto(ERGBFormat::BGRA, 8, Output.GetData(), (int64)OutSize.X * 4, Output.Num());
+                    }
+                });
+            }
+        }
+    }
+
+    static FWebPBenchmarkSuiteRegistrar DecodeSuite(TEXT("Decode"), &RunDecode);
+    static FWebPBenchmarkSuiteRegistrar EncodeSuite(TEXT("Encode"), &RunEncode);
+    static FWebPBenchmarkSuiteRegistrar DecodeIntoSuite(TEXT("DecodeInto"), &RunDecodeInto);
+    static FWebPBenchmarkSuiteRegistrar EncodeViewSuite(TEXT("EncodeView"), &RunEncodeView);
+    static FWebPBenchmarkSuiteRegistrar ThumbnailSuite(TEXT("Thumbnail"), &RunThumbnail);
+    static FWebPBenchmarkSuiteRegistrar IncrementalSuite(TEXT("Incremental"), &RunIncremental);
+    static FWebPBenchmarkSuiteRegistrar PreviewSuite(TEXT("Preview"), &RunPreview);
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
@@ -0,0 +1,95 @@
+// WebPDspBenchmarks.cpp
+// libwebp's own SIMD kernels: decode/encode through whatever DSP dispatch this process runs with. libwebp picks its
+// kernels once per process (WEBP_DSP_INIT_FUNC under pthread_once with WEBP_USE_THREAD), so C and SIMD can't be
+// compared inside one run: run the suite twice and compare the reports,
+//   UnrealEditor-Cmd VNM -run=WebPBenchmark -Suite=LibWebPSimd -Output=simd.json
+//   UnrealEditor-Cmd VNM -run=WebPBenchmark -Suite=LibWebPSimd -Output=c.json -WebPNoAsm
+// -WebPNoAsm clears the dispatch at module startup, before any libwebp call (FWebPImageSupportModule).
+#include "WebPBenchmark.h"
+#include "WebPSimd.h"
+#include "WebPSyntheticImage.h"
+#include "WebpImageWrapper.h"
+
+#if WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
+
+namespace WebPDspBenchmarks
+{
+    struct FSize { int32 Width; int32 Height; };
+
+    static void Run(FWebPBenchmarkContext& Context)
+    {
+        const TArray<FSize> Sizes = Context.bQuick
+            ? TArray<FSize>{ { 1280, 720 } }
+            : TArray<FSize>{ { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } };
+        const EWebPSyntheticContent Contents[] = { EWebPSyntheticContent::Photo, EWebPSyntheticContent::Sprite };
+        const bool LosslessSettings[] = { false, true };
+        const TCHAR* DispatchName = FParse::Param(FCommandLine::Get(), TEXT("WebPNoAsm")) ? TEXT("c") : TEXT("simd");
+
+        for (const FSize& Size : Sizes)
+        {
+            for (EWebPSyntheticContent Content : Contents)
+            {
+                TArray64<uint8> Pixels;
+                FWebPSyntheticImage::Generate(Size.Width, Size.Height, Content, 1234, Pixels);
+
+                for (bool bLossless : LosslessSettings)
+                {
+                    FWebPEncodeOptions EncodeOptions;
+                    EncodeOptions.bLossless = bLossless;
+
+                    // Fixed content and settings, so the bitstream is the same in the C and the SIMD process
+                    const TArray64<uint8> Compressed = FWebPSyntheticImage::Encode(Pixels.GetData(), Size.Width, Size.Height, 80, bLossless);
+                    if (Compressed.Num() == 0)
+                    {
+                        continue;
+                    }
+
+                    const TCHAR* BitstreamName = bLossless ? TEXT("lossless") : TEXT("lossy");
+
+                    auto AddCommonParams = [&](FWebPBenchmarkResult& Result)
+                    {
+                        Result.AddSizeParams(Size.Width, Size.Height);
+                        Result.Params.Add(TEXT("content"), FWebPSyntheticImage::ToString(Content));
+                        Result.Params.Add(TEXT("bitstream"), BitstreamName);
+                        Result.Params.Add(TEXT("dispatch"), DispatchName);
+                        Result.Params.Add(TEXT("cpu"), WebPSimd::ToString(WebPSimd::GetBackend()));
+                        Result.BytesPerIteration = Pixels.Num();
+                    };
+
+                    FWebPBenchmarkResult& DecodeResult = Context.AddResult(TEXT("LibWebPSimd"), FString::Printf(TEXT("decode %dx%d %s %s"),
+                        Size.Width, Size.Height, FWebPSyntheticImage::ToString(Content), BitstreamName));
+                    AddCommonParams(DecodeResult);
+                    DecodeResult.Params.Add(TEXT("op"), TEXT("decode"));
+                    DecodeResult.Metrics.Add(TEXT("compressed_bytes"), (double)Compressed.Num());
+                    Context.Measure(DecodeResult, [&]()
+                    {
+                        FWebpImageWrapper Wrapper;
+                        TArray64<uint8> Decoded;
+                        if (Wrapper.SetCompressed(Compressed.GetData(), Compressed.Num()))
+                        {
+                            Wrapper.GetRaw(ERGBFormat::BGRA, 8, Decoded);
+                        }
+                    });
+
+                    FWebPBenchmarkResult& EncodeResult = Context.AddResult(TEXT("LibWebPSimd"), FString::Printf(TEXT("encode %dx%d %s %s"),
+                        Size.Width, Size.Height, FWebPSyntheticImage::ToString(Content), BitstreamName));
+                    AddCommonParams(EncodeResult);
+                    EncodeResult.Params.Add(TEXT("op"), TEXT("encode"));
+                    Context.Measure(EncodeResult, [&]()
+                    {
+                        FWebpImageWrapper Wrapper;
+                        Wrapper.SetEncodeOptions(EncodeOptions);
+                        if (Wrapper.SetRaw(Pixels.GetData(), Pixels.Num(), Size.Width, Size.Height, ERGBFormat::BGRA, 8))
+                        {
+                            Wrapper.GetCompressed(80);
+                        }
+                    });
+                }
+            }
+        }
+    }
+
+    static FWebPBenchmarkSuiteRegistrar LibWebPSimdSuite(TEXT("LibWebPSimd"), &Run);
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
@@ -0,0 +1,82 @@
+// WebPGray.cpp
+#include "WebPGray.h"
+
+namespace WebPGray
+{
+    static void ExpandLumaRowScalar(uint8* Row, int32 NumPixels)
+    {
+        for (int32 Index = 0; Index < NumPixels; ++Index)
+        {
+            const uint32 Y = (uint32)FMath::Clamp((int32)Row[Index] - 16, 0, 219);
+            Row[Index] = (uint8)((Y * 298 + 128) >> 8);
+        }
+    }
+
+#if WEBP_SIMD_AVX2
+    WEBP_TARGET_AVX2 static void ExpandLumaRowAVX2(uint8* Row, int32 NumPixels)
+    {
+        const __m256i Zero = _mm256_setzero_si256();
+        const __m256i Black = _mm256_set1_epi8(16);
+        const __m256i Range = _mm256_set1_epi8((char)219);
+        const __m256i Scale = _mm256_set1_epi16(298);
+        const __m256i Round = _mm256_set1_epi16(128);
+
+        int32 Index = 0;
+        for (; Index + 32 <= NumPixels; Index += 32)
+        {
+            const __m256i Y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Row + Index));
+            const __m256i D = _mm256_min_epu8(_mm256_subs_epu8(Y, Black), Range);
+
+            // At most 219 * 298 + 128 = 65390: fits unsigned 16-bit lanes
+            const __m256i Lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(D, Zero), Scale), Round), 8);
+            const __m256i Hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(D, Zero), Scale), Round), 8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(Row + Index), _mm256_packus_epi16(Lo, Hi));
+        }
+
+        ExpandLumaRowScalar(Row + Index, NumPixels - Index);
+    }
+#endif
+
+#if WEBP_SIMD_NEON
+    static void ExpandLumaRowNEON(uint8* Row, int32 NumPixels)
+    {
+        const uint8x8_t Black = vdup_n_u8(16);
+        const uint8x8_t Range = vdup_n_u8(219);
+
+        int32 Index = 0;
+        for (; Index + 8 <= NumPixels; Index += 8)
+        {
+            const uint8x8_t D = vmin_u8(vqsub_u8(vld1_u8(Row + Index), Black), Range);
+            // vrshrn: (x + 128) >> 8, narrowed
+            vst1_u8(Row + Index, vrshrn_n_u16(vmulq_n_u16(vmovl_u8(D), 298), 8));
+        }
+
+        ExpandLumaRowScalar(Row + Index, NumPixels - Index);
+    }
+#endif
+
+    void ExpandLumaRow(EWebPSimdBackend Backend, uint8* Row, int32 NumPixels)
+    {
+        switch (Backend)
+        {
+#if WEBP_SIMD_AVX2
+        case EWebPSimdBackend::AVX2:
+            ExpandLumaRowAVX2(Row, NumPixels);
+            return;
+#endif
+#if WEBP_SIMD_NEON
+        case EWebPSimdBackend::NEON:
+            ExpandLumaRowNEON(Row, NumPixels);
+            return;
+#endif
+        default:
+            ExpandLumaRowScalar(Row, NumPixels);
+            return;
+        }
+    }
+
+    void ExpandLumaRow(uint8* Row, int32 NumPixels)
+    {
+        ExpandLumaRow(WebPSimd::GetBackend(), Row, NumPixels);
+    }
+}
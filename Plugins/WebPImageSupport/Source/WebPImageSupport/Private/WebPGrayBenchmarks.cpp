@@ -0,0 +1,87 @@
+// WebPGrayBenchmarks.cpp
+// Single-channel images (transition rules, masks): the BGRA decode they used to go through against the Gray8 path
+// that keeps only the luma plane, for lossy and lossless sources, plus the luma range expansion per SIMD backend.
+#include "WebPBenchmark.h"
+#include "WebPBufferPool.h"
+#include "WebPGray.h"
+#include "WebPSimd.h"
+#include "WebPSyntheticImage.h"
+#include "WebpImageWrapper.h"
+
+#if WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
+
+namespace WebPGrayBenchmarks
+{
+    static void Run(FWebPBenchmarkContext& Context)
+    {
+        const FIntPoint Size = Context.bQuick ? FIntPoint(960, 540) : FIntPoint(1920, 1080);
+        TArray64<uint8> Pixels;
+        FWebPSyntheticImage::Generate(Size.X, Size.Y, EWebPSyntheticContent::Gradient, 7, Pixels);
+
+        const TArray<EWebPSimdBackend> Backends = WebPSimd::GetAvailableBackends();
+
+        TArray64<uint8> Luma;
+        Luma.SetNumUninitialized((int64)Size.X * Size.Y);
+        for (int64 Index = 0; Index < Luma.Num(); ++Index)
+        {
+            Luma[Index] = Pixels[Index * 4 + 1];
+        }
+        for (EWebPSimdBackend Backend : Backends)
+        {
+            FWebPBenchmarkResult& Result = Context.AddResult(TEXT("Gray"),
+                FString::Printf(TEXT("expand %dx%d %s"), Size.X, Size.Y, WebPSimd::ToString(Backend)));
+            Result.AddSizeParams(Size.X, Size.Y);
+            Result.Params.Add(TEXT("op"), TEXT("expand"));
+            Result.AddBackendParam(Backend);
+            Result.BytesPerIteration = Luma.Num();
+            Context.Measure(Result, [&]()
+            {
+                // Saturates after a few passes; the kernels are branch-free so the timing doesn't care
+                WebPGray::ExpandLumaRow(Backend, Luma.GetData(), (int32)Luma.Num());
+            });
+        }
+
+        for (const bool bLossless : { false, true })
+        {
+            const TArray64<uint8> Compressed = FWebPSyntheticImage::Encode(Pixels.GetData(), Size.X, Size.Y, 90, bLossless);
+            if (Compressed.Num() == 0)
+            {
+                continue;
+            }
+
+            struct FVariant { const TCHAR* Name; ERGBFormat Format; int32 BytesPerPixel; };
+            const FVariant Variants[] =
+            {
+                { TEXT("bgra"), ERGBFormat::BGRA, 4 },
+                { TEXT("gray"), ERGBFormat::Gray, 1 },
+            };
+            for (const FVariant& Variant : Variants)
+            {
+                const TCHAR* Source = bLossless ? TEXT("lossless") : TEXT("lossy");
+                FWebPBenchmarkResult& Result = Context.AddResult(TEXT("Gray"),
+                    FString::Printf(TEXT("decode %dx%d %s %s"), Size.X, Size.Y, Source, Variant.Name));
+                Result.AddSizeParams(Size.X, Size.Y);
+                Result.Params.Add(TEXT("op"), TEXT("decode"));
+                Result.Params.Add(TEXT("source"), Source);
+                Result.Params.Add(TEXT("output"), Variant.Name);
+                Result.BytesPerIteration = (int64)Size.X * Size.Y * Variant.BytesPerPixel;
+                Result.Metrics.Add(TEXT("output_bytes"), (double)Result.BytesPerIteration);
+                Result.Metrics.Add(TEXT("compressed_bytes"), (double)Compressed.Num());
+                Context.Measure(Result, [&]()
+                {
+                    FWebpImageWrapper Wrapper;
+                    TArray64<uint8> Decoded;
+                    if (Wrapper.SetCompressedView(Compressed.GetData(), Compressed.Num())
+                        && Wrapper.ReleaseRaw(Variant.Format, 8, Decoded))
+                    {
+                        FWebPBufferPool::Get().Release(Decoded);
+                    }
+                });
+            }
+        }
+    }
+
+    static FWebPBenchmarkSuiteRegistrar GraySuite(TEXT("Gray"), &Run);
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
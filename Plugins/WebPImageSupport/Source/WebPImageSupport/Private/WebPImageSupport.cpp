@@ -1,12 +1,28 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "WebPImageSupport.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+// From libwebp src/dsp/cpu.h (not a public header): the cpuid hook every DSP init function reads. Null selects the
+// plain C kernels, the same switch dwebp/cwebp use for -noasm.
+extern "C"
+{
+	typedef int (*VP8CPUInfo)(int Feature);
+	extern VP8CPUInfo VP8GetCPUInfo;
+}
 
 #define LOCTEXT_NAMESPACE "FWebPImageSupportModule"
 
 void FWebPImageSupportModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+
+	// libwebp initialises its kernels once per process, so this only works before the first decode/encode
+	if (FParse::Param(FCommandLine::Get(), TEXT("WebPNoAsm")))
+	{
+		VP8GetCPUInfo = nullptr;
+	}
 }
 
 void FWebPImageSupportModule::ShutdownModule()
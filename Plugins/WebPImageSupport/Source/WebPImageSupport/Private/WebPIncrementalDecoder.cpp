@@ -0,0 +1,126 @@
+// WebPIncrementalDecoder.cpp
+#include "WebPIncrementalDecoder.h"
+#include "WebpImageWrapper.h"
+#include "WebPStats.h"
+#include "WebPMemory.h"
+#include "webp/decode.h"
+
+struct FWebPIncrementalDecoder::FImpl
+{
+    // The decoder keeps pointers to Config.options and Config.output, so both live here next to it
+    WebPDecoderConfig Config;
+    WebPIDecoder* Decoder = nullptr;
+    bool bDone = false;
+};
+
+FWebPIncrementalDecoder::FWebPIncrementalDecoder() = default;
+
+FWebPIncrementalDecoder::~FWebPIncrementalDecoder()
+{
+    Reset();
+}
+
+bool FWebPIncrementalDecoder::Begin(ERGBFormat Format, const FWebPDecodeOptions& Options, uint8* OutPixels, int64 OutStride, int64 OutSize)
+{
+    Reset();
+
+    WEBP_CSP_MODE Mode = MODE_LAST;
+    if (Format == ERGBFormat::BGRA)
+    {
+        Mode = Options.bPremultiplyAlpha ? MODE_bgrA : MODE_BGRA;
+    }
+    else if (Format == ERGBFormat::RGBA)
+    {
+        Mode = Options.bPremultiplyAlpha ? MODE_rgbA : MODE_RGBA;
+    }
+    if (Mode == MODE_LAST || !OutPixels || OutStride <= 0 || OutStride > MAX_int32)
+    {
+        return false;
+    }
+
+    Impl = MakeUnique<FImpl>();
+    if (!WebPInitDecoderConfig(&Impl->Config))
+    {
+        Impl.Reset();
+        return false;
+    }
+
+    Impl->Config.options.use_threads = Options.bUseThreads ? 1 : 0;
+    Impl->Config.options.bypass_filtering = Options.bBypassFiltering ? 1 : 0;
+    Impl->Config.options.no_fancy_upsampling = Options.bNoFancyUpsampling ? 1 : 0;
+    if (Options.IsScaled())
+    {
+        Impl->Config.options.use_scaling = 1;
+        Impl->Config.options.scaled_width = Options.ScaledWidth;
+        Impl->Config.options.scaled_height = Options.ScaledHeight;
+    }
+
+    Impl->Config.output.colorspace = Mode;
+    Impl->Config.output.is_external_memory = 1;
+    Impl->Config.output.u.RGBA.rgba = OutPixels;
+    Impl->Config.output.u.RGBA.stride = (int)OutStride;
+    Impl->Config.output.u.RGBA.size = (size_t)OutSize;
+
+    LLM_SCOPE_BYTAG(WebP_Scratch);
+    Impl->Decoder = WebPIDecode(nullptr, 0, &Impl->Config);
+    if (!Impl->Decoder)
+    {
+        Impl.Reset();
+        return false;
+    }
+    return true;
+}
+
+FWebPIncrementalDecoder::EStatus FWebPIncrementalDecoder::Update(const uint8* Data, int64 Size)
+{
+    if (!Impl || !Impl->Decoder)
+    {
+        return EStatus::Error;
+    }
+    if (Impl->bDone)
+    {
+        return EStatus::Done;
+    }
+
+    WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_Decode);
+    LLM_SCOPE_BYTAG(WebP_Scratch);
+    const VP8StatusCode Status = WebPIUpdate(Impl->Decoder, Data, (size_t)Size);
+    if (Status == VP8_STATUS_OK)
+    {
+        Impl->bDone = true;
+        const int64 DecodedBytes = (int64)Impl->Config.output.width * Impl->Config.output.height * 4;
+        INC_DWORD_STAT(STAT_WebP_ImagesDecoded);
+        INC_DWORD_STAT_BY(STAT_WebP_CompressedBytes, Size);
+        INC_DWORD_STAT_BY(STAT_WebP_BytesDecoded, DecodedBytes);
+        TRACE_COUNTER_ADD(WebP_BytesDecoded, DecodedBytes);
+        return EStatus::Done;
+    }
+    return Status == VP8_STATUS_SUSPENDED ? EStatus::NeedMoreData : EStatus::Error;
+}
+
+int32 FWebPIncrementalDecoder::GetDecodedRows() const
+{
+    if (!Impl || !Impl->Decoder)
+    {
+        return 0;
+    }
+    int Left = 0;
+    int Top = 0;
+    int DecodedWidth = 0;
+    int DecodedHeight = 0;
+    // Returns null until the headers are parsed; DecodedHeight is then the last fully written row
+    if (WebPIDecodedArea(Impl->Decoder, &Left, &Top, &DecodedWidth, &DecodedHeight) == nullptr)
+    {
+        return 0;
+    }
+    return DecodedHeight;
+}
+
+void FWebPIncrementalDecoder::Reset()
+{
+    if (Impl && Impl->Decoder)
+    {
+        WebPIDelete(Impl->Decoder);
+    }
+    Impl.Reset();
+}
@@ -0,0 +1,115 @@
+// WebPMemory.cpp
+#include "WebPMemory.h"
+#include "HAL/IConsoleManager.h"
+
+LLM_DEFINE_TAG(WebP);
+LLM_DEFINE_TAG(WebP_Compressed, TEXT("Compressed"), TEXT("WebP"));
+LLM_DEFINE_TAG(WebP_Decoded, TEXT("Decoded"), TEXT("WebP"));
+LLM_DEFINE_TAG(WebP_Scratch, TEXT("Scratch"), TEXT("WebP"));
+LLM_DEFINE_TAG(WebP_TextureStaging, TEXT("TextureStaging"), TEXT("WebP"));
+
+FWebPMemoryTracker& FWebPMemoryTracker::Get()
+{
+    static FWebPMemoryTracker Tracker;
+    return Tracker;
+}
+
+void FWebPMemoryTracker::Register(const void* Key)
+{
+    FScopeLock Lock(&Mutex);
+    Entries.Add(Key);
+}
+
+void FWebPMemoryTracker::Unregister(const void* Key)
+{
+    FScopeLock Lock(&Mutex);
+    Entries.Remove(Key);
+}
+
+void FWebPMemoryTracker::SetOwner(const void* Key, const FString& Owner)
+{
+    FScopeLock Lock(&Mutex);
+    if (FEntry* Entry = Entries.Find(Key))
+    {
+        Entry->Owner = Owner;
+    }
+}
+
+void FWebPMemoryTracker::Update(const void* Key, int64 CompressedBytes, int64 RawBytes, int32 Width, int32 Height)
+{
+    FScopeLock Lock(&Mutex);
+    if (FEntry* Entry = Entries.Find(Key))
+    {
+        Entry->CompressedBytes = CompressedBytes;
+        Entry->RawBytes = RawBytes;
+        Entry->Width = Width;
+        Entry->Height = Height;
+    }
+}
+
+TArray<FWebPMemoryTracker::FEntry> FWebPMemoryTracker::GetEntries() const
+{
+    TArray<FEntry> Snapshot;
+    {
+        FScopeLock Lock(&Mutex);
+        Entries.GenerateValueArray(Snapshot);
+    }
+    Snapshot.Sort([](const FEntry& A, const FEntry& B)
+    {
+        return A.CompressedBytes + A.RawBytes > B.CompressedBytes + B.RawBytes;
+    });
+    return Snapshot;
+}
+
+int64 FWebPMemoryTracker::GetTotalBytes() const
+{
+    FScopeLock Lock(&Mutex);
+    int64 Total = 0;
+    for (const TPair<const void*, FEntry>& Pair : Entries)
+    {
+        Total += Pair.Value.CompressedBytes + Pair.Value.RawBytes;
+    }
+    return Total;
+}
+
+void FWebPMemoryTracker::Dump(FOutputDevice& Ar) const
+{
+    const TArray<FEntry> Snapshot = GetEntries();
+
+    // Per-owner totals first: that's what tells you which scene/system is over budget
+    TMap<FString, int64> ByOwner;
+    int64 TotalCompressed = 0;
+    int64 TotalRaw = 0;
+    for (const FEntry& Entry : Snapshot)
+    {
+        ByOwner.FindOrAdd(Entry.Owner.IsEmpty() ? TEXT("<unnamed>") : Entry.Owner) += Entry.CompressedBytes + Entry.RawBytes;
+        TotalCompressed += Entry.CompressedBytes;
+        TotalRaw += Entry.RawBytes;
+    }
+    ByOwner.ValueSort([](int64 A, int64 B) { return A > B; });
+
+    Ar.Logf(TEXT("WebP buffers: %d alive, %.2f MB compressed, %.2f MB decoded"),
+        Snapshot.Num(), TotalCompressed / (1024.0 * 1024.0), TotalRaw / (1024.0 * 1024.0));
+
+    Ar.Logf(TEXT("  By owner:"));
+    for (const TPair<FString, int64>& Owner : ByOwner)
+    {
+        Ar.Logf(TEXT("    %10.2f MB  %s"), Owner.Value / (1024.0 * 1024.0), *Owner.Key);
+    }
+
+    Ar.Logf(TEXT("  By buffer:"));
+    for (const FEntry& Entry : Snapshot)
+    {
+        Ar.Logf(TEXT("    %10.2f MB  (compressed %8lld, decoded %10lld)  %5dx%-5d  %s"),
+            (Entry.CompressedBytes + Entry.RawBytes) / (1024.0 * 1024.0), Entry.CompressedBytes, Entry.RawBytes,
+            Entry.Width, Entry.Height, Entry.Owner.IsEmpty() ? TEXT("<unnamed>") : *Entry.Owner);
+    }
+}
+
+static FAutoConsoleCommandWithOutputDevice GWebPDumpBuffersCommand(
+    TEXT("WebP.DumpBuffers"),
+    TEXT("Lists every alive FWebpImageWrapper buffer by size and owner."),
+    FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+    {
+        FWebPMemoryTracker::Get().Dump(Ar);
+    }));
@@ -0,0 +1,87 @@
+// WebPPacked.cpp
+#include "WebPPacked.h"
+
+namespace WebPPacked
+{
+    // Read as a little-endian word, libwebp's pairs are RGB565 byte-swapped and RGBA4444 with its nibbles in B A R G
+    // order: a left rotate by 8 / 4 bits gives the native layout. (WEBP_SWAP_16BITS_CSP builds would differ; ours
+    // don't define it.)
+    static int32 GetRotation(EWebPPackedFormat Format)
+    {
+        return Format == EWebPPackedFormat::RGB565 ? 8 : 4;
+    }
+
+    static void ToNativeRowScalar(uint8* Row, int32 NumPixels, int32 Rotation)
+    {
+        for (int32 Index = 0; Index < NumPixels; ++Index)
+        {
+            uint16 Word;
+            FMemory::Memcpy(&Word, Row + Index * 2, 2);
+            Word = (uint16)((Word << Rotation) | (Word >> (16 - Rotation)));
+            FMemory::Memcpy(Row + Index * 2, &Word, 2);
+        }
+    }
+
+#if WEBP_SIMD_AVX2
+    WEBP_TARGET_AVX2 static void ToNativeRowAVX2(uint8* Row, int32 NumPixels, int32 Rotation)
+    {
+        const __m128i Left = _mm_cvtsi32_si128(Rotation);
+        const __m128i Right = _mm_cvtsi32_si128(16 - Rotation);
+
+        int32 Index = 0;
+        for (; Index + 16 <= NumPixels; Index += 16)
+        {
+            __m256i* Ptr = reinterpret_cast<__m256i*>(Row + Index * 2);
+            const __m256i Words = _mm256_loadu_si256(Ptr);
+            _mm256_storeu_si256(Ptr, _mm256_or_si256(_mm256_sll_epi16(Words, Left), _mm256_srl_epi16(Words, Right)));
+        }
+
+        ToNativeRowScalar(Row + Index * 2, NumPixels - Index, Rotation);
+    }
+#endif
+
+#if WEBP_SIMD_NEON
+    static void ToNativeRowNEON(uint8* Row, int32 NumPixels, int32 Rotation)
+    {
+        // vshlq with a negative count shifts right
+        const int16x8_t Left = vdupq_n_s16((int16)Rotation);
+        const int16x8_t Right = vdupq_n_s16((int16)(Rotation - 16));
+
+        int32 Index = 0;
+        for (; Index + 8 <= NumPixels; Index += 8)
+        {
+            uint16_t* Ptr = reinterpret_cast<uint16_t*>(Row + Index * 2);
+            const uint16x8_t Words = vld1q_u16(Ptr);
+            vst1q_u16(Ptr, vorrq_u16(vshlq_u16(Words, Left), vshlq_u16(Words, Right)));
+        }
+
+        ToNativeRowScalar(Row + Index * 2, NumPixels - Index, Rotation);
+    }
+#endif
+
+    void ToNativeRow(EWebPSimdBackend Backend, EWebPPackedFormat Format, uint8* Row, int32 NumPixels)
+    {
+        const int32 Rotation = GetRotation(Format);
+        switch (Backend)
+        {
+#if WEBP_SIMD_AVX2
+        case EWebPSimdBackend::AVX2:
+            ToNativeRowAVX2(Row, NumPixels, Rotation);
+            return;
+#endif
+#if WEBP_SIMD_NEON
+        case EWebPSimdBackend::NEON:
+            ToNativeRowNEON(Row, NumPixels, Rotation);
+            return;
+#endif
+        default:
+            ToNativeRowScalar(Row, NumPixels, Rotation);
+            return;
+        }
+    }
+
+    void ToNativeRow(EWebPPackedFormat Format, uint8* Row, int32 NumPixels)
+    {
+        ToNativeRow(WebPSimd::GetBackend(), Format, Row, NumPixels);
+    }
+}
@@ -0,0 +1,91 @@
+// WebPPackedBenchmarks.cpp
+// Reduced-precision UI outputs: decoding into BGRA8 against RGB565 / RGBA4444 (half the bytes written and uploaded),
+// and the byte-order fixup per SIMD backend.
+#include "WebPBenchmark.h"
+#include "WebPBufferPool.h"
+#include "WebPPacked.h"
+#include "WebPSimd.h"
+#include "WebPSyntheticImage.h"
+#include "WebpImageWrapper.h"
+
+#if WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
+
+namespace WebPPackedBenchmarks
+{
+    static void Run(FWebPBenchmarkContext& Context)
+    {
+        const FIntPoint Size = Context.bQuick ? FIntPoint(960, 540) : FIntPoint(1920, 1080);
+
+        const TArray<EWebPSimdBackend> Backends = WebPSimd::GetAvailableBackends();
+
+        TArray64<uint8> Words;
+        Words.SetNumZeroed((int64)Size.X * Size.Y * 2);
+        for (EWebPSimdBackend Backend : Backends)
+        {
+            FWebPBenchmarkResult& Result = Context.AddResult(TEXT("Packed"),
+                FString::Printf(TEXT("to_native %dx%d %s"), Size.X, Size.Y, WebPSimd::ToString(Backend)));
+            Result.AddSizeParams(Size.X, Size.Y);
+            Result.Params.Add(TEXT("op"), TEXT("to_native"));
+            Result.AddBackendParam(Backend);
+            Result.BytesPerIteration = Words.Num();
+            Context.Measure(Result, [&]()
+            {
+                WebPPacked::ToNativeRow(Backend, EWebPPackedFormat::RGB565, Words.GetData(), Size.X * Size.Y);
+            });
+        }
+
+        for (const EWebPSyntheticContent Content : { EWebPSyntheticContent::Photo, EWebPSyntheticContent::Sprite })
+        {
+            TArray64<uint8> Pixels;
+            FWebPSyntheticImage::Generate(Size.X, Size.Y, Content, 11, Pixels);
+            const TArray64<uint8> Compressed = FWebPSyntheticImage::Encode(Pixels.GetData(), Size.X, Size.Y, 90);
+            if (Compressed.Num() == 0)
+            {
+                continue;
+            }
+
+            struct FVariant { const TCHAR* Name; TOptional<EWebPPackedFormat> Packed; int32 BytesPerPixel; };
+            const FVariant Variants[] =
+            {
+                { TEXT("bgra8"), TOptional<EWebPPackedFormat>(), 4 },
+                { TEXT("rgb565"), EWebPPackedFormat::RGB565, 2 },
+                { TEXT("rgba4444"), EWebPPackedFormat::RGBA4444, 2 },
+            };
+            const TCHAR* Alpha = FWebPSyntheticImage::HasAlpha(Content) ? TEXT("true") : TEXT("false");
+            for (const FVariant& Variant : Variants)
+            {
+                FWebPBenchmarkResult& Result = Context.AddResult(TEXT("Packed"),
+                    FString::Printf(TEXT("decode %dx%d alpha=%s %s"), Size.X, Size.Y, Alpha, Variant.Name));
+                Result.AddSizeParams(Size.X, Size.Y);
+                Result.Params.Add(TEXT("op"), TEXT("decode"));
+                Result.Params.Add(TEXT("alpha"), Alpha);
+                Result.Params.Add(TEXT("output"), Variant.Name);
+                Result.BytesPerIteration = (int64)Size.X * Size.Y * Variant.BytesPerPixel;
+                Result.Metrics.Add(TEXT("output_bytes"), (double)Result.BytesPerIteration);
+
+                TArray64<uint8> Output = FWebPBufferPool::Get().Acquire(Result.BytesPerIteration);
+                const int64 Stride = (int64)Size.X * Variant.BytesPerPixel;
+                Context.Measure(Result, [&]()
+                {
+                    FWebpImageWrapper Wrapper;
+                    if (Wrapper.SetCompressedView(Compressed.GetData(), Compressed.Num()))
+                    {
+                        if (Variant.Packed.IsSet())
+                        {
+                            Wrapper.DecodeInto(Variant.Packed.GetValue(), Output.GetData(), Stride, Output.Num());
+                        }
+                        else
+                        {
+                            Wrapper.DecodeInto(ERGBFormat::BGRA, 8, Output.GetData(), Stride, Output.Num());
+                        }
+                    }
+                });
+                FWebPBufferPool::Get().Release(Output);
+            }
+        }
+    }
+
+    static FWebPBenchmarkSuiteRegistrar PackedSuite(TEXT("Packed"), &Run);
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
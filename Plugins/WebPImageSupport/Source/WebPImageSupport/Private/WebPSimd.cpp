@@ -0,0 +1,104 @@
+// WebPSimd.cpp
+#include "WebPSimd.h"
+#include "HAL/IConsoleManager.h"
+
+#if WEBP_SIMD_AVX2 && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+static TOptional<EWebPSimdBackend> GWebPSimdOverride;
+
+bool WebPSimd::HasAVX2()
+{
+#if WEBP_SIMD_AVX2
+    static const bool bHasAVX2 = []()
+    {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int Info[4];
+        __cpuid(Info, 0);
+        if (Info[0] < 7)
+        {
+            return false;
+        }
+        __cpuid(Info, 1);
+        const bool bOSXSave = (Info[2] & (1 << 27)) != 0;
+        const bool bAVX = (Info[2] & (1 << 28)) != 0;
+        if (!bOSXSave || !bAVX || (_xgetbv(0) & 0x6) != 0x6) // OS saves XMM + YMM state
+        {
+            return false;
+        }
+        __cpuidex(Info, 7, 0);
+        return (Info[1] & (1 << 5)) != 0;
+    #else
+        return __builtin_cpu_supports("avx2") != 0;
+    #endif
+    }();
+    return bHasAVX2;
+#else
+    return false;
+#endif
+}
+
+EWebPSimdBackend WebPSimd::GetBackend()
+{
+    if (GWebPSimdOverride.IsSet())
+    {
+        const EWebPSimdBackend Forced = GWebPSimdOverride.GetValue();
+        // Never hand out a backend this machine or build can't run
+        if (Forced == EWebPSimdBackend::Scalar
+            || (Forced == EWebPSimdBackend::AVX2 && HasAVX2())
+            || (Forced == EWebPSimdBackend::NEON && WEBP_SIMD_NEON))
+        {
+            return Forced;
+        }
+    }
+#if WEBP_SIMD_NEON
+    return EWebPSimdBackend::NEON;
+#else
+    return HasAVX2() ? EWebPSimdBackend::AVX2 : EWebPSimdBackend::Scalar;
+#endif
+}
+
+void WebPSimd::SetBackendOverride(TOptional<EWebPSimdBackend> Backend)
+{
+    GWebPSimdOverride = Backend;
+}
+
+TArray<EWebPSimdBackend> WebPSimd::GetAvailableBackends()
+{
+    TArray<EWebPSimdBackend> Backends = { EWebPSimdBackend::Scalar };
+    if (HasAVX2())
+    {
+        Backends.Add(EWebPSimdBackend::AVX2);
+    }
+#if WEBP_SIMD_NEON
+    Backends.Add(EWebPSimdBackend::NEON);
+#endif
+    return Backends;
+}
+
+const TCHAR* WebPSimd::ToString(EWebPSimdBackend Backend)
+{
+    switch (Backend)
+    {
+    case EWebPSimdBackend::AVX2: return TEXT("avx2");
+    case EWebPSimdBackend::NEON: return TEXT("neon");
+    default:                     return TEXT("scalar");
+    }
+}
+
+static FAutoConsoleCommand GWebPSimdBackendCommand(
+    TEXT("WebP.SimdBackend"),
+    TEXT("WebP.SimdBackend [auto|scalar|avx2|neon] - force the pixel kernel backend (no argument prints the active one)."),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        if (Args.Num() > 0)
+        {
+            const FString& Name = Args[0];
+            if (Name == TEXT("scalar"))    { WebPSimd::SetBackendOverride(EWebPSimdBackend::Scalar); }
+            else if (Name == TEXT("avx2")) { WebPSimd::SetBackendOverride(EWebPSimdBackend::AVX2); }
+            else if (Name == TEXT("neon")) { WebPSimd::SetBackendOverride(EWebPSimdBackend::NEON); }
+            else                           { WebPSimd::SetBackendOverride(TOptional<EWebPSimdBackend>()); }
+        }
+        UE_LOG(LogTemp, Display, TEXT("WebP SIMD backend: %s"), WebPSimd::ToString(WebPSimd::GetBackend()));
+    }));
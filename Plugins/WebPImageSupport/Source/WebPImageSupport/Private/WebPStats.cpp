@@ -0,0 +1,41 @@
+// WebPStats.cpp
+#include "WebPStats.h"
+
+DEFINE_STAT(STAT_WebP_FileRead);
+DEFINE_STAT(STAT_WebP_SetCompressed);
+DEFINE_STAT(STAT_WebP_Decode);
+DEFINE_STAT(STAT_WebP_GetRawCopy);
+DEFINE_STAT(STAT_WebP_TextureCopy);
+DEFINE_STAT(STAT_WebP_TextureUpload);
+DEFINE_STAT(STAT_WebP_SetRaw);
+DEFINE_STAT(STAT_WebP_Encode);
+DEFINE_STAT(STAT_WebP_AlphaMask);
+
+DEFINE_STAT(STAT_WebP_ImagesDecoded);
+DEFINE_STAT(STAT_WebP_CompressedBytes);
+DEFINE_STAT(STAT_WebP_BytesDecoded);
+DEFINE_STAT(STAT_WebP_UploadedBytes);
+DEFINE_STAT(STAT_WebP_CacheHits);
+DEFINE_STAT(STAT_WebP_CacheMisses);
+DEFINE_STAT(STAT_WebP_PoolHits);
+DEFINE_STAT(STAT_WebP_PoolMisses);
+
+DEFINE_STAT(STAT_WebP_ImagesInFlight);
+DEFINE_STAT(STAT_WebP_PoolCachedBytes);
+
+UE_TRACE_CHANNEL_DEFINE(WebPChannel);
+
+TRACE_DECLARE_INT_COUNTER(WebP_ImagesInFlight, TEXT("WebP/ImagesInFlight"));
+TRACE_DECLARE_INT_COUNTER(WebP_BytesDecoded, TEXT("WebP/BytesDecoded"));
+
+FWebPInFlightScope::FWebPInFlightScope()
+{
+    INC_DWORD_STAT(STAT_WebP_ImagesInFlight);
+    TRACE_COUNTER_INCREMENT(WebP_ImagesInFlight);
+}
+
+FWebPInFlightScope::~FWebPInFlightScope()
+{
+    DEC_DWORD_STAT(STAT_WebP_ImagesInFlight);
+    TRACE_COUNTER_DECREMENT(WebP_ImagesInFlight);
+}
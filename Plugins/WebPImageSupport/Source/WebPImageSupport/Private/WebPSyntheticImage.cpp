@@ -0,0 +1,119 @@
+// WebPSyntheticImage.cpp
+#include "WebPSyntheticImage.h"
+#include "WebpImageWrapper.h"
+#include "Math/RandomStream.h"
+
+const TCHAR* FWebPSyntheticImage::ToString(EWebPSyntheticContent Content)
+{
+    switch (Content)
+    {
+    case EWebPSyntheticContent::Flat:     return TEXT("flat");
+    case EWebPSyntheticContent::Gradient: return TEXT("gradient");
+    case EWebPSyntheticContent::Noise:    return TEXT("noise");
+    case EWebPSyntheticContent::Photo:    return TEXT("photo");
+    case EWebPSyntheticContent::Sprite:   return TEXT("sprite");
+    default:                              return TEXT("unknown");
+    }
+}
+
+void FWebPSyntheticImage::Generate(int32 Width, int32 Height, EWebPSyntheticContent Content, int32 Seed, TArray64<uint8>& OutBGRA)
+{
+    OutBGRA.SetNumUninitialized((int64)Width * Height * 4);
+    if (Width <= 0 || Height <= 0)
+    {
+        return;
+    }
+
+    FRandomStream Random(Seed);
+
+    // A handful of soft blobs gives the encoder something between "gradient" and "noise" to chew on
+    struct FBlob { float X, Y, Radius; uint8 B, G, R; };
+    TArray<FBlob, TInlineAllocator<8>> Blobs;
+    for (int32 Index = 0; Index < 8; ++Index)
+    {
+        Blobs.Add({ Random.FRand() * Width, Random.FRand() * Height, (0.05f + Random.FRand() * 0.25f) * FMath::Min(Width, Height),
+                    (uint8)Random.RandHelper(256), (uint8)Random.RandHelper(256), (uint8)Random.RandHelper(256) });
+    }
+
+    const float CenterX = Width * 0.5f;
+    const float CenterY = Height * 0.55f;
+    const float HalfW = Width * 0.22f;
+    const float HalfH = Height * 0.42f;
+
+    uint8* Pixel = OutBGRA.GetData();
+    for (int32 Y = 0; Y < Height; ++Y)
+    {
+        for (int32 X = 0; X < Width; ++X, Pixel += 4)
+        {
+            const uint8 GradR = (uint8)((X * 255) / FMath::Max(Width - 1, 1));
+            const uint8 GradG = (uint8)((Y * 255) / FMath::Max(Height - 1, 1));
+            const uint8 GradB = (uint8)(((X + Y) * 255) / FMath::Max(Width + Height - 2, 1));
+
+            switch (Content)
+            {
+            case EWebPSyntheticContent::Flat:
+                Pixel[0] = 180; Pixel[1] = 120; Pixel[2] = 60; Pixel[3] = 255;
+                break;
+
+            case EWebPSyntheticContent::Gradient:
+                Pixel[0] = GradB; Pixel[1] = GradG; Pixel[2] = GradR; Pixel[3] = 255;
+                break;
+
+            case EWebPSyntheticContent::Noise:
+            {
+                const uint32 Bits = (uint32)Random.GetUnsignedInt();
+                Pixel[0] = (uint8)Bits; Pixel[1] = (uint8)(Bits >> 8); Pixel[2] = (uint8)(Bits >> 16); Pixel[3] = 255;
+                break;
+            }
+
+            case EWebPSyntheticContent::Photo:
+            case EWebPSyntheticContent::Sprite:
+            {
+                float B = GradB, G = GradG, R = GradR;
+                for (const FBlob& Blob : Blobs)
+                {
+                    const float DistSq = FMath::Square(X - Blob.X) + FMath::Square(Y - Blob.Y);
+                    const float Weight = FMath::Max(0.0f, 1.0f - DistSq / FMath::Square(Blob.Radius));
+                    B = FMath::Lerp(B, (float)Blob.B, Weight);
+                    G = FMath::Lerp(G, (float)Blob.G, Weight);
+                    R = FMath::Lerp(R, (float)Blob.R, Weight);
+                }
+                const int32 Grain = Random.RandRange(-6, 6);
+                Pixel[0] = (uint8)FMath::Clamp((int32)B + Grain, 0, 255);
+                Pixel[1] = (uint8)FMath::Clamp((int32)G + Grain, 0, 255);
+                Pixel[2] = (uint8)FMath::Clamp((int32)R + Grain, 0, 255);
+                Pixel[3] = 255;
+
+                if (Content == EWebPSyntheticContent::Sprite)
+                {
+                    // Elliptical "character" silhouette with a soft anti-aliased edge, transparent elsewhere
+                    const float D = FMath::Sqrt(FMath::Square((X - CenterX) / HalfW) + FMath::Square((Y - CenterY) / HalfH));
+                    const float Alpha = FMath::Clamp((1.0f - D) * 24.0f, 0.0f, 1.0f);
+                    Pixel[3] = (uint8)(Alpha * 255.0f + 0.5f);
+                    if (Pixel[3] == 0)
+                    {
+                        Pixel[0] = Pixel[1] = Pixel[2] = 0;
+                    }
+                }
+                break;
+            }
+            }
+        }
+    }
+}
+
+TArray64<uint8> FWebPSyntheticImage::Encode(const uint8* BGRA, int32 Width, int32 Height, int32 Quality, bool bLossless, int64 Stride)
+{
+    const int64 RowBytes = (int64)Width * 4;
+    const int64 SourceStride = Stride > 0 ? Stride : RowBytes;
+
+    FWebpImageWrapper Encoder;
+    FWebPEncodeOptions EncodeOptions;
+    EncodeOptions.bLossless = bLossless;
+    Encoder.SetEncodeOptions(EncodeOptions);
+    if (!Encoder.SetRawView(BGRA, SourceStride * (Height - 1) + RowBytes, Width, Height, ERGBFormat::BGRA, 8, (int32)SourceStride))
+    {
+        return TArray64<uint8>();
+    }
+    return Encoder.GetCompressed(Quality);
+}
@@ -0,0 +1,95 @@
+// WebPTiledBenchmarks.cpp
+// Very large CG decode: one WebP bitstream (with and without libwebp's worker thread) against the same image as
+// a .webptiles grid decoded on 1, 2, 4 and all task workers.
+#include "WebPBenchmark.h"
+#include "WebPBufferPool.h"
+#include "WebPSyntheticImage.h"
+#include "WebPTiledImage.h"
+#include "WebpImageWrapper.h"
+
+#if WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
+
+namespace WebPTiledBenchmarks
+{
+    static void Run(FWebPBenchmarkContext& Context)
+    {
+        const int32 Width = Context.bQuick ? 3840 : 7680;
+        const int32 Height = Context.bQuick ? 2160 : 4320;
+        const int32 Quality = 90;
+
+        TArray64<uint8> Pixels;
+        FWebPSyntheticImage::Generate(Width, Height, EWebPSyntheticContent::Photo, 1234, Pixels);
+        const int64 Stride = (int64)Width * 4;
+
+        const TArray64<uint8> Single = FWebPSyntheticImage::Encode(Pixels.GetData(), Width, Height, Quality);
+        if (Single.Num() == 0)
+        {
+            return;
+        }
+
+        TArray64<uint8> Output;
+        Output.SetNumUninitialized(Stride * Height);
+
+        const bool ThreadSettings[] = { false, true };
+        for (bool bThreads : ThreadSettings)
+        {
+            FWebPBenchmarkResult& Result = Context.AddResult(TEXT("Tiled"),
+                FString::Printf(TEXT("%dx%d single threads=%d"), Width, Height, bThreads ? 1 : 0));
+            Result.AddSizeParams(Width, Height);
+            Result.Params.Add(TEXT("layout"), TEXT("single"));
+            Result.Params.Add(TEXT("threads"), bThreads ? TEXT("true") : TEXT("false"));
+            Result.BytesPerIteration = Output.Num();
+            Result.Metrics.Add(TEXT("compressed_bytes"), (double)Single.Num());
+
+            FWebPDecodeOptions DecodeOptions;
+            DecodeOptions.bUseThreads = bThreads;
+            Context.Measure(Result, [&]()
+            {
+                FWebpImageWrapper Wrapper;
+                Wrapper.SetDecodeOptions(DecodeOptions);
+                if (Wrapper.SetCompressedView(Single.GetData(), Single.Num()))
+                {
+                    Wrapper.DecodeInto(ERGBFormat::BGRA, 8, Output.GetData(), Stride, Output.Num());
+                }
+            });
+        }
+
+        const int32 TileSizes[] = { 256, FWebPTiledImageBuilder::DefaultTileSize, 1024 };
+        const int32 Parallelisms[] = { 1, 2, 4, 0 };
+        for (int32 TileSize : TileSizes)
+        {
+            TArray64<uint8> File;
+            FWebPTiledImage Tiled;
+            if (!FWebPTiledImageBuilder::Encode(Pixels.GetData(), Width, Height, Stride, TileSize, FWebPEncodeOptions(), Quality, File)
+                || !Tiled.InitializeView(TConstArrayView64<uint8>(File.GetData(), File.Num())))
+            {
+                continue;
+            }
+
+            for (int32 Parallelism : Parallelisms)
+            {
+                const FString ParallelismName = Parallelism > 0 ? LexToString(Parallelism) : FString(TEXT("all"));
+                FWebPBenchmarkResult& Result = Context.AddResult(TEXT("Tiled"),
+                    FString::Printf(TEXT("%dx%d tiles=%d parallelism=%s"), Width, Height, TileSize, *ParallelismName));
+                Result.AddSizeParams(Width, Height);
+                Result.Params.Add(TEXT("layout"), TEXT("tiled"));
+                Result.Params.Add(TEXT("tile_size"), LexToString(TileSize));
+                Result.Params.Add(TEXT("parallelism"), ParallelismName);
+                Result.BytesPerIteration = Output.Num();
+                Result.Metrics.Add(TEXT("compressed_bytes"), (double)File.Num());
+                Result.Metrics.Add(TEXT("tiles"), (double)Tiled.GetNumTiles());
+
+                Context.Measure(Result, [&]()
+                {
+                    TArray64<uint8> Decoded;
+                    Tiled.DecodeAll(ERGBFormat::BGRA, FWebPDecodeOptions(), Decoded, Parallelism);
+                    FWebPBufferPool::Get().Release(Decoded);
+                });
+            }
+        }
+    }
+
+    static FWebPBenchmarkSuiteRegistrar TiledSuite(TEXT("Tiled"), &Run);
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
@@ -0,0 +1,260 @@
+// WebPTiledImage.cpp
+#include "WebPTiledImage.h"
+#include "WebPBundle.h"
+#include "WebPBufferPool.h"
+#include "WebPStats.h"
+#include "WebPMemory.h"
+#include "WebpImageWrapper.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWebPTiled, Log, All);
+
+bool FWebPTiledImage::InitializeView(TConstArrayView64<uint8> InData)
+{
+    OwnedData.Empty();
+    Data = InData;
+    return Validate();
+}
+
+void FWebPTiledImage::Reset()
+{
+    Header = nullptr;
+    Tiles = TConstArrayView<FWebPTileEntry>();
+    Data = TConstArrayView64<uint8>();
+    OwnedData.Empty();
+}
+
+bool FWebPTiledImage::LoadFile(const FString& Filename)
+{
+    WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_FileRead);
+    LLM_SCOPE_BYTAG(WebP_Compressed);
+    if (!FFileHelper::LoadFileToArray(OwnedData, *Filename))
+    {
+        UE_LOG(LogWebPTiled, Error, TEXT("Failed to read %s"), *Filename);
+        return false;
+    }
+    Data = TConstArrayView64<uint8>(OwnedData.GetData(), OwnedData.Num());
+    if (!Validate())
+    {
+        UE_LOG(LogWebPTiled, Error, TEXT("%s is not a valid tiled WebP image"), *Filename);
+        return false;
+    }
+    return true;
+}
+
+bool FWebPTiledImage::Validate()
+{
+    Header = nullptr;
+    Tiles = TConstArrayView<FWebPTileEntry>();
+
+    if (Data.Num() < (int64)sizeof(FWebPTiledHeader))
+    {
+        return false;
+    }
+    const FWebPTiledHeader* Candidate = reinterpret_cast<const FWebPTiledHeader*>(Data.GetData());
+    if (Candidate->Magic != WebPTiled::Magic || Candidate->Version != WebPTiled::Version
+        || Candidate->Width == 0 || Candidate->Height == 0 || Candidate->TileSize == 0
+        || Candidate->TilesX != FMath::DivideAndRoundUp(Candidate->Width, Candidate->TileSize)
+        || Candidate->TilesY != FMath::DivideAndRoundUp(Candidate->Height, Candidate->TileSize))
+    {
+        return false;
+    }
+
+    const int64 NumTiles = (int64)Candidate->TilesX * Candidate->TilesY;
+    if (NumTiles > MAX_int32 || sizeof(FWebPTiledHeader) + NumTiles * sizeof(FWebPTileEntry) > (uint64)Data.Num())
+    {
+        return false;
+    }
+
+    const FWebPTileEntry* FirstTile = reinterpret_cast<const FWebPTileEntry*>(Data.GetData() + sizeof(FWebPTiledHeader));
+    const TConstArrayView<FWebPTileEntry> CandidateTiles(FirstTile, (int32)NumTiles);
+    for (const FWebPTileEntry& Tile : CandidateTiles)
+    {
+        // Not DataOffset + DataSize, which a crafted offset can wrap around
+        if (Tile.DataSize == 0 || Tile.DataSize > (uint64)Data.Num() || Tile.DataOffset > (uint64)Data.Num() - Tile.DataSize)
+        {
+            return false;
+        }
+    }
+
+    Header = Candidate;
+    Tiles = CandidateTiles;
+    return true;
+}
+
+FIntRect FWebPTiledImage::GetTileRect(int32 TileX, int32 TileY) const
+{
+    check(IsValid());
+    const int32 TileSize = Header->TileSize;
+    const FIntPoint Min(TileX * TileSize, TileY * TileSize);
+    return FIntRect(Min, FIntPoint(FMath::Min<int32>(Min.X + TileSize, Header->Width), FMath::Min<int32>(Min.Y + TileSize, Header->Height)));
+}
+
+TConstArrayView64<uint8> FWebPTiledImage::GetTileData(int32 TileX, int32 TileY) const
+{
+    check(IsValid() && TileX >= 0 && TileX < GetNumTilesX() && TileY >= 0 && TileY < GetNumTilesY());
+    const FWebPTileEntry& Tile = Tiles[TileY * Header->TilesX + TileX];
+    return TConstArrayView64<uint8>(Data.GetData() + Tile.DataOffset, Tile.DataSize);
+}
+
+bool FWebPTiledImage::DecodeTile(int32 TileX, int32 TileY, ERGBFormat Format, const FWebPDecodeOptions& Options,
+                                 uint8* OutPixels, int64 OutStride, int64 OutSize) const
+{
+    const TConstArrayView64<uint8> TileData = GetTileData(TileX, TileY);
+    const FIntRect Rect = GetTileRect(TileX, TileY);
+
+    FWebpImageWrapper Wrapper;
+    Wrapper.SetDecodeOptions(Options);
+    if (!Wrapper.SetCompressedView(TileData.GetData(), TileData.Num())
+        || Wrapper.GetWidth() != Rect.Width() || Wrapper.GetHeight() != Rect.Height())
+    {
+        return false;
+    }
+    return Wrapper.DecodeInto(Format, 8, OutPixels, OutStride, OutSize);
+}
+
+bool FWebPTiledImage::DecodeAll(ERGBFormat Format, const FWebPDecodeOptions& Options, TArray64<uint8>& OutPixels, int32 MaxParallelism) const
+{
+    if (!IsValid() || Options.IsScaled())
+    {
+        return false;
+    }
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FWebPTiledImage_DecodeAll, WebPChannel);
+
+    // 8-bit outputs only; the tiles are written in place, so the full-image stride has to match the format
+    const int32 BytesPerPixel = (Format == ERGBFormat::BGRA || Format == ERGBFormat::RGBA) ? 4 : Format == ERGBFormat::Gray ? 1 : 0;
+    if (BytesPerPixel == 0)
+    {
+        return false;
+    }
+    const int64 Stride = (int64)Header->Width * BytesPerPixel;
+    {
+        LLM_SCOPE_BYTAG(WebP_Decoded);
+        FWebPBufferPool::Get().Release(OutPixels);
+        OutPixels = FWebPBufferPool::Get().Acquire(Stride * Header->Height);
+    }
+
+    // libwebp's own worker thread only helps a single bitstream; with tiles the parallelism is here
+    FWebPDecodeOptions TileOptions = Options;
+    TileOptions.bUseThreads = false;
+
+    const int32 NumTiles = Tiles.Num();
+    const int32 NumBatches = MaxParallelism > 0 ? FMath::Min(MaxParallelism, NumTiles) : NumTiles;
+    std::atomic<bool> bFailed { false };
+
+    ParallelFor(NumBatches, [&](int32 Batch)
+    {
+        // Contiguous tile ranges per batch, so MaxParallelism caps the number of concurrent decodes
+        const int32 First = (int32)((int64)NumTiles * Batch / NumBatches);
+        const int32 Last = (int32)((int64)NumTiles * (Batch + 1) / NumBatches);
+        for (int32 TileIndex = First; TileIndex < Last && !bFailed.load(std::memory_order_relaxed); ++TileIndex)
+        {
+            const int32 TileX = TileIndex % Header->TilesX;
+            const int32 TileY = TileIndex / Header->TilesX;
+            const FIntRect Rect = GetTileRect(TileX, TileY);
+            const int64 Offset = Rect.Min.Y * Stride + (int64)Rect.Min.X * BytesPerPixel;
+            if (!DecodeTile(TileX, TileY, Format, TileOptions, OutPixels.GetData() + Offset, Stride, OutPixels.Num() - Offset))
+            {
+                bFailed.store(true, std::memory_order_relaxed);
+            }
+        }
+    });
+
+    if (bFailed.load())
+    {
+        FWebPBufferPool::Get().Release(OutPixels);
+        return false;
+    }
+    return true;
+}
+
+bool FWebPTiledImageBuilder::Encode(const uint8* BGRA, int32 Width, int32 Height, int64 Stride, int32 TileSize,
+                                    const FWebPEncodeOptions& Options, int32 Quality, TArray64<uint8>& OutFile, FString* OutError)
+{
+    if (!BGRA || Width <= 0 || Height <= 0 || Stride < (int64)Width * 4 || TileSize <= 0)
+    {
+        if (OutError) { *OutError = TEXT("Invalid source image"); }
+        return false;
+    }
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FWebPTiledImageBuilder_Encode, WebPChannel);
+
+    // WebP's hard limit is 16383; keep tiles well inside it and a multiple of 16 (macroblock size)
+    TileSize = FMath::Clamp(Align(TileSize, 16), 16, 4096);
+    const int32 TilesX = FMath::DivideAndRoundUp(Width, TileSize);
+    const int32 TilesY = FMath::DivideAndRoundUp(Height, TileSize);
+    const int32 NumTiles = TilesX * TilesY;
+
+    TArray<TArray64<uint8>> Encoded;
+    Encoded.SetNum(NumTiles);
+    TArray<bool> TileHasAlpha;
+    TileHasAlpha.SetNumZeroed(NumTiles);
+
+    ParallelFor(NumTiles, [&](int32 TileIndex)
+    {
+        const int32 X0 = (TileIndex % TilesX) * TileSize;
+        const int32 Y0 = (TileIndex / TilesX) * TileSize;
+        const int32 TileWidth = FMath::Min(TileSize, Width - X0);
+        const int32 TileHeight = FMath::Min(TileSize, Height - Y0);
+
+        // The encoder reads the tile in place, rows Stride apart inside the source image
+        const uint8* TileOrigin = BGRA + Y0 * Stride + (int64)X0 * 4;
+        bool bHasAlpha = false;
+        for (int32 Row = 0; Row < TileHeight && !bHasAlpha; ++Row)
+        {
+            const uint8* Src = TileOrigin + Row * Stride;
+            for (int32 Pixel = 0; Pixel < TileWidth && !bHasAlpha; ++Pixel)
+            {
+                bHasAlpha = Src[Pixel * 4 + 3] != 255;
+            }
+        }
+
+        FWebpImageWrapper Wrapper;
+        FWebPEncodeOptions TileOptions = Options;
+        TileOptions.bUseThreads = false; // Parallel across tiles instead
+        Wrapper.SetEncodeOptions(TileOptions);
+        if (Wrapper.SetRawView(TileOrigin, Stride * (TileHeight - 1) + (int64)TileWidth * 4, TileWidth, TileHeight, ERGBFormat::BGRA, 8, (int32)Stride))
+        {
+            Encoded[TileIndex] = Wrapper.GetCompressed(Quality);
+        }
+        TileHasAlpha[TileIndex] = bHasAlpha;
+    });
+
+    FWebPTiledHeader Header = {};
+    Header.Magic = WebPTiled::Magic;
+    Header.Version = WebPTiled::Version;
+    Header.Width = Width;
+    Header.Height = Height;
+    Header.TileSize = TileSize;
+    Header.TilesX = TilesX;
+    Header.TilesY = TilesY;
+    Header.Flags = Options.bLossless ? (uint32)EWebPBundleEntryFlags::Lossless : 0;
+
+    TArray<FWebPTileEntry> Entries;
+    Entries.SetNumZeroed(NumTiles);
+    uint64 DataEnd = Align(sizeof(FWebPTiledHeader) + (uint64)NumTiles * sizeof(FWebPTileEntry), (uint64)WebPTiled::BlobAlignment);
+    for (int32 TileIndex = 0; TileIndex < NumTiles; ++TileIndex)
+    {
+        if (Encoded[TileIndex].Num() == 0 || Encoded[TileIndex].Num() > MAX_uint32)
+        {
+            if (OutError) { *OutError = FString::Printf(TEXT("Failed to encode tile %d"), TileIndex); }
+            return false;
+        }
+        if (TileHasAlpha[TileIndex])
+        {
+            Header.Flags |= (uint32)EWebPBundleEntryFlags::HasAlpha;
+        }
+        Entries[TileIndex].DataOffset = DataEnd;
+        Entries[TileIndex].DataSize = (uint32)Encoded[TileIndex].Num();
+        DataEnd = Align(DataEnd + Entries[TileIndex].DataSize, (uint64)WebPTiled::BlobAlignment);
+    }
+
+    OutFile.SetNumZeroed(DataEnd);
+    FMemory::Memcpy(OutFile.GetData(), &Header, sizeof(Header));
+    FMemory::Memcpy(OutFile.GetData() + sizeof(Header), Entries.GetData(), Entries.Num() * sizeof(FWebPTileEntry));
+    for (int32 TileIndex = 0; TileIndex < NumTiles; ++TileIndex)
+    {
+        FMemory::Memcpy(OutFile.GetData() + Entries[TileIndex].DataOffset, Encoded[TileIndex].GetData(), Encoded[TileIndex].Num());
+    }
+    return true;
+}
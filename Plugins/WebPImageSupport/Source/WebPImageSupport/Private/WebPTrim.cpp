@@ -0,0 +1,192 @@
+// WebPTrim.cpp
+#include "WebPTrim.h"
+#include "WebPStats.h"
+
+namespace WebPTrim
+{
+    // Index of the first / last pixel with alpha > 0 among Count pixels; Count / INDEX_NONE if there is none
+    static int32 FindFirstScalar(const uint8* Pixels, int32 Count)
+    {
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            if (Pixels[Index * 4 + 3] != 0)
+            {
+                return Index;
+            }
+        }
+        return Count;
+    }
+
+    static int32 FindLastScalar(const uint8* Pixels, int32 Count)
+    {
+        for (int32 Index = Count - 1; Index >= 0; --Index)
+        {
+            if (Pixels[Index * 4 + 3] != 0)
+            {
+                return Index;
+            }
+        }
+        return INDEX_NONE;
+    }
+
+#if WEBP_SIMD_AVX2
+    // One bit per pixel of 8 with alpha > 0
+    WEBP_TARGET_AVX2 static FORCEINLINE uint32 VisibleMaskAVX2(const uint8* Pixels)
+    {
+        const __m256i P = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Pixels));
+        const __m256i Transparent = _mm256_cmpeq_epi32(_mm256_srli_epi32(P, 24), _mm256_setzero_si256());
+        return ~(uint32)_mm256_movemask_ps(_mm256_castsi256_ps(Transparent)) & 0xFF;
+    }
+
+    WEBP_TARGET_AVX2 static int32 FindFirstAVX2(const uint8* Pixels, int32 Count)
+    {
+        int32 Index = 0;
+        for (; Index + 8 <= Count; Index += 8)
+        {
+            if (const uint32 Mask = VisibleMaskAVX2(Pixels + Index * 4))
+            {
+                return Index + (int32)FMath::CountTrailingZeros(Mask);
+            }
+        }
+        return Index + FindFirstScalar(Pixels + Index * 4, Count - Index);
+    }
+
+    WEBP_TARGET_AVX2 static int32 FindLastAVX2(const uint8* Pixels, int32 Count)
+    {
+        const int32 Blocks = Count & ~7;
+        const int32 InTail = FindLastScalar(Pixels + Blocks * 4, Count - Blocks);
+        if (InTail != INDEX_NONE)
+        {
+            return Blocks + InTail;
+        }
+        for (int32 Index = Blocks - 8; Index >= 0; Index -= 8)
+        {
+            if (const uint32 Mask = VisibleMaskAVX2(Pixels + Index * 4))
+            {
+                return Index + (int32)FMath::FloorLog2(Mask);
+            }
+        }
+        return INDEX_NONE;
+    }
+#endif
+
+#if WEBP_SIMD_NEON
+    // Alpha of 8 pixels as one 64-bit word, a non-zero byte per visible pixel
+    static FORCEINLINE uint64 AlphaWordNEON(const uint8* Pixels)
+    {
+        const uint8x8x4_t P = vld4_u8(Pixels);
+        return vget_lane_u64(vreinterpret_u64_u8(P.val[3]), 0);
+    }
+
+    static int32 FindFirstNEON(const uint8* Pixels, int32 Count)
+    {
+        int32 Index = 0;
+        for (; Index + 8 <= Count; Index += 8)
+        {
+            if (const uint64 Alpha = AlphaWordNEON(Pixels + Index * 4))
+            {
+                return Index + (int32)(FMath::CountTrailingZeros64(Alpha) / 8);
+            }
+        }
+        return Index + FindFirstScalar(Pixels + Index * 4, Count - Index);
+    }
+
+    static int32 FindLastNEON(const uint8* Pixels, int32 Count)
+    {
+        const int32 Blocks = Count & ~7;
+        const int32 InTail = FindLastScalar(Pixels + Blocks * 4, Count - Blocks);
+        if (InTail != INDEX_NONE)
+        {
+            return Blocks + InTail;
+        }
+        for (int32 Index = Blocks - 8; Index >= 0; Index -= 8)
+        {
+            if (const uint64 Alpha = AlphaWordNEON(Pixels + Index * 4))
+            {
+                return Index + (int32)(FMath::FloorLog2_64(Alpha) / 8);
+            }
+        }
+        return INDEX_NONE;
+    }
+#endif
+
+    static int32 FindFirst(EWebPSimdBackend Backend, const uint8* Pixels, int32 Count)
+    {
+        switch (Backend)
+        {
+#if WEBP_SIMD_AVX2
+        case EWebPSimdBackend::AVX2: return FindFirstAVX2(Pixels, Count);
+#endif
+#if WEBP_SIMD_NEON
+        case EWebPSimdBackend::NEON: return FindFirstNEON(Pixels, Count);
+#endif
+        default:                     return FindFirstScalar(Pixels, Count);
+        }
+    }
+
+    static int32 FindLast(EWebPSimdBackend Backend, const uint8* Pixels, int32 Count)
+    {
+        switch (Backend)
+        {
+#if WEBP_SIMD_AVX2
+        case EWebPSimdBackend::AVX2: return FindLastAVX2(Pixels, Count);
+#endif
+#if WEBP_SIMD_NEON
+        case EWebPSimdBackend::NEON: return FindLastNEON(Pixels, Count);
+#endif
+        default:                     return FindLastScalar(Pixels, Count);
+        }
+    }
+
+    FIntRect FindContentBounds(EWebPSimdBackend Backend, const uint8* Pixels, int32 Width, int32 Height, int64 Stride)
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(WebPTrim_FindContentBounds, WebPChannel);
+        if (!Pixels || Width <= 0 || Height <= 0 || Stride < (int64)Width * 4)
+        {
+            return FIntRect();
+        }
+
+        int32 Top = 0;
+        while (Top < Height && FindFirst(Backend, Pixels + Top * Stride, Width) == Width)
+        {
+            ++Top;
+        }
+        if (Top == Height)
+        {
+            return FIntRect();
+        }
+
+        int32 Bottom = Height - 1;
+        while (FindLast(Backend, Pixels + Bottom * Stride, Width) == INDEX_NONE)
+        {
+            --Bottom;
+        }
+
+        // Columns: each row only has to look left of Left and right of Right
+        int32 Left = Width;
+        int32 Right = INDEX_NONE;
+        for (int32 Row = Top; Row <= Bottom && (Left > 0 || Right < Width - 1); ++Row)
+        {
+            const uint8* RowPixels = Pixels + Row * Stride;
+            if (Left > 0)
+            {
+                Left = FMath::Min(Left, FindFirst(Backend, RowPixels, Left));
+            }
+            if (Right < Width - 1)
+            {
+                const int32 Last = FindLast(Backend, RowPixels + (Right + 1) * 4, Width - Right - 1);
+                if (Last != INDEX_NONE)
+                {
+                    Right += 1 + Last;
+                }
+            }
+        }
+
+        return FIntRect(Left, Top, Right + 1, Bottom + 1);
+    }
+
+    FIntRect FindContentBounds(const uint8* Pixels, int32 Width, int32 Height, int64 Stride)
+    {
+        return FindContentBounds(WebPSimd::GetBackend(), Pixels, Width, Height, Stride);
+    }
+}
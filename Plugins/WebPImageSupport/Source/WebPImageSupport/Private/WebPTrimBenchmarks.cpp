@@ -0,0 +1,88 @@
+// WebPTrimBenchmarks.cpp
+// Transparent-border trimming of character sprites: the bounds scan per SIMD backend, and decoding the full
+// authored canvas against decoding the trimmed image the bundle builder would store.
+#include "WebPBenchmark.h"
+#include "WebPBufferPool.h"
+#include "WebPSimd.h"
+#include "WebPSyntheticImage.h"
+#include "WebPTrim.h"
+#include "WebpImageWrapper.h"
+
+#if WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
+
+namespace WebPTrimBenchmarks
+{
+    static void Run(FWebPBenchmarkContext& Context)
+    {
+        const FIntPoint Canvas = Context.bQuick ? FIntPoint(512, 1024) : FIntPoint(1024, 2048);
+        TArray64<uint8> Pixels;
+        FWebPSyntheticImage::Generate(Canvas.X, Canvas.Y, EWebPSyntheticContent::Sprite, 42, Pixels);
+        const int64 Stride = (int64)Canvas.X * 4;
+
+        const TArray<EWebPSimdBackend> Backends = WebPSimd::GetAvailableBackends();
+
+        FIntRect Bounds;
+        for (EWebPSimdBackend Backend : Backends)
+        {
+            FWebPBenchmarkResult& Result = Context.AddResult(TEXT("Trim"),
+                FString::Printf(TEXT("bounds %dx%d %s"), Canvas.X, Canvas.Y, WebPSimd::ToString(Backend)));
+            Result.AddSizeParams(Canvas.X, Canvas.Y);
+            Result.Params.Add(TEXT("op"), TEXT("bounds"));
+            Result.AddBackendParam(Backend);
+            Result.BytesPerIteration = Pixels.Num();
+            Context.Measure(Result, [&]()
+            {
+                Bounds = WebPTrim::FindContentBounds(Backend, Pixels.GetData(), Canvas.X, Canvas.Y, Stride);
+            });
+        }
+        if (Bounds.IsEmpty())
+        {
+            return;
+        }
+
+        TArray64<uint8> Cropped;
+        Cropped.SetNumUninitialized((int64)Bounds.Area() * 4);
+        for (int32 Row = 0; Row < Bounds.Height(); ++Row)
+        {
+            FMemory::Memcpy(Cropped.GetData() + (int64)Row * Bounds.Width() * 4, Pixels.GetData() + (Bounds.Min.Y + Row) * Stride + (int64)Bounds.Min.X * 4,
+                            (int64)Bounds.Width() * 4);
+        }
+
+        struct FVariant { const TCHAR* Name; TArray64<uint8> Compressed; FIntPoint Size; };
+        FVariant Variants[] =
+        {
+            { TEXT("canvas"), FWebPSyntheticImage::Encode(Pixels.GetData(), Canvas.X, Canvas.Y, 90), Canvas },
+            { TEXT("trimmed"), FWebPSyntheticImage::Encode(Cropped.GetData(), Bounds.Width(), Bounds.Height(), 90), Bounds.Size() },
+        };
+        for (const FVariant& Variant : Variants)
+        {
+            if (Variant.Compressed.Num() == 0)
+            {
+                continue;
+            }
+            FWebPBenchmarkResult& Result = Context.AddResult(TEXT("Trim"),
+                FString::Printf(TEXT("decode %dx%d %s"), Canvas.X, Canvas.Y, Variant.Name));
+            Result.AddSizeParams(Canvas.X, Canvas.Y);
+            Result.Params.Add(TEXT("op"), TEXT("decode"));
+            Result.Params.Add(TEXT("variant"), Variant.Name);
+            Result.BytesPerIteration = (int64)Variant.Size.X * Variant.Size.Y * 4;
+            Result.Metrics.Add(TEXT("decoded_pixels"), (double)Variant.Size.X * Variant.Size.Y);
+            Result.Metrics.Add(TEXT("pixel_ratio_vs_canvas"), (double)Variant.Size.X * Variant.Size.Y / ((double)Canvas.X * Canvas.Y));
+            Result.Metrics.Add(TEXT("compressed_bytes"), (double)Variant.Compressed.Num());
+            Context.Measure(Result, [&]()
+            {
+                FWebpImageWrapper Wrapper;
+                TArray64<uint8> Decoded;
+                if (Wrapper.SetCompressedView(Variant.Compressed.GetData(), Variant.Compressed.Num())
+                    && Wrapper.ReleaseRaw(ERGBFormat::BGRA, 8, Decoded))
+                {
+                    FWebPBufferPool::Get().Release(Decoded);
+                }
+            });
+        }
+    }
+
+    static FWebPBenchmarkSuiteRegistrar TrimSuite(TEXT("Trim"), &Run);
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
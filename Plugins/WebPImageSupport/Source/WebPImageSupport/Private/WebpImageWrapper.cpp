@@ -2,6 +2,12 @@
 #include "WebpImageWrapper.h"
 #include "webp/decode.h" // Include libwebp headers
 #include "webp/encode.h" // If you implement compression
+#include "WebPStats.h"
+#include "WebPMemory.h"
+#include "WebPBufferPool.h"
+#include "WebPGray.h"
+#include "WebPPacked.h"
+#include "Misc/ScopeExit.h"
 
 // For checking the WebP signature
 #include "Misc/FileHelper.h" // For FMemory::Memcmp if needed, or direct byte checks
@@ -51,47 +57,114 @@ FWebpImageWrapper::FWebpImageWrapper()
     , Height(0)
     , RawFormat(ERGBFormat::Invalid)
     , RawBitDepth(0)
+    , bHasAlpha(false)
 {
+    FWebPMemoryTracker::Get().Register(this);
+}
+
+FWebpImageWrapper::~FWebpImageWrapper()
+{
+    FWebPMemoryTracker::Get().Unregister(this);
+    FWebPBufferPool::Get().Release(CompressedData);
+    FWebPBufferPool::Get().Release(RawData);
+}
+
+void FWebpImageWrapper::SetDebugOwner(const FString& InOwner)
+{
+    FWebPMemoryTracker::Get().SetOwner(this, InOwner);
+}
+
+void FWebpImageWrapper::UpdateTrackedMemory()
+{
+    FWebPMemoryTracker::Get().Update(this, CompressedData.GetAllocatedSize(), RawData.GetAllocatedSize(), Width, Height);
+}
+
+static bool HasWebPSignature(const void* InCompressedData, int64 InCompressedSize)
+{
+    // Basic WebP signature check (RIFF, size, WEBP)
+    // 'R', 'I', 'F', 'F', xx, xx, xx, xx, 'W', 'E', 'B', 'P'
+    const uint8* Data = static_cast<const uint8*>(InCompressedData);
+    return Data && InCompressedSize >= 12 &&
+        Data[0] == 'R' && Data[1] == 'I' && Data[2] == 'F' && Data[3] == 'F' &&
+        Data[8] == 'W' && Data[9] == 'E' && Data[10] == 'B' && Data[11] == 'P';
 }
 
 bool FWebpImageWrapper::SetCompressed(const void* InCompressedData, int64 InCompressedSize)
 {
+    WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_SetCompressed);
+
     if (InCompressedData && InCompressedSize > 0)
     {
-        // Basic WebP signature check (RIFF, size, WEBP)
-        // 'R', 'I', 'F', 'F', xx, xx, xx, xx, 'W', 'E', 'B', 'P'
-        const uint8* Data = static_cast<const uint8*>(InCompressedData);
-        if (InCompressedSize < 12 ||
-            Data[0] != 'R' || Data[1] != 'I' || Data[2] != 'F' || Data[3] != 'F' ||
-            Data[8] != 'W' || Data[9] != 'E' || Data[10] != 'B' || Data[11] != 'P')
+        if (!HasWebPSignature(InCompressedData, InCompressedSize))
         {
             // UE_LOG(LogTemp, Warning, TEXT("Not a WebP file (magic number mismatch)."));
             return false;
         }
 
-        CompressedData.Empty(InCompressedSize);
-        CompressedData.Append(static_cast<const uint8*>(InCompressedData), InCompressedSize);
-        RawData.Empty(); // Clear any previous raw data
-
-        // Try to get info without full decode
-        if (WebPGetInfo(CompressedData.GetData(), CompressedData.Num(), &Width, &Height) == 0) {
-            // Failed to get info
-            Width = 0;
-            Height = 0;
-            CompressedData.Empty();
-            // UE_LOG(LogTemp, Warning, TEXT("WebPGetInfo failed."));
-            return false;
+        {
+            LLM_SCOPE_BYTAG(WebP_Compressed);
+            FWebPBufferPool::Get().Release(CompressedData);
+            CompressedData = FWebPBufferPool::Get().Acquire(InCompressedSize);
+            FMemory::Memcpy(CompressedData.GetData(), InCompressedData, InCompressedSize);
         }
-        return true;
+        CompressedView = TConstArrayView64<uint8>();
+        return ReadCompressedInfo();
     }
     return false;
 }
 
+bool FWebpImageWrapper::SetCompressedView(const void* InCompressedData, int64 InCompressedSize)
+{
+    WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_SetCompressed);
+
+    if (!HasWebPSignature(InCompressedData, InCompressedSize))
+    {
+        return false;
+    }
+
+    FWebPBufferPool::Get().Release(CompressedData); // Drop any owned copy; decode reads straight from the caller's memory
+    CompressedView = TConstArrayView64<uint8>(static_cast<const uint8*>(InCompressedData), InCompressedSize);
+    return ReadCompressedInfo();
+}
+
+bool FWebpImageWrapper::ReadCompressedInfo()
+{
+    FWebPBufferPool::Get().Release(RawData); // Clear any previous raw data
+    RawView = TConstArrayView64<uint8>();
+
+    // Try to get info without full decode
+    const TConstArrayView64<uint8> Compressed = GetCompressedSpan();
+    WebPBitstreamFeatures Features;
+    if (WebPGetFeatures(Compressed.GetData(), Compressed.Num(), &Features) != VP8_STATUS_OK) {
+        // Failed to get info
+        Width = 0;
+        Height = 0;
+        bHasAlpha = false;
+        FWebPBufferPool::Get().Release(CompressedData);
+        CompressedView = TConstArrayView64<uint8>();
+        UpdateTrackedMemory();
+        // UE_LOG(LogTemp, Warning, TEXT("WebPGetInfo failed."));
+        return false;
+    }
+    Width = Features.width;
+    Height = Features.height;
+    bHasAlpha = Features.has_alpha != 0;
+    UpdateTrackedMemory();
+    return true;
+}
+
+TConstArrayView64<uint8> FWebpImageWrapper::GetCompressedSpan() const
+{
+    return CompressedView.Num() > 0 ? CompressedView : TConstArrayView64<uint8>(CompressedData.GetData(), CompressedData.Num());
+}
+
 bool FWebpImageWrapper::SetRaw(const void* InRawData, int64 InRawSize,
                                const int32 InWidth, const int32 InHeight,
                                const ERGBFormat InFormat, const int32 InBitDepth,
                                const int32 InBytesPerRow /*= 0*/) // Default value from .h doesn't need to be repeated
 {
+    WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_SetRaw);
+
     // 1. Validate input parameters
     if (!InRawData || InRawSize <= 0 || InWidth <= 0 || InHeight <= 0)
     {
@@ -143,8 +216,10 @@ bool FWebpImageWrapper::SetRaw(const void* InRawData, int64 InRawSize,
     Height = InHeight;
     RawFormat = InFormat;
     RawBitDepth = InBitDepth;
+    RawView = TConstArrayView64<uint8>();
 
-    RawData.Empty(InRawSize); // Reserve space
+    LLM_SCOPE_BYTAG(WebP_Decoded);
+    FWebPBufferPool::Get().Release(RawData);
     // If InBytesPerRow is specified and different from Width * Channels * (InBitDepth / 8),
     // you might need to copy row by row to handle potential pitch/stride differences.
     // For simplicity, this example assumes a tightly packed buffer if InBytesPerRow is 0 or matches.
@@ -156,12 +231,13 @@ bool FWebpImageWrapper::SetRaw(const void* InRawData, int64 InRawSize,
     if (SourceRowStride == DestRowStride && InRawSize >= ExpectedSize)
     {
         // Data is contiguous or matches our expected tight packing
-        RawData.Append(static_cast<const uint8*>(InRawData), ExpectedSize); // Copy only the expected amount
+        RawData = FWebPBufferPool::Get().Acquire(ExpectedSize);
+        FMemory::Memcpy(RawData.GetData(), InRawData, ExpectedSize); // Copy only the expected amount
     }
     else if (InRawSize >= (int64)InHeight * SourceRowStride) // Check if InRawSize is sufficient for row-by-row copy
     {
         // UE_LOG(LogTemp, Log, TEXT("FWebpImageWrapper::SetRaw: Performing row-by-row copy due to stride mismatch or padding. SourceStride: %d, DestStride: %d"), SourceRowStride, DestRowStride);
-        RawData.SetNumUninitialized(ExpectedSize); // Allocate for tightly packed data
+        RawData = FWebPBufferPool::Get().Acquire(ExpectedSize); // Allocate for tightly packed data
         const uint8* SrcRow = static_cast<const uint8*>(InRawData);
         uint8* DestRow = RawData.GetData();
         for (int32 Row = 0; Row < InHeight; ++Row)
@@ -174,67 +250,288 @@ bool FWebpImageWrapper::SetRaw(const void* InRawData, int64 InRawSize,
     else
     {
         // UE_LOG(LogTemp, Error, TEXT("FWebpImageWrapper::SetRaw: InRawSize (%lld) is insufficient for row-by-row copy with SourceRowStride (%d) for %d rows."), InRawSize, SourceRowStride, InHeight);
-        RawData.Empty(); // Clear any partial allocation
+        FWebPBufferPool::Get().Release(RawData); // Clear any partial allocation
         Width = 0;
         Height = 0;
         RawFormat = ERGBFormat::Invalid;
         RawBitDepth = 0;
+        UpdateTrackedMemory();
         return false;
     }
 
 
-    CompressedData.Empty(); // Clear any old compressed data, as we now have new raw data
+    FWebPBufferPool::Get().Release(CompressedData); // Clear any old compressed data, as we now have new raw data
+    CompressedView = TConstArrayView64<uint8>();
+    UpdateTrackedMemory();
 
     // UE_LOG(LogTemp, Log, TEXT("FWebpImageWrapper::SetRaw: Successfully set raw data %dx%d, Format: %d, BitDepth: %d"), Width, Height, (int32)RawFormat, RawBitDepth);
     return true;
 }
 
-bool FWebpImageWrapper::PerformUncompression(const ERGBFormat InFormat, int32 InBitDepth) // Return type changed to bool
+bool FWebpImageWrapper::SetRawView(const void* InRawData, int64 InRawSize, int32 InWidth, int32 InHeight,
+                                   ERGBFormat InFormat, int32 InBitDepth, int32 InBytesPerRow)
 {
-    if (CompressedData.Num() == 0 || Width == 0 || Height == 0)
+    WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_SetRaw);
+
+    const int64 RowBytes = (int64)InWidth * (InFormat == ERGBFormat::Gray ? 1 : 4); // CanSetRawFormat: 8-bit only
+    const int64 Stride = InBytesPerRow > 0 ? InBytesPerRow : RowBytes;
+    if (!InRawData || InWidth <= 0 || InHeight <= 0 || !CanSetRawFormat(InFormat, InBitDepth)
+        || Stride < RowBytes || Stride > MAX_int32 || InRawSize < Stride * (InHeight - 1) + RowBytes)
     {
-        // UE_LOG(LogTemp, Warning, TEXT("No compressed WebP data to uncompress or dimensions are zero."));
-        return false; // Indicate failure
+        return false;
     }
 
-    RawData.Empty();
-    uint8* OutputBuffer = nullptr;
-    int Stride = 0;
-
-    // Use DecodedFormat and DecodedBitDepth (member variables from .h) instead of RawFormat/RawBitDepth locally for this function
-    // The goal is to populate RawData and set DecodedFormat/DecodedBitDepth
+    FWebPBufferPool::Get().Release(RawData);
+    FWebPBufferPool::Get().Release(CompressedData);
+    CompressedView = TConstArrayView64<uint8>();
+    RawView = TConstArrayView64<uint8>(static_cast<const uint8*>(InRawData), InRawSize);
+    RawViewStride = (int32)Stride;
+    Width = InWidth;
+    Height = InHeight;
+    RawFormat = InFormat;
+    RawBitDepth = InBitDepth;
+    UpdateTrackedMemory();
+    return true;
+}
 
+// libwebp output mode for a wrapper format, MODE_LAST if unsupported
+static WEBP_CSP_MODE GetOutputMode(const ERGBFormat InFormat, int32 InBitDepth, bool bPremultiplyAlpha)
+{
     if (InFormat == ERGBFormat::RGBA && InBitDepth == 8)
     {
-        RawFormat = ERGBFormat::RGBA; // Use the member variable declared in .h
-        RawBitDepth = 8;             // Use the member variable declared in .h
-        Stride = Width * 4;
-        RawData.SetNumUninitialized(Stride * Height);
-        OutputBuffer = WebPDecodeRGBAInto(CompressedData.GetData(), CompressedData.Num(), RawData.GetData(), RawData.Num(), Stride);
+        return bPremultiplyAlpha ? MODE_rgbA : MODE_RGBA;
     }
     else if (InFormat == ERGBFormat::BGRA && InBitDepth == 8)
     {
-        RawFormat = ERGBFormat::BGRA; // Use the member variable declared in .h
-        RawBitDepth = 8;             // Use the member variable declared in .h
-        Stride = Width * 4;
-        RawData.SetNumUninitialized(Stride * Height);
-        OutputBuffer = WebPDecodeBGRAInto(CompressedData.GetData(), CompressedData.Num(), RawData.GetData(), RawData.Num(), Stride);
+        return bPremultiplyAlpha ? MODE_bgrA : MODE_BGRA;
+    }
+    else if (InFormat == ERGBFormat::Gray && InBitDepth == 8)
+    {
+        return MODE_YUV; // Luma plane only, see DecodeToMemory
     }
     // Add more formats as needed
+    return MODE_LAST;
+}
+
+static WEBP_CSP_MODE GetOutputMode(EWebPPackedFormat InFormat, bool bPremultiplyAlpha)
+{
+    if (InFormat == EWebPPackedFormat::RGBA4444)
+    {
+        return bPremultiplyAlpha ? MODE_rgbA_4444 : MODE_RGBA_4444;
+    }
+    return MODE_RGB_565;
+}
+
+static int32 GetBytesPerPixel(WEBP_CSP_MODE OutputMode)
+{
+    switch (OutputMode)
+    {
+    case MODE_YUV:
+        return 1;
+    case MODE_RGB_565:
+    case MODE_RGBA_4444:
+    case MODE_rgbA_4444:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+// Advanced decoding API so the decode options (threads, filtering) apply; libwebp writes rows straight into
+// OutPixels at OutStride (external memory), like WebPDecode*Into. OutputSize is the decoded size in pixels
+// (Options.GetOutputSize).
+static bool DecodeToMemory(TConstArrayView64<uint8> Compressed, const FWebPDecodeOptions& Options, WEBP_CSP_MODE OutputMode,
+                           FIntPoint OutputSize, uint8* OutPixels, int32 OutStride, int64 OutSize)
+{
+    WebPDecoderConfig Config;
+    if (OutputMode == MODE_LAST || !WebPInitDecoderConfig(&Config))
+    {
+        return false;
+    }
+
+    Config.options.use_threads = Options.bUseThreads ? 1 : 0;
+    Config.options.bypass_filtering = Options.bBypassFiltering ? 1 : 0;
+    Config.options.no_fancy_upsampling = Options.bNoFancyUpsampling ? 1 : 0;
+    if (Options.IsScaled())
+    {
+        Config.options.use_scaling = 1;
+        Config.options.scaled_width = Options.ScaledWidth;
+        Config.options.scaled_height = Options.ScaledHeight;
+    }
+
+    Config.output.colorspace = OutputMode;
+    Config.output.is_external_memory = 1;
+
+    // Gray: the Y plane goes straight to OutPixels, so no YUV->RGB conversion runs and only a quarter of the
+    // bytes are written. libwebp insists on chroma planes too; they land in pooled scratch and are dropped.
+    // Lossless images are converted ARGB->YUV row by row inside libwebp, still without an RGBA buffer.
+    TArray64<uint8> Chroma;
+    if (OutputMode == MODE_YUV)
+    {
+        const int32 ChromaWidth = (OutputSize.X + 1) / 2;
+        const int64 ChromaPlane = (int64)ChromaWidth * ((OutputSize.Y + 1) / 2);
+        {
+            LLM_SCOPE_BYTAG(WebP_Scratch);
+            Chroma = FWebPBufferPool::Get().Acquire(ChromaPlane * 2);
+        }
+        Config.output.u.YUVA.y = OutPixels;
+        Config.output.u.YUVA.y_stride = OutStride;
+        Config.output.u.YUVA.y_size = (size_t)OutSize;
+        Config.output.u.YUVA.u = Chroma.GetData();
+        Config.output.u.YUVA.v = Chroma.GetData() + ChromaPlane;
+        Config.output.u.YUVA.u_stride = ChromaWidth;
+        Config.output.u.YUVA.v_stride = ChromaWidth;
+        Config.output.u.YUVA.u_size = (size_t)ChromaPlane;
+        Config.output.u.YUVA.v_size = (size_t)ChromaPlane;
+    }
+    else
+    {
+        Config.output.u.RGBA.rgba = OutPixels;
+        Config.output.u.RGBA.stride = OutStride;
+        Config.output.u.RGBA.size = (size_t)OutSize;
+    }
 
-    if (OutputBuffer == nullptr)
+    bool bDecoded;
+    {
+        LLM_SCOPE_BYTAG(WebP_Scratch);
+        bDecoded = WebPDecode(Compressed.GetData(), Compressed.Num(), &Config) == VP8_STATUS_OK;
+        WebPFreeDecBuffer(&Config.output); // No-op for external memory, kept for symmetry with libwebp docs
+    }
+    FWebPBufferPool::Get().Release(Chroma);
+
+    if (bDecoded && OutputMode == MODE_YUV)
+    {
+        // Limited-range Y -> full-range gray, while the rows are still warm
+        for (int32 Row = 0; Row < Config.output.height; ++Row)
+        {
+            WebPGray::ExpandLumaRow(OutPixels + (int64)Row * OutStride, Config.output.width);
+        }
+    }
+    else if (bDecoded && GetBytesPerPixel(OutputMode) == 2)
+    {
+        // libwebp's byte order -> the GPU's 16-bit layout (WebPPacked.h)
+        const EWebPPackedFormat Packed = OutputMode == MODE_RGB_565 ? EWebPPackedFormat::RGB565 : EWebPPackedFormat::RGBA4444;
+        for (int32 Row = 0; Row < Config.output.height; ++Row)
+        {
+            WebPPacked::ToNativeRow(Packed, OutPixels + (int64)Row * OutStride, Config.output.width);
+        }
+    }
+    if (bDecoded)
+    {
+        const int64 DecodedBytes = (int64)Config.output.width * Config.output.height * GetBytesPerPixel(OutputMode);
+        INC_DWORD_STAT(STAT_WebP_ImagesDecoded);
+        INC_DWORD_STAT_BY(STAT_WebP_CompressedBytes, Compressed.Num());
+        INC_DWORD_STAT_BY(STAT_WebP_BytesDecoded, DecodedBytes);
+        TRACE_COUNTER_ADD(WebP_BytesDecoded, DecodedBytes);
+    }
+    return bDecoded;
+}
+
+bool FWebpImageWrapper::PerformUncompression(const ERGBFormat InFormat, int32 InBitDepth) // Return type changed to bool
+{
+    WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_Decode);
+    FWebPInFlightScope InFlight;
+
+    const TConstArrayView64<uint8> Compressed = GetCompressedSpan();
+    if (Compressed.Num() == 0 || Width == 0 || Height == 0)
+    {
+        // UE_LOG(LogTemp, Warning, TEXT("No compressed WebP data to uncompress or dimensions are zero."));
+        return false; // Indicate failure
+    }
+
+    FWebPBufferPool::Get().Release(RawData);
+
+    const WEBP_CSP_MODE OutputMode = GetOutputMode(InFormat, InBitDepth, DecodeOptions.bPremultiplyAlpha);
+    const int32 Stride = Width * GetBytesPerPixel(OutputMode);
+
+    // RawData always matches GetWidth/GetHeight
+    FWebPDecodeOptions FullSizeOptions = DecodeOptions;
+    FullSizeOptions.ScaledWidth = 0;
+    FullSizeOptions.ScaledHeight = 0;
+
+    bool bDecoded = false;
+    if (OutputMode != MODE_LAST)
+    {
+        {
+            LLM_SCOPE_BYTAG(WebP_Decoded);
+            RawData = FWebPBufferPool::Get().Acquire((int64)Stride * Height);
+        }
+        bDecoded = DecodeToMemory(Compressed, FullSizeOptions, OutputMode, FIntPoint(Width, Height), RawData.GetData(), Stride, RawData.Num());
+    }
+
+    if (!bDecoded)
     {
         // UE_LOG(LogTemp, Error, TEXT("WebPDecode failed."));
-        RawData.Empty();
+        FWebPBufferPool::Get().Release(RawData);
+        AlphaMask.Reset();
         RawFormat = ERGBFormat::Invalid; // Reset decoded format on failure
         RawBitDepth = 0;                // Reset decoded bit depth on failure
         // Width = 0; // You might not want to reset Width/Height here, as they come from WebPGetInfo
         // Height = 0;
+        UpdateTrackedMemory();
         return false; // Indicate failure
     }
+
+    RawFormat = InFormat;
+    RawBitDepth = InBitDepth;
+    BuildAlphaMask(RawData.GetData(), Width, Height, Stride, GetBytesPerPixel(OutputMode));
+    UpdateTrackedMemory();
     return true; // Indicate success
 }
 
+bool FWebpImageWrapper::DecodeInto(const ERGBFormat InFormat, int32 InBitDepth, void* OutPixels, int64 OutStride, int64 OutBufferSize)
+{
+    return DecodeIntoMode(GetOutputMode(InFormat, InBitDepth, DecodeOptions.bPremultiplyAlpha), OutPixels, OutStride, OutBufferSize);
+}
+
+bool FWebpImageWrapper::DecodeInto(EWebPPackedFormat InFormat, void* OutPixels, int64 OutStride, int64 OutBufferSize)
+{
+    return DecodeIntoMode(GetOutputMode(InFormat, DecodeOptions.bPremultiplyAlpha), OutPixels, OutStride, OutBufferSize);
+}
+
+bool FWebpImageWrapper::DecodeIntoMode(int32 InOutputMode, void* OutPixels, int64 OutStride, int64 OutBufferSize)
+{
+    WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_Decode);
+    FWebPInFlightScope InFlight;
+
+    const TConstArrayView64<uint8> Compressed = GetCompressedSpan();
+    if (Compressed.Num() == 0 || Width == 0 || Height == 0 || !OutPixels)
+    {
+        return false;
+    }
+
+    // libwebp validates the same bounds, but a short buffer here is a caller bug worth catching early
+    const WEBP_CSP_MODE OutputMode = (WEBP_CSP_MODE)InOutputMode;
+    const FIntPoint OutSize = DecodeOptions.GetOutputSize(Width, Height);
+    const int64 RowBytes = (int64)OutSize.X * GetBytesPerPixel(OutputMode);
+    if (OutStride < RowBytes || OutStride > MAX_int32 || OutBufferSize < OutStride * (OutSize.Y - 1) + RowBytes)
+    {
+        // UE_LOG(LogTemp, Error, TEXT("DecodeInto: destination too small for %dx%d at stride %lld."), OutSize.X, OutSize.Y, OutStride);
+        return false;
+    }
+
+    if (!DecodeToMemory(Compressed, DecodeOptions, OutputMode, OutSize, static_cast<uint8*>(OutPixels), (int32)OutStride, OutBufferSize))
+    {
+        return false;
+    }
+    BuildAlphaMask(static_cast<const uint8*>(OutPixels), OutSize.X, OutSize.Y, OutStride, GetBytesPerPixel(OutputMode));
+    return true;
+}
+
+void FWebpImageWrapper::BuildAlphaMask(const uint8* Pixels, int32 OutWidth, int32 OutHeight, int64 Stride, int32 BytesPerPixel)
+{
+    // Right after the decode, while the last rows are still in cache. Only 8-bit 4-channel rows are read; Gray and
+    // the packed formats build none.
+    if (DecodeOptions.AlphaMaskCellSize > 0 && BytesPerPixel == 4)
+    {
+        AlphaMask.Build(Pixels, OutWidth, OutHeight, Stride, DecodeOptions.AlphaMaskThreshold, DecodeOptions.AlphaMaskCellSize);
+    }
+    else
+    {
+        AlphaMask.Reset();
+    }
+}
+
 bool FWebpImageWrapper::GetRaw(const ERGBFormat InFormat, int32 InBitDepth, TArray64<uint8>& OutRawData)
 {
     if (RawData.Num() == 0 || RawFormat == ERGBFormat::Invalid) // If not yet uncompressed or failed
@@ -244,6 +541,7 @@ bool FWebpImageWrapper::GetRaw(const ERGBFormat InFormat, int32 InBitDepth, TArr
 
     if (RawData.Num() > 0 && RawFormat == InFormat && RawBitDepth == InBitDepth)
     {
+        WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_GetRawCopy);
         OutRawData = RawData;
         return true;
     }
@@ -252,6 +550,25 @@ bool FWebpImageWrapper::GetRaw(const ERGBFormat InFormat, int32 InBitDepth, TArr
     return false;
 }
 
+bool FWebpImageWrapper::ReleaseRaw(const ERGBFormat InFormat, int32 InBitDepth, TArray64<uint8>& OutRawData)
+{
+    if (RawData.Num() == 0 || RawFormat == ERGBFormat::Invalid)
+    {
+        PerformUncompression(InFormat, InBitDepth);
+    }
+
+    if (RawData.Num() > 0 && RawFormat == InFormat && RawBitDepth == InBitDepth)
+    {
+        OutRawData = MoveTemp(RawData);
+        RawData.Reset();
+        RawFormat = ERGBFormat::Invalid;
+        RawBitDepth = 0;
+        UpdateTrackedMemory();
+        return true;
+    }
+    return false;
+}
+
 bool FWebpImageWrapper::GetRaw(const ERGBFormat InRequestedRGBFormat, int32 InRequestedBitDepth, FDecompressedImageOutput& OutDecompressedImage)
 {
     TArray64<uint8> TempRawPixelData;
@@ -343,7 +660,8 @@ ERGBFormat FWebpImageWrapper::GetFormat() const
 bool FWebpImageWrapper::CanSetRawFormat(const ERGBFormat InFormat, const int32 InBitDepth) const
 {
     // Check if libwebp supports encoding this format or if you can convert to a supported one
-    return (InFormat == ERGBFormat::RGBA || InFormat == ERGBFormat::BGRA) && InBitDepth == 8;
+    // Gray is encoded as BGRX with the luma in all three channels; libwebp has no single-channel import
+    return (InFormat == ERGBFormat::RGBA || InFormat == ERGBFormat::BGRA || InFormat == ERGBFormat::Gray) && InBitDepth == 8;
 }
 
 ERawImageFormat::Type FWebpImageWrapper::GetSupportedRawFormat(const ERawImageFormat::Type InFormat) const
@@ -359,8 +677,9 @@ ERawImageFormat::Type FWebpImageWrapper::GetSupportedRawFormat(const ERawImageFo
         return ERawImageFormat::BGRA8;
     }
 
-    // If the requested format is G8 and you can produce ERGBFormat::Gray at 8-bit
-    if (InFormat == ERawImageFormat::G8 && CanSetRawFormat(ERGBFormat::Gray, 8)) // Assuming you add Gray support
+    // Masks and rule images stay single-channel: Gray8 decodes straight from the luma plane (GetOutputMode), a quarter
+    // of the BGRA8 memory. Asked of the decoder, not CanSetRawFormat, which is about what GetCompressed accepts.
+    if (InFormat == ERawImageFormat::G8 && GetOutputMode(ERGBFormat::Gray, 8, false) != MODE_LAST)
     {
         return ERawImageFormat::G8;
     }
@@ -391,28 +710,89 @@ ERawImageFormat::Type FWebpImageWrapper::GetSupportedRawFormat(const ERawImageFo
 }
 
 
+// libwebp calls this between encoder passes and rows; returning 0 aborts with VP8_ENC_ERROR_USER_ABORT
+static int EncodeProgressHook(int Percent, const WebPPicture* Picture)
+{
+    const std::atomic<bool>* CancelFlag = static_cast<const std::atomic<bool>*>(Picture->user_data);
+    return CancelFlag->load(std::memory_order_relaxed) ? 0 : 1;
+}
+
 TArray64<uint8> FWebpImageWrapper::GetCompressed(int32 Quality)
 {
-    if (RawData.Num() == 0 || Width == 0 || Height == 0 || RawFormat == ERGBFormat::Invalid)
+    WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_Encode);
+
+    // The caller's rows (SetRawView) or our packed copy (SetRaw)
+    const bool bView = RawView.Num() > 0;
+    const uint8* Pixels = bView ? RawView.GetData() : RawData.GetData();
+    const int stride = bView ? RawViewStride : Width * (RawFormat == ERGBFormat::Gray ? 1 : 4);
+    ON_SCOPE_EXIT
+    {
+        if (bView)
+        {
+            // Borrowed for this call only: the caller may free the rows as soon as we return
+            RawView = TConstArrayView64<uint8>();
+            RawViewStride = 0;
+            RawFormat = ERGBFormat::Invalid;
+        }
+    };
+    if ((!bView && RawData.Num() == 0) || Width == 0 || Height == 0 || RawFormat == ERGBFormat::Invalid)
     {
         // UE_LOG(LogTemp, Warning, TEXT("No raw data to compress for WebP. Returning empty array."));
         return TArray64<uint8>();
     }
 
     TArray64<uint8> OutCompressedData;
-    uint8_t* webp_output_buffer = nullptr;
-    size_t webp_output_size = 0;
-    int stride = 0;
 
+    WebPConfig Config;
+    if (!WebPConfigPreset(&Config, WEBP_PRESET_DEFAULT, (float)Quality))
+    {
+        return TArray64<uint8>();
+    }
+    Config.method = FMath::Clamp(EncodeOptions.Method, 0, 6);
+    Config.thread_level = EncodeOptions.bUseThreads ? 1 : 0;
+    Config.lossless = EncodeOptions.bLossless ? 1 : 0;
+
+    WebPPicture Picture;
+    if (!WebPPictureInit(&Picture))
+    {
+        return TArray64<uint8>();
+    }
+    // Same choice the simple WebPEncode*() API makes; rescaling wants ARGB so the YUV conversion runs after it
+    Picture.use_argb = Config.lossless || EncodeOptions.IsScaled();
+    Picture.width = Width;
+    Picture.height = Height;
+    if (EncodeOptions.CancelFlag)
+    {
+        Picture.progress_hook = &EncodeProgressHook;
+        Picture.user_data = const_cast<std::atomic<bool>*>(EncodeOptions.CancelFlag);
+    }
+
+    int ImportOk = 0;
     if (RawFormat == ERGBFormat::RGBA && RawBitDepth == 8)
     {
-        stride = Width * 4;
-        webp_output_size = WebPEncodeRGBA(RawData.GetData(), Width, Height, stride, (float)Quality, &webp_output_buffer);
+        ImportOk = EncodeOptions.bIgnoreAlpha ? WebPPictureImportRGBX(&Picture, Pixels, stride) : WebPPictureImportRGBA(&Picture, Pixels, stride);
     }
     else if (RawFormat == ERGBFormat::BGRA && RawBitDepth == 8)
     {
-        stride = Width * 4;
-        webp_output_size = WebPEncodeBGRA(RawData.GetData(), Width, Height, stride, (float)Quality, &webp_output_buffer);
+        ImportOk = EncodeOptions.bIgnoreAlpha ? WebPPictureImportBGRX(&Picture, Pixels, stride) : WebPPictureImportBGRA(&Picture, Pixels, stride);
+    }
+    else if (RawFormat == ERGBFormat::Gray && RawBitDepth == 8)
+    {
+        // Expanded to BGRX first; libwebp's RGB->YUV conversion then gives back the same luma (U = V = 128)
+        LLM_SCOPE_BYTAG(WebP_Scratch);
+        TArray64<uint8> Expanded = FWebPBufferPool::Get().Acquire((int64)Width * Height * 4);
+        for (int32 Row = 0; Row < Height; ++Row)
+        {
+            const uint8* Src = Pixels + (int64)Row * stride;
+            uint8* Dst = Expanded.GetData() + (int64)Row * Width * 4;
+            for (int32 X = 0; X < Width; ++X, Dst += 4)
+            {
+                Dst[0] = Dst[1] = Dst[2] = Src[X];
+                Dst[3] = 0xFF;
+            }
+        }
+        ImportOk = WebPPictureImportBGRX(&Picture, Expanded.GetData(), Width * 4);
+        FWebPBufferPool::Get().Release(Expanded);
     }
     // No ERGBFormat::RGB case here because it's not in the standard enum
     else
@@ -421,14 +801,33 @@ TArray64<uint8> FWebpImageWrapper::GetCompressed(int32 Quality)
         return TArray64<uint8>();
     }
 
-    if (webp_output_size > 0 && webp_output_buffer != nullptr)
+    WebPMemoryWriter Writer;
+    WebPMemoryWriterInit(&Writer);
+    Picture.writer = WebPMemoryWrite;
+    Picture.custom_ptr = &Writer;
+
+    bool bEncoded = false;
+    {
+        // Encoder working buffers and the memory writer are libwebp-side allocations
+        LLM_SCOPE_BYTAG(WebP_Scratch);
+        if (ImportOk && EncodeOptions.IsScaled())
+        {
+            ImportOk = WebPPictureRescale(&Picture, EncodeOptions.ScaledWidth, EncodeOptions.ScaledHeight);
+        }
+        bEncoded = ImportOk && WebPEncode(&Config, &Picture);
+        WebPPictureFree(&Picture);
+    }
+
+    if (bEncoded && Writer.size > 0 && Writer.mem != nullptr)
     {
-        OutCompressedData.Append(webp_output_buffer, webp_output_size);
-        WebPFree(webp_output_buffer);
+        LLM_SCOPE_BYTAG(WebP_Compressed);
+        OutCompressedData.Append(Writer.mem, Writer.size);
+        WebPMemoryWriterClear(&Writer);
         return OutCompressedData;
     }
     else
     {
+        WebPMemoryWriterClear(&Writer);
         // UE_LOG(LogTemp, Error, TEXT("WebPEncode failed for format %d. Returning empty array."), (int32)RawFormat);
         return TArray64<uint8>();
     }
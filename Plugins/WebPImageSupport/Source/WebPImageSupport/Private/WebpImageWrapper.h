@@ -3,14 +3,62 @@
 
 #include "CoreMinimal.h"
 #include "IImageWrapper.h"
+#include "WebPAlphaMask.h"
+#include "WebPPacked.h"
+#include <atomic>
 // Forward declare from libwebp if necessary, or include webp/decode.h here
 // #include "webp/decode.h" // Example, better in .cpp if possible
 
-class FWebpImageWrapper : public IImageWrapper
+// Decoder knobs forwarded to WebPDecoderOptions. Defaults match the simple WebPDecode*Into() API.
+struct FWebPDecodeOptions
+{
+    bool bUseThreads = false;          // options.use_threads
+    bool bBypassFiltering = false;     // options.bypass_filtering
+    bool bNoFancyUpsampling = false;   // options.no_fancy_upsampling
+    bool bPremultiplyAlpha = false;    // MODE_bgrA / MODE_rgbA output, ready for premultiplied compositing
+    // options.use_scaling: decoder-side downscale (previews, thumbnails). 0 = full size. Honoured by DecodeInto and
+    // FWebPIncrementalDecoder; RawData (GetRaw/ReleaseRaw) is always full size.
+    int32 ScaledWidth = 0;
+    int32 ScaledHeight = 0;
+    // > 0: the decode also builds an FWebPAlphaMask (GetAlphaMask) with one bit per AlphaMaskCellSize^2 pixels, so
+    // hit testing can outlive the pixels. Alpha >= AlphaMaskThreshold is a hit.
+    int32 AlphaMaskCellSize = 0;
+    uint8 AlphaMaskThreshold = 128;
+
+    bool IsScaled() const { return ScaledWidth > 0 && ScaledHeight > 0; }
+    FIntPoint GetOutputSize(int32 ImageWidth, int32 ImageHeight) const
+    {
+        return IsScaled() ? FIntPoint(ScaledWidth, ScaledHeight) : FIntPoint(ImageWidth, ImageHeight);
+    }
+};
+
+// Encoder knobs forwarded to WebPConfig. Defaults match the simple WebPEncode*() API.
+struct FWebPEncodeOptions
+{
+    int32 Method = 4;                  // config.method, 0 (fast) .. 6 (slower, better)
+    bool bUseThreads = false;          // config.thread_level
+    bool bLossless = false;            // config.lossless
+    // WebPPictureRescale right after import, on the ARGB picture before the YUV conversion, so a thumbnail of a big
+    // capture costs the conversion and encode of the thumbnail only. 0 = source size.
+    int32 ScaledWidth = 0;
+    int32 ScaledHeight = 0;
+    bool bIgnoreAlpha = false;         // WebPPictureImport*X: opaque output whatever byte 3 holds (viewport readbacks)
+    // Polled by picture.progress_hook; setting it from any thread makes GetCompressed give up and return nothing.
+    // Must outlive the GetCompressed call.
+    const std::atomic<bool>* CancelFlag = nullptr;
+
+    bool IsScaled() const { return ScaledWidth > 0 && ScaledHeight > 0; }
+};
+
+// Exported: the VNM game module drives the wrapper directly for its loaders
+class WEBPIMAGESUPPORT_API FWebpImageWrapper : public IImageWrapper
 {
 public:
     FWebpImageWrapper();
-    virtual ~FWebpImageWrapper() override = default; // Good practice to have a virtual destructor
+    virtual ~FWebpImageWrapper() override; // Unregisters from FWebPMemoryTracker
+
+    FWebpImageWrapper(const FWebpImageWrapper&) = delete;
+    FWebpImageWrapper& operator=(const FWebpImageWrapper&) = delete;
 
     //~ Begin IImageWrapper Interface
     virtual bool SetCompressed(const void* InCompressedData, int64 InCompressedSize) override;
@@ -32,18 +80,87 @@ public:
     //~ End IImageWrapper Interface
 
     // Helper to get compressed size (not an override)
-    int64 GetSizeOfCompressedData() const { return CompressedData.Num(); }
+    int64 GetSizeOfCompressedData() const { return GetCompressedSpan().Num(); }
+
+    // Like SetCompressed but borrows the caller's bytes instead of copying them (e.g. a slice of a
+    // memory-mapped bundle). The memory must stay valid until the wrapper is destroyed or given new data.
+    bool SetCompressedView(const void* InCompressedData, int64 InCompressedSize);
+
+    // Encode-side counterpart: GetCompressed imports straight from the caller's rows (InBytesPerRow apart, 0 = tight),
+    // so a padded readback, a sub-rectangle of a bigger image or a locked mip is encoded without first being copied
+    // into RawData. Same formats as SetRaw (8-bit BGRA, RGBA, Gray). The memory must stay valid until GetCompressed returns, which also forgets the
+    // view (a second GetCompressed needs a new SetRawView); GetRaw doesn't see it.
+    bool SetRawView(const void* InRawData, int64 InRawSize, int32 InWidth, int32 InHeight, ERGBFormat InFormat, int32 InBitDepth, int32 InBytesPerRow = 0);
+
+    // Options used by the next PerformUncompression / GetCompressed call (not overrides)
+    void SetDecodeOptions(const FWebPDecodeOptions& InOptions) { DecodeOptions = InOptions; }
+    void SetEncodeOptions(const FWebPEncodeOptions& InOptions) { EncodeOptions = InOptions; }
+    const FWebPDecodeOptions& GetDecodeOptions() const { return DecodeOptions; }
+    const FWebPEncodeOptions& GetEncodeOptions() const { return EncodeOptions; }
+
+    // Formats: 8-bit BGRA/RGBA, and Gray (one byte of full-range luma per pixel, alpha dropped; masks, rule images)
+    // at a quarter of the memory and bandwidth. The 16-bit EWebPPackedFormat outputs are DecodeInto only.
+
+    // Decodes if needed and moves the pixels out instead of copying them (the wrapper is left without raw data).
+    // The buffer comes from FWebPBufferPool; hand it back with FWebPBufferPool::Release when done.
+    bool ReleaseRaw(const ERGBFormat InFormat, int32 InBitDepth, TArray64<uint8>& OutRawData);
+
+    // Decodes straight into caller-owned memory (e.g. a locked texture mip) instead of RawData, writing rows
+    // OutStride bytes apart, at DecodeOptions.GetOutputSize(). Nothing is kept in the wrapper, so repeated calls decode again.
+    bool DecodeInto(const ERGBFormat InFormat, int32 InBitDepth, void* OutPixels, int64 OutStride, int64 OutBufferSize);
+    // Same, to 2 bytes per pixel (UI art). bPremultiplyAlpha applies to RGBA4444; no alpha mask is built.
+    bool DecodeInto(EWebPPackedFormat InFormat, void* OutPixels, int64 OutStride, int64 OutBufferSize);
+
+    // From the bitstream header: false means every pixel is opaque (RGB565 loses nothing but precision)
+    bool HasAlpha() const { return bHasAlpha; }
+
+    // Mask built by the last successful decode when DecodeOptions.AlphaMaskCellSize > 0 (invalid otherwise), at that
+    // decode's output size
+    const FWebPAlphaMask& GetAlphaMask() const { return AlphaMask; }
+    FWebPAlphaMask ReleaseAlphaMask()
+    {
+        FWebPAlphaMask Released = MoveTemp(AlphaMask);
+        AlphaMask.Reset();
+        return Released;
+    }
+
+    // Name shown by WebP.DumpBuffers (asset path, scene, system...)
+    void SetDebugOwner(const FString& InOwner);
 
 
 private:
     // Internal helper for decompression logic, not virtual, not an override
     bool PerformUncompression(const ERGBFormat InFormat, int32 InBitDepth);
 
+    // Validates the current compressed bytes with WebPGetFeatures and fills Width/Height/bHasAlpha
+    bool ReadCompressedInfo();
+
+    // Shared by the DecodeInto overloads; InOutputMode is a WEBP_CSP_MODE (libwebp stays out of this header)
+    bool DecodeIntoMode(int32 InOutputMode, void* OutPixels, int64 OutStride, int64 OutBufferSize);
+
+    // Borrowed view if one is set, otherwise the owned CompressedData
+    TConstArrayView64<uint8> GetCompressedSpan() const;
+
+    // Fills AlphaMask from freshly decoded 4-channel rows if the decode options ask for one; resets it otherwise
+    void BuildAlphaMask(const uint8* Pixels, int32 OutWidth, int32 OutHeight, int64 Stride, int32 BytesPerPixel);
+
+    // Pushes current buffer sizes to FWebPMemoryTracker; call after CompressedData/RawData change
+    void UpdateTrackedMemory();
+
+    // CompressedData and RawData are drawn from and returned to FWebPBufferPool
     TArray64<uint8> CompressedData;
+    TConstArrayView64<uint8> CompressedView; // Non-owning alternative to CompressedData (SetCompressedView)
     TArray64<uint8> RawData; // Stores the uncompressed pixel data
+    TConstArrayView64<uint8> RawView; // Non-owning alternative to RawData for encoding (SetRawView)
+    int32 RawViewStride = 0;
+    FWebPAlphaMask AlphaMask;
 
     int32 Width;
     int32 Height;
     ERGBFormat RawFormat; // The format of the data in RawData after decoding
     int32 RawBitDepth;    // The bit depth of the data in RawData after decoding
+    bool bHasAlpha;
+
+    FWebPDecodeOptions DecodeOptions;
+    FWebPEncodeOptions EncodeOptions;
 };
\ No newline at end of file
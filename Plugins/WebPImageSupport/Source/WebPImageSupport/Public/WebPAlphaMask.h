@@ -0,0 +1,58 @@
+// WebPAlphaMask.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WebPSimd.h"
+
+/**
+ * Alpha coverage of an image at one bit per pixel (or per CellSize x CellSize block), for per-pixel hit testing such
+ * as clicking on sprites, without keeping the decoded pixels around after the texture upload. A 2048x2048 sprite is
+ * 512 KB at one bit per pixel and 32 KB with 4x4 cells, against 16 MB of BGRA.
+ *
+ * A cell is set when any of its pixels passes the threshold, so downsampled masks err on the side of a hit at edges.
+ */
+class WEBPIMAGESUPPORT_API FWebPAlphaMask
+{
+public:
+    // Pixels are BGRA8 or RGBA8 (alpha in byte 3), rows Stride bytes apart. Alpha >= Threshold counts as a hit.
+    bool Build(const uint8* Pixels, int32 InWidth, int32 InHeight, int64 Stride, uint8 Threshold = 128, int32 InCellSize = 1);
+    void Reset();
+
+    bool IsValid() const { return Width > 0; }
+    FIntPoint GetSize() const { return FIntPoint(Width, Height); }        // Image pixels covered
+    FIntPoint GetMaskSize() const { return FIntPoint(MaskWidth, MaskHeight); }
+    int32 GetCellSize() const { return CellSize; }
+    int64 GetAllocatedSize() const { return Bits.GetAllocatedSize(); }
+
+    // Image pixel coordinates; false outside the image
+    bool HitTest(int32 X, int32 Y) const
+    {
+        if (X < 0 || Y < 0 || X >= Width || Y >= Height)
+        {
+            return false;
+        }
+        const int32 CellX = X / CellSize;
+        return ((Bits[(Y / CellSize) * WordsPerRow + (CellX >> 6)] >> (CellX & 63)) & 1) != 0;
+    }
+
+    // 0..1 across the image, whatever size it is displayed at (widget local position / size)
+    bool HitTestUV(const FVector2D& UV) const
+    {
+        return HitTest(FMath::FloorToInt32(UV.X * Width), FMath::FloorToInt32(UV.Y * Height));
+    }
+
+private:
+    int32 Width = 0;
+    int32 Height = 0;
+    int32 CellSize = 1;
+    int32 MaskWidth = 0;
+    int32 MaskHeight = 0;
+    int32 WordsPerRow = 0;
+    TArray<uint64> Bits;    // Row-major, each mask row padded to whole words, LSB = leftmost cell
+};
+
+namespace WebPAlphaMask
+{
+    // Bit N of OutBits (64 per word, LSB first) = Pixels[N * 4 + 3] >= Threshold. Writes (NumPixels + 63) / 64 words.
+    WEBPIMAGESUPPORT_API void ThresholdRow(EWebPSimdBackend Backend, const uint8* Pixels, int32 NumPixels, uint8 Threshold, uint64* OutBits);
+}
@@ -0,0 +1,115 @@
+// WebPAnimation.h
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FWebPEncodeOptions;
+
+// ANMF disposal: what happens to a frame's rectangle before the next frame is drawn
+enum class EWebPFrameDispose : uint8
+{
+    None,           // Leave it as drawn
+    Background,     // Clear it to transparent
+};
+
+// ANMF blending: how a frame is drawn over what is already on the canvas
+enum class EWebPFrameBlend : uint8
+{
+    AlphaBlend,     // Non-premultiplied "over"
+    NoBlend,        // Overwrite the rectangle
+};
+
+struct FWebPAnimationFrame
+{
+    FIntRect Rect;                      // Canvas pixels the frame covers (WebPIterator x/y_offset, width, height)
+    int32 DurationMs = 0;
+    EWebPFrameDispose Dispose = EWebPFrameDispose::None;
+    EWebPFrameBlend Blend = EWebPFrameBlend::AlphaBlend;
+    bool bHasAlpha = false;
+    TConstArrayView64<uint8> Bitstream; // Frame payload (ALPH + VP8, or VP8L) inside the file
+};
+
+// Frame table of an animated WebP, built once with WebPDemux. Borrows the file bytes, which must stay valid.
+// Still images parse as a single frame covering the canvas.
+class WEBPIMAGESUPPORT_API FWebPAnimation
+{
+public:
+    bool InitializeView(TConstArrayView64<uint8> Data);
+
+    bool IsValid() const { return Frames.Num() > 0; }
+    FIntPoint GetCanvasSize() const { return CanvasSize; }
+    int32 GetNumFrames() const { return Frames.Num(); }
+    int32 GetLoopCount() const { return LoopCount; } // 0 = forever
+    int32 GetTotalDurationMs() const { return TotalDurationMs; }
+    const FWebPAnimationFrame& GetFrame(int32 Index) const { return Frames[Index]; }
+
+private:
+    FIntPoint CanvasSize = FIntPoint::ZeroValue;
+    int32 LoopCount = 0;
+    int32 TotalDurationMs = 0;
+    TArray<FWebPAnimationFrame> Frames;
+};
+
+/**
+ * Reconstructs the canvas frame by frame (dispose, then decode and blend the new frame's rectangle) and reports
+ * which part of the canvas changed, so texture uploads can be limited to that rectangle instead of the whole canvas.
+ * The canvas is BGRA8 with straight alpha, pooled.
+ */
+class WEBPIMAGESUPPORT_API FWebPAnimationCanvas
+{
+public:
+    explicit FWebPAnimationCanvas(const FWebPAnimation& InAnimation);
+    ~FWebPAnimationCanvas();
+
+    FWebPAnimationCanvas(const FWebPAnimationCanvas&) = delete;
+    FWebPAnimationCanvas& operator=(const FWebPAnimationCanvas&) = delete;
+
+    // Draws the next frame, wrapping to frame 0 after the last. OutDirtyRect is the part of the canvas that differs
+    // from the previous frame: the new frame's rectangle plus the previous one if it was disposed, or the whole
+    // canvas when starting over.
+    bool DecodeNextFrame(FIntRect& OutDirtyRect);
+
+    // Back to before frame 0
+    void Reset() { FrameIndex = INDEX_NONE; }
+
+    // Puts a previously captured frame back on the canvas (canvas-sized BGRA8), so decoding continues from there
+    void Restore(int32 InFrameIndex, const uint8* InPixels);
+
+    // What DecodeNextFrame reports for FrameIndex, from the frame table alone (no decoding)
+    static FIntRect GetDirtyRect(const FWebPAnimation& Animation, int32 FrameIndex);
+
+    int32 GetFrameIndex() const { return FrameIndex; } // Frame on the canvas, INDEX_NONE before the first
+    FIntPoint GetSize() const { return Animation.GetCanvasSize(); }
+    const TArray64<uint8>& GetPixels() const { return Pixels; }
+    int64 GetStride() const { return (int64)Animation.GetCanvasSize().X * 4; }
+
+private:
+    void Clear(const FIntRect& Rect);
+
+    const FWebPAnimation& Animation;
+    TArray64<uint8> Pixels;
+    TArray64<uint8> Scratch;    // Frames that alpha-blend decode here first
+    int32 FrameIndex = INDEX_NONE;
+};
+
+// Writes an animated WebP (VP8X + ANIM + ANMF chunks) from individually encoded frame rectangles.
+// For tools and benchmarks that need animations with known dirty rectangles.
+class WEBPIMAGESUPPORT_API FWebPAnimationBuilder
+{
+public:
+    FWebPAnimationBuilder(FIntPoint InCanvasSize, int32 InLoopCount = 0);
+
+    // BGRA is Rect.Width() x Rect.Height(), tightly packed. WebP stores offsets halved, so Rect.Min must be even.
+    bool AddFrame(const uint8* BGRA, const FIntRect& Rect, int32 DurationMs, EWebPFrameDispose Dispose, EWebPFrameBlend Blend,
+                  const FWebPEncodeOptions& Options, int32 Quality, FString* OutError = nullptr);
+
+    int32 NumFrames() const { return NumAddedFrames; }
+    TArray64<uint8> Finish() const;
+
+private:
+    FIntPoint CanvasSize;
+    int32 LoopCount = 0;
+    int32 NumAddedFrames = 0;
+    bool bHasAlpha = false;
+    TArray64<uint8> FrameChunks;   // ANMF chunks so far
+};
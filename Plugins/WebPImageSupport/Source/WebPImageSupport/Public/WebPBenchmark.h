@@ -0,0 +1,87 @@
+// WebPBenchmark.h
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EWebPSimdBackend : uint8;
+
+// One measured configuration (e.g. "decode, 1920x1080, photo, threads on").
+// Latencies are per-image wall times; Bytes is the uncompressed pixel payload processed per iteration,
+// so MB/s is comparable between decode and encode.
+struct WEBPIMAGESUPPORT_API FWebPBenchmarkResult
+{
+    FString Suite;
+    FString Case;
+    TMap<FString, FString> Params;
+
+    TArray<double> LatenciesSeconds;
+    int64 BytesPerIteration = 0;
+
+    // Free-form extra numbers a suite wants in the report (compressed size, megapixels/s, ...)
+    TMap<FString, double> Metrics;
+
+    // "width" / "height" params, which nearly every case reports
+    void AddSizeParams(int32 Width, int32 Height);
+    // "cpu" param of cases run once per WebPSimd::GetAvailableBackends()
+    void AddBackendParam(EWebPSimdBackend Backend);
+
+    double GetPercentileMs(double Percentile) const;
+    double GetMeanMs() const;
+    double GetMegabytesPerSecond() const;
+};
+
+// Passed to every suite; collects results and carries the command-line knobs.
+class WEBPIMAGESUPPORT_API FWebPBenchmarkContext
+{
+public:
+    int32 Iterations = 20;
+    int32 WarmupIterations = 2;
+    bool bQuick = false;        // Smaller sizes / fewer iterations, used by the automation tests
+
+    FWebPBenchmarkResult& AddResult(const FString& Suite, const FString& Case);
+    const TArray<FWebPBenchmarkResult>& GetResults() const { return Results; }
+
+    // Times Body() Iterations times (after warmup) and appends the latencies to OutResult
+    void Measure(FWebPBenchmarkResult& OutResult, TFunctionRef<void()> Body) const;
+
+    // Machine-readable report: { "build": {...}, "results": [ {...}, ... ] }
+    FString ToJson() const;
+    void LogSummary() const;
+
+private:
+    TArray<FWebPBenchmarkResult> Results;
+};
+
+typedef TFunction<void(FWebPBenchmarkContext&)> FWebPBenchmarkSuiteFunc;
+
+// Suites self-register from their translation units (plugin or game module) so the commandlet and
+// the automation tests see the same list.
+class WEBPIMAGESUPPORT_API FWebPBenchmarkRegistry
+{
+public:
+    static FWebPBenchmarkRegistry& Get();
+
+    void Register(const FString& Name, FWebPBenchmarkSuiteFunc Func);
+    void Unregister(const FString& Name);
+
+    TArray<FString> GetSuiteNames() const;
+    bool RunSuite(const FString& Name, FWebPBenchmarkContext& Context) const;
+
+private:
+    TMap<FString, FWebPBenchmarkSuiteFunc> Suites;
+};
+
+struct FWebPBenchmarkSuiteRegistrar
+{
+    FWebPBenchmarkSuiteRegistrar(const TCHAR* InName, FWebPBenchmarkSuiteFunc Func)
+        : Name(InName)
+    {
+        FWebPBenchmarkRegistry::Get().Register(Name, MoveTemp(Func));
+    }
+    ~FWebPBenchmarkSuiteRegistrar()
+    {
+        FWebPBenchmarkRegistry::Get().Unregister(Name);
+    }
+
+    FString Name;
+};
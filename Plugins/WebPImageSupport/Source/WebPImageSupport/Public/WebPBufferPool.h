@@ -0,0 +1,102 @@
+// WebPBufferPool.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/**
+ * Recycles the large byte buffers the WebP pipeline goes through for every image (compressed input, decoded
+ * pixels) instead of handing them back to the general allocator, which fragments under scene-load churn.
+ *
+ * Buffers are bucketed into size classes, four per power of two from MinPooledBytes up to MaxPooledBytes; a
+ * request is served from its own class (at most 25% slack) or the one above. Small classes (up to MaxThreadCachedBytes) also go through a
+ * per-thread cache that is checked before the shared, locked buckets. Thread-cached buffers count against
+ * MaxCachedBytes like the shared ones. Sizes outside the pooled range fall through to the general allocator.
+ *
+ * Any TArray64<uint8> may be released into the pool, not only ones that came from Acquire. Buffers that are acquired
+ * and never released are still counted as outstanding.
+ *
+ * "WebP.BufferPool" prints stats, "WebP.BufferPool.Trim" frees every cached buffer (also done on memory trim).
+ */
+class WEBPIMAGESUPPORT_API FWebPBufferPool
+{
+public:
+    static constexpr int64 MinPooledBytes = 64 * 1024;
+    static constexpr int64 MaxPooledBytes = 1024ll * 1024 * 1024;
+    static constexpr int64 MaxThreadCachedBytes = 4 * 1024 * 1024;
+
+    struct FStats
+    {
+        int64 Acquires = 0;          // Pooled-range requests
+        int64 ThreadCacheHits = 0;
+        int64 SharedHits = 0;
+        int64 Misses = 0;            // Fresh allocations
+        int64 Releases = 0;          // Buffers taken back for reuse
+        int64 Discards = 0;          // Buffers freed because they were out of range or the cache was full
+        int64 CachedBytes = 0;       // Idle in the thread caches and shared buckets
+        int64 OutstandingBytes = 0;  // Handed out by Acquire and not released yet
+        int64 PeakCachedBytes = 0;
+        int64 PeakFootprintBytes = 0; // Peak of CachedBytes + OutstandingBytes
+
+        double GetReuseRate() const { return Acquires > 0 ? double(ThreadCacheHits + SharedHits) / Acquires : 0.0; }
+    };
+
+    static FWebPBufferPool& Get();
+
+    // Buffer with Num() == Size; contents are uninitialized. Allocates at the caller's LLM scope on a miss.
+    TArray64<uint8> Acquire(int64 Size);
+
+    // Takes the buffer's allocation for reuse (or frees it) and leaves Buffer empty
+    void Release(TArray64<uint8>& Buffer);
+
+    // Frees every buffer in the shared buckets and in the calling thread's cache. Other threads can't be reached from
+    // here; each frees its cache the next time it acquires or releases a small buffer.
+    void Trim();
+
+    // Idle bytes kept before releases start freeing instead (WebP.BufferPool.MaxCachedMB)
+    void SetMaxCachedBytes(int64 Bytes);
+    int64 GetMaxCachedBytes() const;
+
+    // When disabled Acquire/Release behave like plain allocate/free (benchmarks, A/B tests)
+    void SetEnabled(bool bInEnabled);
+    bool IsEnabled() const;
+
+    FStats GetStats() const;
+    void ResetStats();
+    void Dump(FOutputDevice& Ar) const;
+
+    // Smallest class that fits Size / largest class a buffer of Capacity can serve; INDEX_NONE outside the pooled range
+    static int32 GetClassForRequest(int64 Size);
+    static int32 GetClassForCapacity(int64 Capacity);
+    static int64 GetClassSize(int32 ClassIndex);
+    static int32 GetNumClasses();
+
+private:
+    struct FThreadCache;
+    friend struct FThreadCache;
+
+    FWebPBufferPool();
+
+    FThreadCache& GetThreadCache();
+    void AddCached(int64 Delta);
+    void AddOutstanding(int64 Delta);
+    void UpdatePeaks();
+
+    mutable FCriticalSection Mutex;
+    TArray<TArray<TArray64<uint8>>> Buckets; // Indexed by size class; buffers inside are empty with capacity >= class size
+
+    std::atomic<bool> bEnabled { true };
+    std::atomic<int64> MaxCachedBytes { 256ll * 1024 * 1024 };
+    std::atomic<uint32> TrimEpoch { 0 };    // Bumped by Trim(); a thread cache from an older epoch is dropped on access
+
+    std::atomic<int64> Acquires { 0 };
+    std::atomic<int64> ThreadCacheHits { 0 };
+    std::atomic<int64> SharedHits { 0 };
+    std::atomic<int64> Misses { 0 };
+    std::atomic<int64> Releases { 0 };
+    std::atomic<int64> Discards { 0 };
+    std::atomic<int64> CachedBytes { 0 };
+    std::atomic<int64> OutstandingBytes { 0 };
+    std::atomic<int64> PeakCachedBytes { 0 };
+    std::atomic<int64> PeakFootprintBytes { 0 };
+};
@@ -0,0 +1,231 @@
+// WebPBundle.h
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Image pack format (.webpbundle): one file per chapter instead of hundreds of loose .webp files.
+ *
+ *   FWebPBundleHeader
+ *   FWebPBundleEntry[EntryCount]      sorted by NameHash, binary searched at runtime
+ *   FWebPBundlePlacement[EntryCount] only with EWebPBundleFlags::HasPlacements, parallel to the entries
+ *   UTF-8 name table                  for tooling/diagnostics only, never touched by lookups
+ *   WebP blobs                        each starting on a BlobAlignment boundary
+ *
+ * Entries whose images are identical share one blob (same DataOffset), so a duplicate costs an index entry only.
+ * FVNImageLoader maps such entries to one canonical id, so the image is decoded and cached once.
+ *
+ * Trimmed entries store only the non-transparent part of the authored canvas; their placement records where that
+ * part sits, so the runtime can put it back. Bundles with placements are version 2, which readers that predate
+ * placements refuse rather than showing the trimmed images out of place; bundles without are still written as 1.
+ *
+ * All fields are little-endian; the reader maps the file and hands blob slices to the decoder as-is.
+ */
+namespace WebPBundle
+{
+    static constexpr uint32 Magic = 0x42505756; // "VWPB"
+    static constexpr uint32 Version = 2;               // Newest the reader accepts
+    static constexpr uint32 MinVersion = 1;
+    static constexpr uint32 PlacementsVersion = 2;     // First version with EWebPBundleFlags; written only when needed
+    static constexpr uint32 BlobAlignment = 64;
+
+    // Lowercase, forward slashes, no leading slash, ".webp" extension stripped: "Backgrounds/School_Day.webp" -> "backgrounds/school_day"
+    WEBPIMAGESUPPORT_API FString NormalizeName(FStringView Name);
+    WEBPIMAGESUPPORT_API uint64 HashName(FStringView Name);
+}
+
+enum class EWebPBundleEntryFlags : uint32
+{
+    None = 0,
+    HasAlpha = 1 << 0,
+    Animated = 1 << 1,
+    Lossless = 1 << 2,
+};
+ENUM_CLASS_FLAGS(EWebPBundleEntryFlags);
+
+enum class EWebPBundleFlags : uint32
+{
+    None = 0,
+    HasPlacements = 1 << 0,
+};
+ENUM_CLASS_FLAGS(EWebPBundleFlags);
+
+struct FWebPBundleHeader
+{
+    uint32 Magic;
+    uint32 Version;
+    uint32 EntryCount;
+    uint32 Flags;          // EWebPBundleFlags from version 2 (reserved, always 0, in version 1)
+    uint64 IndexOffset;
+    uint64 NamesOffset;
+    uint64 NamesSize;
+    uint64 DataOffset;
+};
+static_assert(sizeof(FWebPBundleHeader) == 48, "FWebPBundleHeader is an on-disk layout");
+
+struct FWebPBundleEntry
+{
+    uint64 NameHash;
+    uint64 DataOffset;     // From the start of the file, BlobAlignment aligned; shared by deduplicated entries
+    uint32 DataSize;
+    uint32 Width;
+    uint32 Height;
+    uint32 Flags;          // EWebPBundleEntryFlags
+    uint32 NameOffset;     // Into the name table
+    uint32 NameLength;     // UTF-8 bytes, not null terminated
+};
+static_assert(sizeof(FWebPBundleEntry) == 40, "FWebPBundleEntry is an on-disk layout");
+
+// Where a trimmed image goes on its authored canvas. Untrimmed: zero offset, canvas = image size.
+struct FWebPBundlePlacement
+{
+    uint16 OffsetX;
+    uint16 OffsetY;
+    uint16 CanvasWidth;    // WebP caps dimensions at 16383, so 16 bits are enough
+    uint16 CanvasHeight;
+};
+static_assert(sizeof(FWebPBundlePlacement) == 8, "FWebPBundlePlacement is an on-disk layout");
+
+// Runtime side: memory-maps a bundle; lookups are a binary search over the mapped index and return
+// slices that can be passed to FWebpImageWrapper::SetCompressedView without copying.
+class WEBPIMAGESUPPORT_API FWebPBundleReader
+{
+public:
+    FWebPBundleReader();
+    ~FWebPBundleReader();
+
+    FWebPBundleReader(const FWebPBundleReader&) = delete;
+    FWebPBundleReader& operator=(const FWebPBundleReader&) = delete;
+
+    bool Open(const FString& Filename);
+    void Close();
+    bool IsOpen() const { return Header != nullptr; }
+
+    const FString& GetFilename() const { return Filename; }
+    int32 Num() const { return Entries.Num(); }
+    TConstArrayView<FWebPBundleEntry> GetEntries() const { return Entries; }
+
+    const FWebPBundleEntry* Find(uint64 NameHash) const;
+    const FWebPBundleEntry* Find(FStringView Name) const { return Find(WebPBundle::HashName(WebPBundle::NormalizeName(Name))); }
+
+    // Compressed WebP bytes of an entry, pointing into the mapping (valid while the reader is open)
+    TConstArrayView64<uint8> GetData(const FWebPBundleEntry& Entry) const;
+    // Asks the OS to page the entry's bytes in now rather than on first touch during a decode. No-op when not mapped.
+    void PreloadHint(const FWebPBundleEntry& Entry) const;
+    FString GetName(const FWebPBundleEntry& Entry) const;
+
+    // Offset and canvas size of a trimmed entry; the identity placement for everything else
+    FWebPBundlePlacement GetPlacement(const FWebPBundleEntry& Entry) const;
+
+private:
+    bool Validate(int64 FileSize);
+
+    FString Filename;
+    TUniquePtr<IMappedFileHandle> MappedHandle;
+    TUniquePtr<IMappedFileRegion> MappedRegion;
+    TArray64<uint8> FallbackData; // Used where the platform file layer can't map
+
+    const uint8* Base = nullptr;
+    const FWebPBundleHeader* Header = nullptr;
+    TConstArrayView<FWebPBundleEntry> Entries;
+    TConstArrayView<FWebPBundlePlacement> Placements; // Empty, or one per entry
+};
+
+// How FWebPBundleBuilder finds entries that can share a blob
+enum class EWebPBundleDedupe : uint8
+{
+    None,
+    Bytes,      // Byte-identical files (CityHash64 of the compressed bytes, confirmed with a compare)
+    Pixels,     // Also files that decode to the same pixels (re-encodes, different quality settings); keeps the smaller blob
+};
+
+// Tool side: collects .webp files and writes a bundle. Used by the WebPBundle commandlet.
+class WEBPIMAGESUPPORT_API FWebPBundleBuilder
+{
+public:
+    struct FDuplicate
+    {
+        FString Name;
+        FString CanonicalName;  // Entry whose blob it shares
+        int64 SourceBytes = 0;  // Size of the file that was added
+        bool bPixelMatch = false;
+    };
+
+    struct FDedupeReport
+    {
+        int32 Entries = 0;
+        int32 UniqueBlobs = 0;
+        int32 ByteDuplicates = 0;
+        int32 PixelDuplicates = 0;
+        int64 SourceBytes = 0;      // Sum of every added file
+        int64 BlobBytes = 0;        // What actually goes into the bundle (before alignment)
+        int64 GetBytesSaved() const { return SourceBytes - BlobBytes; }
+        TArray<FDuplicate> Duplicates;
+    };
+
+    // Before the first Add. Defaults to Bytes, which is free at runtime and exact.
+    void SetDedupe(EWebPBundleDedupe InMode) { check(Pending.Num() == 0); DedupeMode = InMode; }
+
+    struct FTrimReport
+    {
+        int32 Trimmed = 0;
+        int64 CanvasPixels = 0;     // Decoded pixels per load of every entry before trimming
+        int64 StoredPixels = 0;     // ... and after
+    };
+
+    // Before the first Add. Crops still images with alpha to the bounds of their non-transparent pixels and records
+    // the placement. Lossless sources are re-encoded losslessly (exact); lossy ones at LossyQuality. Images whose
+    // bounds save less than MinSavedFraction of the canvas are kept as they are.
+    void SetTrim(bool bInTrim, int32 InLossyQuality = 95, float InMinSavedFraction = 0.1f)
+    {
+        check(Pending.Num() == 0);
+        bTrim = bInTrim;
+        TrimLossyQuality = InLossyQuality;
+        TrimMinSavedFraction = InMinSavedFraction;
+    }
+
+    // Validates the bytes with WebPGetFeatures and records dimensions/flags. Fails on bad data or hash collisions.
+    bool Add(const FString& Name, TArray64<uint8>&& CompressedBytes, FString* OutError = nullptr);
+    bool AddFile(const FString& Name, const FString& Filename, FString* OutError = nullptr);
+
+    int32 Num() const { return Pending.Num(); }
+    bool Write(const FString& Filename, FString* OutError = nullptr) const;
+
+    FDedupeReport GetDedupeReport() const;
+    FTrimReport GetTrimReport() const;
+
+private:
+    struct FPending
+    {
+        FString Name;
+        uint64 Hash = 0;
+        TArray64<uint8> Bytes;      // Empty for duplicates
+        uint32 Width = 0;
+        uint32 Height = 0;
+        EWebPBundleEntryFlags Flags = EWebPBundleEntryFlags::None;
+        FWebPBundlePlacement Placement = {};
+        int64 SourceBytes = 0;
+        int32 CanonicalIndex = INDEX_NONE;  // Into Pending; set for duplicates
+        bool bPixelMatch = false;
+    };
+
+    // Index of a canonical entry identical to Bytes, or INDEX_NONE. May swap in Bytes as the canonical blob when
+    // it decodes to the same pixels in fewer bytes.
+    int32 FindDuplicate(const TArray64<uint8>& Bytes, EWebPBundleEntryFlags Flags, bool& bOutPixelMatch);
+
+    // Replaces Bytes with the cropped image if trimming pays off; OutPlacement is set either way
+    bool TrimTransparentBorder(const FString& Name, TArray64<uint8>& Bytes, EWebPBundleEntryFlags Flags, uint32& InOutWidth,
+                               uint32& InOutHeight, FWebPBundlePlacement& OutPlacement, FString* OutError);
+
+    TArray<FPending> Pending;
+    TMap<uint64, int32> HashToIndex;
+    TMultiMap<uint64, int32> ContentHashToIndex;    // Compressed bytes -> canonical entries
+    TMultiMap<uint64, int32> PixelHashToIndex;      // Decoded BGRA -> canonical entries
+    EWebPBundleDedupe DedupeMode = EWebPBundleDedupe::Bytes;
+    bool bTrim = false;
+    int32 TrimLossyQuality = 95;
+    float TrimMinSavedFraction = 0.1f;
+};
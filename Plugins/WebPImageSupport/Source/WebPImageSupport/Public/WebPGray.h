@@ -0,0 +1,16 @@
+// WebPGray.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WebPSimd.h"
+
+// Gray8 decode (ERGBFormat::Gray): libwebp decodes to MODE_YUV with the luma plane written straight into the output,
+// skipping the YUV->RGB conversion and 3/4 of the output bytes; this fixes up the range afterwards.
+namespace WebPGray
+{
+    // libwebp's YUV output is BT.601 limited range (luma 16..235); stretches it in place to 0..255:
+    //   Gray = (Clamp(Y - 16, 0, 219) * 298 + 128) >> 8
+    // Identical results on every backend
+    WEBPIMAGESUPPORT_API void ExpandLumaRow(EWebPSimdBackend Backend, uint8* Row, int32 NumPixels);
+    WEBPIMAGESUPPORT_API void ExpandLumaRow(uint8* Row, int32 NumPixels);
+}
@@ -0,0 +1,44 @@
+// WebPIncrementalDecoder.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IImageWrapper.h"
+
+struct FWebPDecodeOptions;
+
+/**
+ * libwebp's incremental decoder (WebPIDecode/WebPIUpdate) writing into caller-owned memory.
+ * Feed it a growing prefix of the bitstream; after each Update, GetDecodedRows() rows from the top of the
+ * output are final and may be read (e.g. uploaded) while decoding continues below them.
+ */
+class WEBPIMAGESUPPORT_API FWebPIncrementalDecoder
+{
+public:
+    enum class EStatus : uint8
+    {
+        NeedMoreData,
+        Done,
+        Error,
+    };
+
+    FWebPIncrementalDecoder();
+    ~FWebPIncrementalDecoder();
+
+    FWebPIncrementalDecoder(const FWebPIncrementalDecoder&) = delete;
+    FWebPIncrementalDecoder& operator=(const FWebPIncrementalDecoder&) = delete;
+
+    // Only 8-bit BGRA/RGBA. OutPixels must hold Options.GetOutputSize() rows OutStride bytes apart and stay valid until Reset/destruction.
+    bool Begin(ERGBFormat Format, const FWebPDecodeOptions& Options, uint8* OutPixels, int64 OutStride, int64 OutSize);
+
+    // Data is the whole bitstream received so far (same start pointer, growing size, as WebPIUpdate expects)
+    EStatus Update(const uint8* Data, int64 Size);
+
+    // Rows from the top that are fully decoded
+    int32 GetDecodedRows() const;
+
+    void Reset();
+
+private:
+    struct FImpl;
+    TUniquePtr<FImpl> Impl;
+};
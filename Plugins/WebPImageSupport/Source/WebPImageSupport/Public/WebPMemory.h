@@ -0,0 +1,46 @@
+// WebPMemory.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+// Low Level Memory Tracker tags (-llm, "stat LLMFULL", Insights memory). All children of "WebP".
+LLM_DECLARE_TAG_API(WebP, WEBPIMAGESUPPORT_API);
+LLM_DECLARE_TAG_API(WebP_Compressed, WEBPIMAGESUPPORT_API);      // FWebpImageWrapper::CompressedData and file loads
+LLM_DECLARE_TAG_API(WebP_Decoded, WEBPIMAGESUPPORT_API);         // FWebpImageWrapper::RawData and decoded copies
+// Allocations made while inside libwebp calls. libwebp allocates with CRT malloc, so this only sees them on
+// platforms/configurations where malloc is routed through FMemory; FMemory allocations made from inside the scope always land here.
+LLM_DECLARE_TAG_API(WebP_Scratch, WEBPIMAGESUPPORT_API);
+LLM_DECLARE_TAG_API(WebP_TextureStaging, WEBPIMAGESUPPORT_API);  // Transient texture mip data filled from decoded pixels
+
+// Live registry of wrapper buffers, independent of LLM so it also works in builds without -llm.
+// "WebP.DumpBuffers" prints every alive wrapper by size and owner.
+class WEBPIMAGESUPPORT_API FWebPMemoryTracker
+{
+public:
+    struct FEntry
+    {
+        FString Owner;
+        int64 CompressedBytes = 0;
+        int64 RawBytes = 0;
+        int32 Width = 0;
+        int32 Height = 0;
+    };
+
+    static FWebPMemoryTracker& Get();
+
+    void Register(const void* Key);
+    void Unregister(const void* Key);
+    void SetOwner(const void* Key, const FString& Owner);
+    void Update(const void* Key, int64 CompressedBytes, int64 RawBytes, int32 Width, int32 Height);
+
+    // Snapshot sorted by total bytes, largest first
+    TArray<FEntry> GetEntries() const;
+    int64 GetTotalBytes() const;
+
+    void Dump(FOutputDevice& Ar) const;
+
+private:
+    mutable FCriticalSection Mutex;
+    TMap<const void*, FEntry> Entries;
+};
@@ -0,0 +1,26 @@
+// WebPPacked.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WebPSimd.h"
+
+// Reduced-precision 16-bit outputs (MODE_RGB_565 / MODE_RGBA_4444) for UI art that doesn't need 8 bits per channel:
+// half the decoded and GPU memory of BGRA8. They have no ERGBFormat, so they go through
+// FWebpImageWrapper::DecodeInto(EWebPPackedFormat, ...).
+//
+// Output is one little-endian uint16 per pixel, in the bit order GPUs sample:
+//   RGB565:   R 15..11, G 10..5, B 4..0       (PF_B5G6R5_UNORM, DXGI_FORMAT_B5G6R5_UNORM)
+//   RGBA4444: A 15..12, R 11..8, G 7..4, B 3..0 (DXGI_FORMAT_B4G4R4A4_UNORM)
+enum class EWebPPackedFormat : uint8
+{
+    RGB565,
+    RGBA4444,
+};
+
+namespace WebPPacked
+{
+    // libwebp writes these modes as byte pairs in reading order ([r g][b a], [r g][g b]; decode.h), which is neither
+    // layout above on a little-endian CPU. Fixes a decoded row up in place: a 16-bit rotate per pixel.
+    WEBPIMAGESUPPORT_API void ToNativeRow(EWebPSimdBackend Backend, EWebPPackedFormat Format, uint8* Row, int32 NumPixels);
+    WEBPIMAGESUPPORT_API void ToNativeRow(EWebPPackedFormat Format, uint8* Row, int32 NumPixels);
+}
@@ -0,0 +1,49 @@
+// WebPSimd.h
+// Shared helpers for the hand-vectorized pixel kernels in this plugin and the VNM module.
+// Kernels are compiled for AVX2 / NEON next to a scalar fallback and picked at runtime.
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+    #define WEBP_SIMD_AVX2 1
+    #include <immintrin.h>
+    #if defined(__clang__) || defined(__GNUC__)
+        // Compile only the annotated function for AVX2; the rest of the module keeps the default target
+        #define WEBP_TARGET_AVX2 __attribute__((target("avx2")))
+    #else
+        // MSVC emits AVX2 intrinsics without /arch:AVX2
+        #define WEBP_TARGET_AVX2
+    #endif
+#else
+    #define WEBP_SIMD_AVX2 0
+    #define WEBP_TARGET_AVX2
+#endif
+
+#if PLATFORM_CPU_ARM_FAMILY && PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+    #define WEBP_SIMD_NEON 1
+    #include <arm_neon.h>
+#else
+    #define WEBP_SIMD_NEON 0
+#endif
+
+enum class EWebPSimdBackend : uint8
+{
+    Scalar,
+    AVX2,
+    NEON,
+};
+
+namespace WebPSimd
+{
+    // CPU + OS support, detected once
+    WEBPIMAGESUPPORT_API bool HasAVX2();
+
+    // Best backend for this machine, unless overridden (benchmarks compare backends on the same corpus)
+    WEBPIMAGESUPPORT_API EWebPSimdBackend GetBackend();
+    WEBPIMAGESUPPORT_API void SetBackendOverride(TOptional<EWebPSimdBackend> Backend);
+    // Every backend this machine and build can run, Scalar first, ignoring the override (for comparing them)
+    WEBPIMAGESUPPORT_API TArray<EWebPSimdBackend> GetAvailableBackends();
+
+    WEBPIMAGESUPPORT_API const TCHAR* ToString(EWebPSimdBackend Backend);
+}
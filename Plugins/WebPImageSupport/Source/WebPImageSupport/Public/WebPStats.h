@@ -0,0 +1,61 @@
+// WebPStats.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+// "stat WebP" in game, and a "WebP" channel in Unreal Insights (-trace=cpu,WebP).
+DECLARE_STATS_GROUP(TEXT("WebP"), STATGROUP_WebP, STATCAT_Advanced);
+
+// Pipeline stages, in the order a loader hits them
+DECLARE_CYCLE_STAT_EXTERN(TEXT("File Read"), STAT_WebP_FileRead, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("SetCompressed"), STAT_WebP_SetCompressed, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Decode"), STAT_WebP_Decode, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("GetRaw Copy"), STAT_WebP_GetRawCopy, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Texture Copy"), STAT_WebP_TextureCopy, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Texture Upload"), STAT_WebP_TextureUpload, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("SetRaw"), STAT_WebP_SetRaw, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Encode"), STAT_WebP_Encode, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Alpha Mask"), STAT_WebP_AlphaMask, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+
+// Per-frame counters (reset every frame)
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Images Decoded"), STAT_WebP_ImagesDecoded, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Compressed Bytes In"), STAT_WebP_CompressedBytes, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Bytes Decoded"), STAT_WebP_BytesDecoded, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Texture Bytes Uploaded"), STAT_WebP_UploadedBytes, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Cache Hits"), STAT_WebP_CacheHits, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Cache Misses"), STAT_WebP_CacheMisses, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Buffer Pool Hits"), STAT_WebP_PoolHits, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Buffer Pool Misses"), STAT_WebP_PoolMisses, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+
+// Running values (not reset)
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Images In Flight"), STAT_WebP_ImagesInFlight, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Buffer Pool Cached"), STAT_WebP_PoolCachedBytes, STATGROUP_WebP, WEBPIMAGESUPPORT_API);
+
+UE_TRACE_CHANNEL_EXTERN(WebPChannel, WEBPIMAGESUPPORT_API);
+
+TRACE_DECLARE_INT_COUNTER_EXTERN(WebP_ImagesInFlight);
+TRACE_DECLARE_INT_COUNTER_EXTERN(WebP_BytesDecoded);
+
+// Stat scope, which also shows up as a CPU event in Insights; without stats (Shipping, Test) an Insights CPU event on
+// the WebP channel instead. Never both, or Insights shows every scope twice. Stat must be one of the STAT_WebP_* ids
+// above.
+#if STATS
+#define WEBP_SCOPE_CYCLE_COUNTER(Stat) SCOPE_CYCLE_COUNTER(Stat)
+#else
+#define WEBP_SCOPE_CYCLE_COUNTER(Stat) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, WebPChannel)
+#endif
+
+// Counts a decode as in flight for the lifetime of the scope (stat + Insights counter). Out of line: the trace
+// counter isn't exported, and VNM uses the scope too.
+struct WEBPIMAGESUPPORT_API FWebPInFlightScope
+{
+    FWebPInFlightScope();
+    ~FWebPInFlightScope();
+
+    FWebPInFlightScope(const FWebPInFlightScope&) = delete;
+    FWebPInFlightScope& operator=(const FWebPInFlightScope&) = delete;
+};
@@ -0,0 +1,28 @@
+// WebPSyntheticImage.h
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Procedural test content, chosen to stress the codec differently:
+// flat compresses to nothing, noise is the worst case, photo/sprite approximate real VN art.
+enum class EWebPSyntheticContent : uint8
+{
+    Flat,       // Single colour, opaque
+    Gradient,   // Smooth 2D gradient, opaque
+    Noise,      // Per-pixel random, opaque
+    Photo,      // Gradient + low-frequency blobs + light noise, opaque
+    Sprite,     // Photo-like figure on a fully transparent canvas (alpha edges)
+};
+
+struct WEBPIMAGESUPPORT_API FWebPSyntheticImage
+{
+    static const TCHAR* ToString(EWebPSyntheticContent Content);
+    static bool HasAlpha(EWebPSyntheticContent Content) { return Content == EWebPSyntheticContent::Sprite; }
+
+    // Fills OutBGRA with Width * Height tightly packed BGRA8 pixels. Deterministic for a given Seed.
+    static void Generate(int32 Width, int32 Height, EWebPSyntheticContent Content, int32 Seed, TArray64<uint8>& OutBGRA);
+
+    // WebP bitstream of BGRA8 pixels (rows Stride bytes apart, 0 = tight), the input suites build their decode cases
+    // from. Empty if the encode fails.
+    static TArray64<uint8> Encode(const uint8* BGRA, int32 Width, int32 Height, int32 Quality, bool bLossless = false, int64 Stride = 0);
+};
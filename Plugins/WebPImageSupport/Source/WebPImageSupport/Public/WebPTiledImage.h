@@ -0,0 +1,102 @@
+// WebPTiledImage.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IImageWrapper.h"
+
+struct FWebPDecodeOptions;
+struct FWebPEncodeOptions;
+
+/**
+ * Tiled image format (.webptiles) for very large CGs and panoramas: a grid of independently encoded WebP tiles,
+ * so decoding scales with cores (and single tiles can be decoded on their own for streaming).
+ *
+ *   FWebPTiledHeader
+ *   FWebPTileEntry[TilesX * TilesY]   row-major
+ *   WebP blobs                        each starting on a BlobAlignment boundary
+ *
+ * Tiles are TileSize x TileSize except along the right and bottom edges. Little-endian, like .webpbundle.
+ */
+namespace WebPTiled
+{
+    static constexpr uint32 Magic = 0x54505756; // "VWPT"
+    static constexpr uint32 Version = 1;
+    static constexpr uint32 BlobAlignment = 64;
+}
+
+struct FWebPTiledHeader
+{
+    uint32 Magic;
+    uint32 Version;
+    uint32 Width;
+    uint32 Height;
+    uint32 TileSize;
+    uint32 TilesX;
+    uint32 TilesY;
+    uint32 Flags;       // EWebPBundleEntryFlags of the source (HasAlpha, Lossless)
+};
+static_assert(sizeof(FWebPTiledHeader) == 32, "FWebPTiledHeader is an on-disk layout");
+
+struct FWebPTileEntry
+{
+    uint64 DataOffset;  // From the start of the file, BlobAlignment aligned
+    uint32 DataSize;
+    uint32 Reserved;
+};
+static_assert(sizeof(FWebPTileEntry) == 16, "FWebPTileEntry is an on-disk layout");
+
+// Runtime side. Either borrows the bytes (e.g. a bundle slice) or owns a file loaded into memory.
+class WEBPIMAGESUPPORT_API FWebPTiledImage
+{
+public:
+    FWebPTiledImage() = default;
+
+    // Header and Tiles point into OwnedData
+    FWebPTiledImage(const FWebPTiledImage&) = delete;
+    FWebPTiledImage& operator=(const FWebPTiledImage&) = delete;
+
+    // Data must stay valid while this object is used
+    bool InitializeView(TConstArrayView64<uint8> Data);
+    bool LoadFile(const FString& Filename);
+    // Back to the invalid state, dropping an owned file
+    void Reset();
+
+    bool IsValid() const { return Header != nullptr; }
+    int32 GetWidth() const { return Header ? Header->Width : 0; }
+    int32 GetHeight() const { return Header ? Header->Height : 0; }
+    int32 GetTileSize() const { return Header ? Header->TileSize : 0; }
+    int32 GetNumTilesX() const { return Header ? Header->TilesX : 0; }
+    int32 GetNumTilesY() const { return Header ? Header->TilesY : 0; }
+    int32 GetNumTiles() const { return Tiles.Num(); }
+
+    // Pixel rectangle covered by a tile (edge tiles are clipped to the image)
+    FIntRect GetTileRect(int32 TileX, int32 TileY) const;
+    TConstArrayView64<uint8> GetTileData(int32 TileX, int32 TileY) const;
+
+    // Decodes one tile with its top-left pixel at OutPixels, rows OutStride bytes apart. Pointing OutPixels into a
+    // full-image buffer at the tile's origin (with the full-image stride) writes the tile in place.
+    bool DecodeTile(int32 TileX, int32 TileY, ERGBFormat Format, const FWebPDecodeOptions& Options,
+                    uint8* OutPixels, int64 OutStride, int64 OutSize) const;
+
+    // Whole image into OutPixels (tightly packed, pooled), tiles decoded in parallel. MaxParallelism <= 0 uses every worker.
+    // Format is 8-bit BGRA, RGBA or Gray.
+    bool DecodeAll(ERGBFormat Format, const FWebPDecodeOptions& Options, TArray64<uint8>& OutPixels, int32 MaxParallelism = 0) const;
+
+private:
+    bool Validate();
+
+    TArray64<uint8> OwnedData;
+    TConstArrayView64<uint8> Data;
+    const FWebPTiledHeader* Header = nullptr;
+    TConstArrayView<FWebPTileEntry> Tiles;
+};
+
+// Tool side: cuts a BGRA8 image into tiles, encodes them in parallel and writes the container
+class WEBPIMAGESUPPORT_API FWebPTiledImageBuilder
+{
+public:
+    static constexpr int32 DefaultTileSize = 512;
+
+    static bool Encode(const uint8* BGRA, int32 Width, int32 Height, int64 Stride, int32 TileSize,
+                       const FWebPEncodeOptions& Options, int32 Quality, TArray64<uint8>& OutFile, FString* OutError = nullptr);
+};
@@ -0,0 +1,16 @@
+// WebPTrim.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WebPSimd.h"
+
+// Transparent-border trimming: sprites are authored on big transparent canvases, and every fully transparent
+// row and column around the character is decode time, memory and fill rate spent on nothing.
+namespace WebPTrim
+{
+    // Tight bounds of the pixels with alpha > 0 in a BGRA8/RGBA8 image (alpha in byte 3); empty if all transparent.
+    // Rows are scanned with vector compares, and after the first hit row only the columns outside the bounds found
+    // so far are looked at.
+    WEBPIMAGESUPPORT_API FIntRect FindContentBounds(const uint8* Pixels, int32 Width, int32 Height, int64 Stride);
+    WEBPIMAGESUPPORT_API FIntRect FindContentBounds(EWebPSimdBackend Backend, const uint8* Pixels, int32 Width, int32 Height, int64 Stride);
+}
@@ -40,6 +40,7 @@ public class WebPImageSupport : ModuleRules
                 "Engine",
                 "Slate",
                 "SlateCore",
+                "Json", // Benchmark reports
             }
             );
 
@@ -90,7 +91,20 @@ public class WebPImageSupport : ModuleRules
             {
                 System.Console.WriteLine("WebPImageSupport: ERROR - libwebp.lib not found at: " + LibFilePath);
             }
-            
+
+            // WebPDemux for animated WebP (FWebPAnimation); built from the same libwebp release
+            string DemuxLibFilePath = Path.Combine(LibWebPBaseDir, "lib", "libwebpdemux.lib");
+            PublicAdditionalLibraries.Add(DemuxLibFilePath);
+            if (!File.Exists(DemuxLibFilePath))
+            {
+                System.Console.WriteLine("WebPImageSupport: ERROR - libwebpdemux.lib not found at: " + DemuxLibFilePath);
+            }
+
+        }
+        else if (Target.Platform == UnrealTargetPlatform.Linux || Target.Platform == UnrealTargetPlatform.LinuxArm64)
+        {
+            // No prebuilt library here: compile libwebp from source (ThirdParty/libwebp/LibWebP.Build.cs)
+            PrivateDependencyModuleNames.Add("LibWebP");
         }
     }
 }
\ No newline at end of file
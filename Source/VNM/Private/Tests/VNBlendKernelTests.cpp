@@ -0,0 +1,64 @@
+// Every SIMD blend backend this machine can run must match the scalar kernel byte for byte, across widths that leave
+// a scalar tail after the vector loop and on rows that don't start on a vector boundary.
+#include "VNBlendKernels.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace VNBlendKernelTests
+{
+    // Premultiplied BGRA at a 4-byte offset into the buffer
+    static TArray64<uint8> MakeRow(int32 NumPixels, int32 Seed)
+    {
+        FRandomStream Random(Seed);
+        TArray64<uint8> Row;
+        Row.SetNumUninitialized((int64)(NumPixels + 1) * 4);
+        for (uint8& Byte : Row)
+        {
+            Byte = (uint8)Random.RandHelper(256);
+        }
+        // Fully transparent and fully opaque pixels take their own paths in some kernels
+        Row[7] = 0;
+        Row[Row.Num() - 1] = 255;
+        VNBlend::PremultiplyRow(Row.GetData() + 4, Row.GetData() + 4, NumPixels);
+        return Row;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVNBlendKernelTest, "VNM.Kernels.Blend",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FVNBlendKernelTest::RunTest(const FString& Parameters)
+{
+    using namespace VNBlendKernelTests;
+    static const int32 Widths[] = { 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 63, 65, 1021 };
+
+    TArray<EWebPSimdBackend> Backends = WebPSimd::GetAvailableBackends();
+    Backends.RemoveAt(0); // Scalar, the reference
+    for (EWebPSimdBackend Backend : Backends)
+    {
+        for (int32 Width : Widths)
+        {
+            const TArray64<uint8> Src = MakeRow(Width, Width);
+            const TArray64<uint8> Dst = MakeRow(Width, Width + 1000);
+            for (const uint8 Opacity : { (uint8)0, (uint8)1, (uint8)128, (uint8)254, (uint8)255 })
+            {
+                TArray64<uint8> Expected = Dst;
+                TArray64<uint8> Actual = Dst;
+                VNBlend::BlendPremultipliedRow(EWebPSimdBackend::Scalar, Expected.GetData() + 4, Src.GetData() + 4, Width, Opacity);
+                VNBlend::BlendPremultipliedRow(Backend, Actual.GetData() + 4, Src.GetData() + 4, Width, Opacity);
+
+                int64 Mismatch = INDEX_NONE;
+                for (int64 Index = 0; Index < Actual.Num() && Mismatch == INDEX_NONE; ++Index)
+                {
+                    Mismatch = Expected[Index] != Actual[Index] ? Index : INDEX_NONE;
+                }
+                TestEqual(FString::Printf(TEXT("%s width %d opacity %d: first mismatch"), WebPSimd::ToString(Backend), Width, Opacity),
+                    Mismatch, (int64)INDEX_NONE);
+            }
+        }
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
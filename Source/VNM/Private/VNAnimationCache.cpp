@@ -0,0 +1,261 @@
+#include "VNAnimationCache.h"
+#include "VNImageLoader.h"
+#include "VNSceneCompositor.h"
+#include "VNMemoryGovernor.h"
+#include "WebPBufferPool.h"
+#include "WebPStats.h"
+#include "WebPMemory.h"
+#include "Engine/Texture2D.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVNAnimationCache, Log, All);
+
+FVNSharedAnimation::~FVNSharedAnimation()
+{
+    if (Governor)
+    {
+        Governor->Untrack(TextureAllocation);
+    }
+    // The canvas references Animation, which references LooseBytes
+    Canvas.Reset();
+    FWebPBufferPool::Get().Release(LooseBytes);
+}
+
+FVNAnimationCache::FVNAnimationCache(const FVNImageLoader& InLoader)
+    : Loader(InLoader)
+{
+}
+
+FVNAnimationCache::~FVNAnimationCache()
+{
+    // Instances may outlive the cache; they keep their last frame, it just stops advancing
+    Streams.Empty();
+}
+
+TSharedPtr<FVNSharedAnimation> FVNAnimationCache::Acquire(FName RequestedId, double TimeBaseSeconds)
+{
+    check(IsInGameThread());
+    ++Stats.Acquires;
+
+    // Duplicate effects under different names share a stream too
+    const FName Id = Loader.GetCanonicalId(RequestedId);
+
+    const FStreamKey Key(Id, TimeBaseSeconds);
+    if (const TWeakPtr<FVNSharedAnimation>* Existing = Streams.Find(Key))
+    {
+        if (TSharedPtr<FVNSharedAnimation> Stream = Existing->Pin())
+        {
+            ++Stats.SharedAcquires;
+            return Stream;
+        }
+    }
+
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNAnimationCache_CreateStream, WebPChannel);
+    TSharedPtr<FVNSharedAnimation> Stream = MakeShared<FVNSharedAnimation>();
+    Stream->Id = Id;
+    Stream->TimeBaseSeconds = TimeBaseSeconds;
+    const TConstArrayView64<uint8> Compressed = Loader.FindCompressed(Id, Stream->LooseBytes);
+    if (Compressed.Num() == 0 || !Stream->Animation.InitializeView(Compressed))
+    {
+        UE_LOG(LogVNAnimationCache, Warning, TEXT("Failed to open animation '%s'"), *Id.ToString());
+        return nullptr;
+    }
+
+    const FIntPoint Size = Stream->Animation.GetCanvasSize();
+    const int64 FrameBytes = FMath::Max<int64>((int64)Size.X * Size.Y * 4, 1);
+    Stream->Canvas = MakeUnique<FWebPAnimationCanvas>(Stream->Animation);
+    Stream->Ring.SetNum(Stream->Animation.GetNumFrames());
+    Stream->RingCapacity = (int32)FMath::Min<int64>(Stream->Animation.GetNumFrames(), Settings.MaxRingBytesPerStream / FrameBytes);
+
+    // Frame 0 up front so the instance has something to show before the first Tick
+    const uint8* Pixels = ComposeFrame(*Stream, 0);
+    if (!Pixels)
+    {
+        return nullptr;
+    }
+    if (Settings.bCreateTextures)
+    {
+        LLM_SCOPE_BYTAG(WebP_TextureStaging);
+        Stream->Texture.Reset(FVNSceneCompositor::CreateTexture(Stream->Canvas->GetPixels(), Size));
+        if (Governor && Stream->Texture.IsValid())
+        {
+            // No eviction delegate: the stream lives as long as its instances, which are on screen
+            Stream->Governor = Governor;
+            Stream->TextureAllocation = Governor->Track(Stream.Get(), Id, EVNMemoryCategory::Texture, FVNMemoryGovernor::GetTextureBytes(Stream->Texture.Get()));
+        }
+    }
+    Stream->ShownFrame = 0;
+
+    ++Stats.StreamsCreated;
+    Streams.Add(Key, Stream);
+    return Stream;
+}
+
+void FVNAnimationCache::Tick(double NowSeconds)
+{
+    check(IsInGameThread());
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNAnimationCache_Tick, WebPChannel);
+
+    for (auto It = Streams.CreateIterator(); It; ++It)
+    {
+        if (TSharedPtr<FVNSharedAnimation> Stream = It.Value().Pin())
+        {
+            Advance(*Stream, NowSeconds);
+        }
+        else
+        {
+            It.RemoveCurrent();
+        }
+    }
+}
+
+int32 FVNAnimationCache::GetFrameAt(const FVNSharedAnimation& Stream, double NowSeconds) const
+{
+    const FWebPAnimation& Animation = Stream.Animation;
+    const int32 TotalMs = Animation.GetTotalDurationMs();
+    const double ElapsedMs = FMath::Max(0.0, (NowSeconds - Stream.TimeBaseSeconds) * 1000.0);
+    if (TotalMs <= 0)
+    {
+        return 0;
+    }
+    if (Animation.GetLoopCount() > 0 && ElapsedMs >= (double)TotalMs * Animation.GetLoopCount())
+    {
+        return Animation.GetNumFrames() - 1; // Ran out of loops: hold the last frame
+    }
+
+    double InLoopMs = FMath::Fmod(ElapsedMs, (double)TotalMs);
+    for (int32 Frame = 0; Frame < Animation.GetNumFrames(); ++Frame)
+    {
+        InLoopMs -= Animation.GetFrame(Frame).DurationMs;
+        if (InLoopMs < 0.0)
+        {
+            return Frame;
+        }
+    }
+    return Animation.GetNumFrames() - 1;
+}
+
+void FVNAnimationCache::Advance(FVNSharedAnimation& Stream, double NowSeconds)
+{
+    if (NowSeconds == Stream.LastAdvanceSeconds)
+    {
+        return;
+    }
+    Stream.LastAdvanceSeconds = NowSeconds;
+
+    const int32 Target = GetFrameAt(Stream, NowSeconds);
+    if (Target == Stream.ShownFrame)
+    {
+        return;
+    }
+
+    // Dirty area between the shown frame and the target, from the frame table
+    const int32 NumFrames = Stream.Animation.GetNumFrames();
+    FIntRect Dirty;
+    for (int32 Frame = (Stream.ShownFrame + 1) % NumFrames; ; Frame = (Frame + 1) % NumFrames)
+    {
+        const FIntRect FrameDirty = FWebPAnimationCanvas::GetDirtyRect(Stream.Animation, Frame);
+        if (Dirty.IsEmpty())
+        {
+            Dirty = FrameDirty;
+        }
+        else
+        {
+            Dirty.Union(FrameDirty);
+        }
+        if (Frame == Target)
+        {
+            break;
+        }
+    }
+
+    const uint8* Pixels = ComposeFrame(Stream, Target);
+    if (!Pixels)
+    {
+        UE_LOG(LogVNAnimationCache, Warning, TEXT("Failed to decode frame %d of '%s'"), Target, *Stream.Id.ToString());
+        return;
+    }
+    Stream.ShownFrame = Target;
+    Upload(Stream, Dirty, Pixels);
+}
+
+const uint8* FVNAnimationCache::ComposeFrame(FVNSharedAnimation& Stream, int32 FrameIndex)
+{
+    if (const FVNDecodedImagePtr& Cached = Stream.Ring[FrameIndex])
+    {
+        ++Stats.RingHits;
+        return Cached->Pixels.GetData();
+    }
+
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNAnimationCache_ComposeFrame, WebPChannel);
+    FWebPAnimationCanvas& Canvas = *Stream.Canvas;
+    const int32 NumFrames = Stream.Animation.GetNumFrames();
+    while (Canvas.GetFrameIndex() != FrameIndex)
+    {
+        // Frames are built on top of each other, so walk forward; a ringed frame on the way saves decoding up to it
+        const int32 Next = (Canvas.GetFrameIndex() + 1) % NumFrames;
+        if (Stream.Ring[Next].IsValid())
+        {
+            Canvas.Restore(Next, Stream.Ring[Next]->Pixels.GetData());
+            continue;
+        }
+        FIntRect Unused;
+        if (!Canvas.DecodeNextFrame(Unused))
+        {
+            Canvas.Reset();
+            return nullptr;
+        }
+        ++Stats.FramesDecoded;
+    }
+
+    if (Stream.RingCapacity > 0)
+    {
+        if (Stream.RingOrder.Num() >= Stream.RingCapacity)
+        {
+            Stream.Ring[Stream.RingOrder[0]].Reset();
+            Stream.RingOrder.RemoveAt(0);
+        }
+
+        TSharedRef<FVNDecodedImage, ESPMode::ThreadSafe> Snapshot = MakeShared<FVNDecodedImage, ESPMode::ThreadSafe>();
+        Snapshot->Id = Stream.Id;
+        Snapshot->Width = Stream.Animation.GetCanvasSize().X;
+        Snapshot->Height = Stream.Animation.GetCanvasSize().Y;
+        {
+            LLM_SCOPE_BYTAG(WebP_Decoded);
+            Snapshot->Pixels = FWebPBufferPool::Get().Acquire(Canvas.GetPixels().Num());
+        }
+        FMemory::Memcpy(Snapshot->Pixels.GetData(), Canvas.GetPixels().GetData(), Canvas.GetPixels().Num());
+        Stream.Ring[FrameIndex] = Snapshot;
+        Stream.RingOrder.Add(FrameIndex);
+    }
+    return Canvas.GetPixels().GetData();
+}
+
+void FVNAnimationCache::Upload(FVNSharedAnimation& Stream, const FIntRect& Rect, const uint8* FramePixels)
+{
+    if (!Stream.Texture.IsValid() || Rect.IsEmpty())
+    {
+        return;
+    }
+    WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_TextureUpload);
+
+    // Staged: the canvas (and ring slots) change before the render thread gets to the copy
+    const int64 CanvasStride = (int64)Stream.Animation.GetCanvasSize().X * 4;
+    const uint32 Pitch = Rect.Width() * 4;
+    uint8* Staging = (uint8*)FMemory::Malloc((SIZE_T)Pitch * Rect.Height());
+    for (int32 Row = 0; Row < Rect.Height(); ++Row)
+    {
+        FMemory::Memcpy(Staging + (SIZE_T)Row * Pitch, FramePixels + (Rect.Min.Y + Row) * CanvasStride + Rect.Min.X * 4, Pitch);
+    }
+
+    FUpdateTextureRegion2D* Region = new FUpdateTextureRegion2D(Rect.Min.X, Rect.Min.Y, 0, 0, Rect.Width(), Rect.Height());
+    Stream.Texture->UpdateTextureRegions(0, 1, Region, Pitch, 4, Staging,
+        [](uint8* SrcData, const FUpdateTextureRegion2D* InRegions)
+        {
+            FMemory::Free(SrcData);
+            delete InRegions;
+        });
+
+    const int64 UploadedBytes = (int64)Rect.Area() * 4;
+    Stats.UploadedBytes += UploadedBytes;
+    INC_DWORD_STAT_BY(STAT_WebP_UploadedBytes, UploadedBytes);
+}
@@ -0,0 +1,133 @@
+// The same looping effect shown by N instances: N independent canvases (each decoding every frame) against one
+// FVNAnimationCache stream shared by all N. Simulates a few seconds of 60 Hz playback per iteration.
+// -run=WebPBenchmark -Suite=AnimationShare, or the WebP.Perf.Benchmark.* tests.
+#include "WebPBenchmark.h"
+#include "WebPAnimation.h"
+#include "WebPSyntheticImage.h"
+#include "VNAnimationCache.h"
+#include "VNImageLoader.h"
+#include "WebPImageSupport/Private/WebpImageWrapper.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
+
+namespace VNAnimationCacheBenchmarks
+{
+    // Full-canvas sparkle loop: every frame is a whole new alpha frame, the worst case for decoding
+    static TArray64<uint8> BuildEffect(FIntPoint Canvas, int32 NumFrames, int32 FrameMs)
+    {
+        FWebPAnimationBuilder Builder(Canvas);
+        for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            TArray64<uint8> Pixels;
+            FWebPSyntheticImage::Generate(Canvas.X, Canvas.Y, EWebPSyntheticContent::Sprite, 100 + Frame, Pixels);
+            if (!Builder.AddFrame(Pixels.GetData(), FIntRect(FIntPoint::ZeroValue, Canvas), FrameMs,
+                                  EWebPFrameDispose::Background, EWebPFrameBlend::NoBlend, FWebPEncodeOptions(), 80))
+            {
+                return TArray64<uint8>();
+            }
+        }
+        return Builder.Finish();
+    }
+
+    static void Run(FWebPBenchmarkContext& Context)
+    {
+        const FIntPoint Canvas = Context.bQuick ? FIntPoint(256, 256) : FIntPoint(512, 512);
+        const int32 NumFrames = 12;
+        const int32 FrameMs = 50;
+        const int32 NumTicks = Context.bQuick ? 60 : 180; // 1 s / 3 s at 60 Hz
+
+        const TArray64<uint8> File = BuildEffect(Canvas, NumFrames, FrameMs);
+        FWebPAnimation Animation;
+        if (File.Num() == 0 || !Animation.InitializeView(TConstArrayView64<uint8>(File.GetData(), File.Num())))
+        {
+            return;
+        }
+
+        // The cache goes through the loader, so the effect is written where a loose-file loader finds it
+        const FString Root = FPaths::ProjectSavedDir() / TEXT("WebPBenchmark") / TEXT("AnimationShare");
+        if (!FFileHelper::SaveArrayToFile(File, *(Root / TEXT("effect.webp"))))
+        {
+            return;
+        }
+        FVNImageLoader Loader;
+        Loader.SetLooseFileRoot(Root);
+
+        const int32 InstanceCounts[] = { 1, 4, 16 };
+        for (int32 Instances : InstanceCounts)
+        {
+            const bool SharedSettings[] = { false, true };
+            for (bool bShared : SharedSettings)
+            {
+                FWebPBenchmarkResult& Result = Context.AddResult(TEXT("AnimationShare"),
+                    FString::Printf(TEXT("%dx%d x%d %s"), Canvas.X, Canvas.Y, Instances, bShared ? TEXT("shared") : TEXT("independent")));
+                Result.AddSizeParams(Canvas.X, Canvas.Y);
+                Result.Params.Add(TEXT("instances"), LexToString(Instances));
+                Result.Params.Add(TEXT("mode"), bShared ? TEXT("shared") : TEXT("independent"));
+                Result.Params.Add(TEXT("ticks"), LexToString(NumTicks));
+
+                int32 FramesDecoded = 0;
+                Context.Measure(Result, [&]()
+                {
+                    FramesDecoded = 0;
+                    if (bShared)
+                    {
+                        FVNAnimationCache Cache(Loader);
+                        FVNAnimationCache::FSettings Settings;
+                        Settings.bCreateTextures = false;
+                        Cache.SetSettings(Settings);
+
+                        TArray<TSharedPtr<FVNSharedAnimation>> Handles;
+                        for (int32 Instance = 0; Instance < Instances; ++Instance)
+                        {
+                            Handles.Add(Cache.Acquire(TEXT("effect"), 0.0));
+                        }
+                        for (int32 Tick = 1; Tick <= NumTicks; ++Tick)
+                        {
+                            Cache.Tick(Tick / 60.0);
+                        }
+                        FramesDecoded = Cache.GetStats().FramesDecoded;
+                        return;
+                    }
+
+                    // Independent players: each instance owns a canvas and decodes every frame it shows
+                    TArray<TUniquePtr<FWebPAnimationCanvas>> Canvases;
+                    TArray<double> TimeInFrame;
+                    FIntRect Dirty;
+                    for (int32 Instance = 0; Instance < Instances; ++Instance)
+                    {
+                        Canvases.Add(MakeUnique<FWebPAnimationCanvas>(Animation));
+                        Canvases.Last()->DecodeNextFrame(Dirty);
+                        TimeInFrame.Add(0.0);
+                        ++FramesDecoded;
+                    }
+                    for (int32 Tick = 1; Tick <= NumTicks; ++Tick)
+                    {
+                        for (int32 Instance = 0; Instance < Instances; ++Instance)
+                        {
+                            TimeInFrame[Instance] += 1000.0 / 60.0;
+                            while (TimeInFrame[Instance] >= FrameMs)
+                            {
+                                TimeInFrame[Instance] -= FrameMs;
+                                Canvases[Instance]->DecodeNextFrame(Dirty);
+                                ++FramesDecoded;
+                            }
+                        }
+                    }
+                });
+
+                Result.BytesPerIteration = (int64)FramesDecoded * Canvas.X * Canvas.Y * 4;
+                Result.Metrics.Add(TEXT("frames_decoded"), (double)FramesDecoded);
+                Result.Metrics.Add(TEXT("frames_decoded_per_instance"), (double)FramesDecoded / Instances);
+            }
+        }
+
+        IFileManager::Get().DeleteDirectory(*Root, false, true);
+    }
+
+    static FWebPBenchmarkSuiteRegistrar AnimationShareSuite(TEXT("AnimationShare"), &Run);
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
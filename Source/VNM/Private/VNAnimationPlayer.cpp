@@ -0,0 +1,173 @@
+#include "VNAnimationPlayer.h"
+#include "VNImageLoader.h"
+#include "VNSceneCompositor.h"
+#include "WebPBufferPool.h"
+#include "WebPStats.h"
+#include "WebPMemory.h"
+#include "Engine/Texture2D.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVNAnimationPlayer, Log, All);
+
+FVNAnimationPlayer::FVNAnimationPlayer(const FVNImageLoader& InLoader)
+    : Loader(InLoader)
+{
+}
+
+FVNAnimationPlayer::~FVNAnimationPlayer()
+{
+    Close();
+}
+
+bool FVNAnimationPlayer::Open(FName InId)
+{
+    check(IsInGameThread());
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNAnimationPlayer_Open, WebPChannel);
+    Close();
+
+    Id = InId;
+    const TConstArrayView64<uint8> Compressed = Loader.FindCompressed(Id, LooseBytes);
+    if (Compressed.Num() == 0 || !Animation.InitializeView(Compressed))
+    {
+        UE_LOG(LogVNAnimationPlayer, Warning, TEXT("Failed to open animation '%s'"), *Id.ToString());
+        Close();
+        return false;
+    }
+
+    Canvas = MakeUnique<FWebPAnimationCanvas>(Animation);
+    FIntRect Dirty;
+    if (!ShowNextFrame(Dirty))
+    {
+        Close();
+        return false;
+    }
+
+    LLM_SCOPE_BYTAG(WebP_TextureStaging);
+    Texture.Reset(FVNSceneCompositor::CreateTexture(Canvas->GetPixels(), Canvas->GetSize()));
+    return Texture.IsValid();
+}
+
+void FVNAnimationPlayer::Close()
+{
+    Texture.Reset();
+    Canvas.Reset();
+    Animation = FWebPAnimation();
+    FWebPBufferPool::Get().Release(LooseBytes);
+    TimeInFrameMs = 0.0;
+    LoopsCompleted = 0;
+    bFinished = false;
+}
+
+void FVNAnimationPlayer::Restart()
+{
+    if (!Canvas.IsValid())
+    {
+        return;
+    }
+    Canvas->Reset();
+    TimeInFrameMs = 0.0;
+    LoopsCompleted = 0;
+    bFinished = false;
+
+    FIntRect Dirty;
+    if (ShowNextFrame(Dirty))
+    {
+        Upload(Dirty);
+    }
+}
+
+bool FVNAnimationPlayer::ShowNextFrame(FIntRect& InOutDirtyRect)
+{
+    FIntRect FrameDirty;
+    if (!Canvas->DecodeNextFrame(FrameDirty))
+    {
+        UE_LOG(LogVNAnimationPlayer, Warning, TEXT("Failed to decode frame %d of '%s'"), Canvas->GetFrameIndex(), *Id.ToString());
+        return false;
+    }
+    ++Stats.FramesDecoded;
+    if (InOutDirtyRect.IsEmpty())
+    {
+        InOutDirtyRect = FrameDirty;
+    }
+    else
+    {
+        InOutDirtyRect.Union(FrameDirty);
+    }
+    return true;
+}
+
+void FVNAnimationPlayer::Tick(float DeltaSeconds)
+{
+    check(IsInGameThread());
+    if (!Canvas.IsValid() || bFinished || Animation.GetNumFrames() < 2)
+    {
+        return;
+    }
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNAnimationPlayer_Tick, WebPChannel);
+
+    TimeInFrameMs += DeltaSeconds * 1000.0;
+    if (Animation.GetLoopCount() == 0 && Animation.GetTotalDurationMs() > 0 && TimeInFrameMs > Animation.GetTotalDurationMs())
+    {
+        // A long hitch would otherwise decode whole extra loops just to land on the same frame
+        TimeInFrameMs = FMath::Fmod(TimeInFrameMs, (double)Animation.GetTotalDurationMs());
+    }
+
+    FIntRect Dirty;
+    for (int32 Guard = 0; Guard < Animation.GetNumFrames() * 2; ++Guard)
+    {
+        // Zero-duration frames would spin forever; treat them like browsers do (a short minimum)
+        const double DurationMs = FMath::Max(Animation.GetFrame(Canvas->GetFrameIndex()).DurationMs, 10);
+        if (TimeInFrameMs < DurationMs)
+        {
+            break;
+        }
+        if (Canvas->GetFrameIndex() == Animation.GetNumFrames() - 1 && Animation.GetLoopCount() > 0
+            && ++LoopsCompleted >= Animation.GetLoopCount())
+        {
+            bFinished = true;
+            break;
+        }
+        TimeInFrameMs -= DurationMs;
+        if (!ShowNextFrame(Dirty))
+        {
+            bFinished = true;
+            break;
+        }
+    }
+
+    if (!Dirty.IsEmpty())
+    {
+        Upload(Dirty);
+    }
+}
+
+void FVNAnimationPlayer::Upload(const FIntRect& Rect)
+{
+    if (!Texture.IsValid())
+    {
+        return;
+    }
+    WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_TextureUpload);
+
+    // The canvas is rewritten by the next frame before the render thread runs, so the rectangle is staged
+    const int64 CanvasStride = Canvas->GetStride();
+    const uint32 Pitch = Rect.Width() * 4;
+    uint8* Staging = (uint8*)FMemory::Malloc((SIZE_T)Pitch * Rect.Height());
+    for (int32 Row = 0; Row < Rect.Height(); ++Row)
+    {
+        FMemory::Memcpy(Staging + (SIZE_T)Row * Pitch, Canvas->GetPixels().GetData() + (Rect.Min.Y + Row) * CanvasStride + Rect.Min.X * 4, Pitch);
+    }
+
+    FUpdateTextureRegion2D* Region = new FUpdateTextureRegion2D(Rect.Min.X, Rect.Min.Y, 0, 0, Rect.Width(), Rect.Height());
+    Texture->UpdateTextureRegions(0, 1, Region, Pitch, 4, Staging,
+        [](uint8* SrcData, const FUpdateTextureRegion2D* InRegions)
+        {
+            FMemory::Free(SrcData);
+            delete InRegions;
+        });
+
+    const int64 UploadedBytes = (int64)Rect.Area() * 4;
+    ++Stats.Uploads;
+    Stats.UploadedBytes += UploadedBytes;
+    Stats.FullCanvasBytes += CanvasStride * Canvas->GetSize().Y;
+    INC_DWORD_STAT_BY(STAT_WebP_UploadedBytes, UploadedBytes);
+}
@@ -0,0 +1,161 @@
+#include "VNBlendKernels.h"
+
+namespace VNBlend
+{
+    static void BlendRowScalar(uint8* Dst, const uint8* Src, int32 NumPixels, uint8 Opacity)
+    {
+        for (int32 Index = 0; Index < NumPixels; ++Index, Dst += 4, Src += 4)
+        {
+            uint32 S0 = Src[0], S1 = Src[1], S2 = Src[2], SA = Src[3];
+            if (Opacity != 255)
+            {
+                S0 = Div255(S0 * Opacity);
+                S1 = Div255(S1 * Opacity);
+                S2 = Div255(S2 * Opacity);
+                SA = Div255(SA * Opacity);
+            }
+
+            if (SA == 0 && (S0 | S1 | S2) == 0)
+            {
+                continue; // Transparent: most of a sprite's canvas
+            }
+            const uint32 InvA = 255 - SA;
+            Dst[0] = (uint8)FMath::Min<uint32>(S0 + Div255(Dst[0] * InvA), 255);
+            Dst[1] = (uint8)FMath::Min<uint32>(S1 + Div255(Dst[1] * InvA), 255);
+            Dst[2] = (uint8)FMath::Min<uint32>(S2 + Div255(Dst[2] * InvA), 255);
+            Dst[3] = (uint8)FMath::Min<uint32>(SA + Div255(Dst[3] * InvA), 255);
+        }
+    }
+
+#if WEBP_SIMD_AVX2
+    WEBP_TARGET_AVX2 static FORCEINLINE __m256i Div255AVX2(__m256i X)
+    {
+        const __m256i T = _mm256_add_epi16(X, _mm256_set1_epi16(128));
+        return _mm256_srli_epi16(_mm256_add_epi16(T, _mm256_srli_epi16(T, 8)), 8);
+    }
+
+    // Broadcasts each pixel's alpha word over its four channel words (BGRA -> AAAA)
+    WEBP_TARGET_AVX2 static FORCEINLINE __m256i SplatAlphaAVX2(__m256i X)
+    {
+        return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(X, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    }
+
+    WEBP_TARGET_AVX2 static void BlendRowAVX2(uint8* Dst, const uint8* Src, int32 NumPixels, uint8 Opacity)
+    {
+        const __m256i Zero = _mm256_setzero_si256();
+        const __m256i Max = _mm256_set1_epi16(255);
+        const __m256i Op = _mm256_set1_epi16(Opacity);
+
+        int32 Index = 0;
+        for (; Index + 8 <= NumPixels; Index += 8)
+        {
+            const __m256i S = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Src + Index * 4));
+            if (_mm256_testz_si256(S, S))
+            {
+                continue; // 8 fully transparent pixels
+            }
+            const __m256i D = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Dst + Index * 4));
+
+            // Widen to 16 bits: each half holds 2 pixels per 128-bit lane
+            __m256i SLo = _mm256_unpacklo_epi8(S, Zero);
+            __m256i SHi = _mm256_unpackhi_epi8(S, Zero);
+            if (Opacity != 255)
+            {
+                SLo = Div255AVX2(_mm256_mullo_epi16(SLo, Op));
+                SHi = Div255AVX2(_mm256_mullo_epi16(SHi, Op));
+            }
+
+            const __m256i InvLo = _mm256_sub_epi16(Max, SplatAlphaAVX2(SLo));
+            const __m256i InvHi = _mm256_sub_epi16(Max, SplatAlphaAVX2(SHi));
+
+            const __m256i DLo = _mm256_add_epi16(SLo, Div255AVX2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(D, Zero), InvLo)));
+            const __m256i DHi = _mm256_add_epi16(SHi, Div255AVX2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(D, Zero), InvHi)));
+
+            // packus undoes the per-lane unpack, and saturates like the scalar Min(…, 255)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(Dst + Index * 4), _mm256_packus_epi16(DLo, DHi));
+        }
+
+        BlendRowScalar(Dst + Index * 4, Src + Index * 4, NumPixels - Index, Opacity);
+    }
+#endif
+
+#if WEBP_SIMD_NEON
+    // (x + 128 + ((x + 128) >> 8)) >> 8, narrowed to 8 bits
+    static FORCEINLINE uint8x8_t Div255NEON(uint16x8_t X)
+    {
+        return vraddhn_u16(X, vrshrq_n_u16(X, 8));
+    }
+
+    static void BlendRowNEON(uint8* Dst, const uint8* Src, int32 NumPixels, uint8 Opacity)
+    {
+        const uint8x8_t Op = vdup_n_u8(Opacity);
+
+        int32 Index = 0;
+        for (; Index + 8 <= NumPixels; Index += 8)
+        {
+            // De-interleaved: val[0..3] = B, G, R, A of 8 pixels
+            uint8x8x4_t S = vld4_u8(Src + Index * 4);
+            uint8x8x4_t D = vld4_u8(Dst + Index * 4);
+
+            if (Opacity != 255)
+            {
+                for (int32 Channel = 0; Channel < 4; ++Channel)
+                {
+                    S.val[Channel] = Div255NEON(vmull_u8(S.val[Channel], Op));
+                }
+            }
+
+            const uint8x8_t InvA = vmvn_u8(S.val[3]);
+            for (int32 Channel = 0; Channel < 4; ++Channel)
+            {
+                D.val[Channel] = vqadd_u8(S.val[Channel], Div255NEON(vmull_u8(D.val[Channel], InvA)));
+            }
+            vst4_u8(Dst + Index * 4, D);
+        }
+
+        BlendRowScalar(Dst + Index * 4, Src + Index * 4, NumPixels - Index, Opacity);
+    }
+#endif
+
+    void BlendPremultipliedRow(EWebPSimdBackend Backend, uint8* Dst, const uint8* Src, int32 NumPixels, uint8 Opacity)
+    {
+        if (NumPixels <= 0 || Opacity == 0)
+        {
+            return;
+        }
+
+        switch (Backend)
+        {
+#if WEBP_SIMD_AVX2
+        case EWebPSimdBackend::AVX2:
+            BlendRowAVX2(Dst, Src, NumPixels, Opacity);
+            return;
+#endif
+#if WEBP_SIMD_NEON
+        case EWebPSimdBackend::NEON:
+            BlendRowNEON(Dst, Src, NumPixels, Opacity);
+            return;
+#endif
+        default:
+            BlendRowScalar(Dst, Src, NumPixels, Opacity);
+            return;
+        }
+    }
+
+    void BlendPremultipliedRow(uint8* Dst, const uint8* Src, int32 NumPixels, uint8 Opacity)
+    {
+        BlendPremultipliedRow(WebPSimd::GetBackend(), Dst, Src, NumPixels, Opacity);
+    }
+
+    void PremultiplyRow(uint8* Dst, const uint8* Src, int32 NumPixels)
+    {
+        for (int32 Index = 0; Index < NumPixels; ++Index, Dst += 4, Src += 4)
+        {
+            const uint32 Alpha = Src[3];
+            Dst[0] = (uint8)Div255(Src[0] * Alpha);
+            Dst[1] = (uint8)Div255(Src[1] * Alpha);
+            Dst[2] = (uint8)Div255(Src[2] * Alpha);
+            Dst[3] = (uint8)Alpha;
+        }
+    }
+}
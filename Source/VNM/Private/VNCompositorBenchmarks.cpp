@@ -0,0 +1,155 @@
+// Blend throughput (megapixels/second) of the compositor kernels, per SIMD backend, and the cost of
+// incremental (dirty-rect) recomposition. Registered with FWebPBenchmarkRegistry:
+// -run=WebPBenchmark -Suite=Blend,DirtyRect, or the WebP.Perf.Benchmark.* tests.
+#include "WebPBenchmark.h"
+#include "WebPSyntheticImage.h"
+#include "WebPSimd.h"
+#include "VNBlendKernels.h"
+#include "VNSceneCompositor.h"
+
+#if WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
+
+namespace VNCompositorBenchmarks
+{
+    static FVNDecodedImagePtr MakeImage(int32 Width, int32 Height, EWebPSyntheticContent Content, int32 Seed)
+    {
+        TSharedRef<FVNDecodedImage, ESPMode::ThreadSafe> Image = MakeShared<FVNDecodedImage, ESPMode::ThreadSafe>();
+        Image->Width = Width;
+        Image->Height = Height;
+        FWebPSyntheticImage::Generate(Width, Height, Content, Seed, Image->Pixels);
+        // Premultiply up front so the kernels are measured on their own
+        for (int32 Y = 0; Y < Height; ++Y)
+        {
+            uint8* Row = Image->Pixels.GetData() + (int64)Y * Width * 4;
+            VNBlend::PremultiplyRow(Row, Row, Width);
+        }
+        Image->bPremultiplied = true;
+        return Image;
+    }
+
+    static void RunBlend(FWebPBenchmarkContext& Context)
+    {
+        const FIntPoint Canvas = Context.bQuick ? FIntPoint(1280, 720) : FIntPoint(1920, 1080);
+        const int64 CanvasPixels = (int64)Canvas.X * Canvas.Y;
+
+        const FVNDecodedImagePtr Background = MakeImage(Canvas.X, Canvas.Y, EWebPSyntheticContent::Photo, 1);
+        const FVNDecodedImagePtr Sprite = MakeImage(Canvas.X / 3, Canvas.Y, EWebPSyntheticContent::Sprite, 2);
+
+        for (EWebPSimdBackend Backend : WebPSimd::GetAvailableBackends())
+        {
+            WebPSimd::SetBackendOverride(Backend);
+
+            // Raw kernel: one full-canvas layer over another, opaque and at 50% opacity
+            for (uint8 Opacity : { (uint8)255, (uint8)128 })
+            {
+                TArray64<uint8> Target = Background->Pixels;
+                const FVNDecodedImagePtr Overlay = MakeImage(Canvas.X, Canvas.Y, EWebPSyntheticContent::Sprite, 3);
+
+                FWebPBenchmarkResult& Result = Context.AddResult(TEXT("Blend"),
+                    FString::Printf(TEXT("kernel %dx%d opacity=%d %s"), Canvas.X, Canvas.Y, Opacity, WebPSimd::ToString(Backend)));
+                Result.AddBackendParam(Backend);
+                Result.Params.Add(TEXT("opacity"), LexToString(Opacity));
+                Result.BytesPerIteration = CanvasPixels * 4;
+
+                Context.Measure(Result, [&]()
+                {
+                    for (int32 Y = 0; Y < Canvas.Y; ++Y)
+                    {
+                        const int64 Offset = (int64)Y * Canvas.X * 4;
+                        VNBlend::BlendPremultipliedRow(Backend, Target.GetData() + Offset, Overlay->Pixels.GetData() + Offset, Canvas.X, Opacity);
+                    }
+                });
+                Result.Metrics.Add(TEXT("megapixels_per_s"), CanvasPixels / 1.0e6 / (Result.GetMeanMs() / 1000.0));
+            }
+
+            // Typical shot: background + three characters + a half-transparent overlay
+            {
+                FVNSceneCompositor Compositor;
+                Compositor.SetCanvasSize(Canvas);
+                Compositor.AddLayer({ Background, FIntPoint::ZeroValue, 1.0f, 0 });
+                for (int32 Index = 0; Index < 3; ++Index)
+                {
+                    Compositor.AddLayer({ Sprite, FIntPoint(Index * Canvas.X / 3, 0), 1.0f, 1 });
+                }
+                Compositor.AddLayer({ Sprite, FIntPoint(Canvas.X / 3, 0), 0.5f, 2 });
+
+                int64 BlendedPixels = 0;
+                for (int32 Handle = 0; Handle < Compositor.NumLayers(); ++Handle)
+                {
+                    BlendedPixels += Compositor.GetLayerBounds(*Compositor.GetLayer(Handle)).Area();
+                }
+
+                FWebPBenchmarkResult& Result = Context.AddResult(TEXT("Blend"),
+                    FString::Printf(TEXT("scene %dx%d 5 layers %s"), Canvas.X, Canvas.Y, WebPSimd::ToString(Backend)));
+                Result.AddBackendParam(Backend);
+                Result.Params.Add(TEXT("layers"), TEXT("5"));
+                Result.BytesPerIteration = BlendedPixels * 4;
+
+                TArray64<uint8> Output;
+                Context.Measure(Result, [&]() { Compositor.Compose(Output); });
+                Result.Metrics.Add(TEXT("megapixels_per_s"), BlendedPixels / 1.0e6 / (Result.GetMeanMs() / 1000.0));
+            }
+        }
+
+        WebPSimd::SetBackendOverride(TOptional<EWebPSimdBackend>());
+    }
+
+    // Lip-sync style change: a small mouth layer flips between two frames on top of a character.
+    // Compares incremental recomposition against a full recompose and reports bytes that would be uploaded.
+    static void RunDirtyRect(FWebPBenchmarkContext& Context)
+    {
+        const FIntPoint Canvas = Context.bQuick ? FIntPoint(1280, 720) : FIntPoint(1920, 1080);
+        const int64 FullFrameBytes = (int64)Canvas.X * Canvas.Y * 4;
+
+        const FVNDecodedImagePtr Background = MakeImage(Canvas.X, Canvas.Y, EWebPSyntheticContent::Photo, 1);
+        const FVNDecodedImagePtr Sprite = MakeImage(Canvas.X / 3, Canvas.Y, EWebPSyntheticContent::Sprite, 2);
+        const FVNDecodedImagePtr MouthA = MakeImage(64, 32, EWebPSyntheticContent::Sprite, 3);
+        const FVNDecodedImagePtr MouthB = MakeImage(64, 32, EWebPSyntheticContent::Sprite, 4);
+
+        FVNSceneCompositor Compositor;
+        Compositor.SetCanvasSize(Canvas);
+        Compositor.AddLayer({ Background, FIntPoint::ZeroValue, 1.0f, 0 });
+        Compositor.AddLayer({ Sprite, FIntPoint(Canvas.X / 3, 0), 1.0f, 1 });
+        const int32 Mouth = Compositor.AddLayer({ MouthA, FIntPoint(Canvas.X / 2 - 32, Canvas.Y / 4), 1.0f, 2 });
+
+        TArray64<uint8> Pixels;
+        Compositor.Compose(Pixels);
+        Compositor.TakeDirtyRegions();
+
+        bool bFlip = false;
+        int64 UploadedBytes = 0;
+
+        FWebPBenchmarkResult& Incremental = Context.AddResult(TEXT("DirtyRect"), FString::Printf(TEXT("mouth swap incremental %dx%d"), Canvas.X, Canvas.Y));
+        Incremental.Params.Add(TEXT("mode"), TEXT("incremental"));
+        Context.Measure(Incremental, [&]()
+        {
+            Compositor.SetLayerImage(Mouth, (bFlip = !bFlip) ? MouthB : MouthA);
+            UploadedBytes = 0;
+            for (const FIntRect& Region : Compositor.TakeDirtyRegions())
+            {
+                Compositor.ComposeRegion(Region, Pixels.GetData(), (int64)Canvas.X * 4);
+                UploadedBytes += (int64)Region.Area() * 4;
+            }
+        });
+        Incremental.BytesPerIteration = UploadedBytes;
+        Incremental.Metrics.Add(TEXT("uploaded_bytes_per_change"), (double)UploadedBytes);
+        Incremental.Metrics.Add(TEXT("full_frame_bytes"), (double)FullFrameBytes);
+
+        FWebPBenchmarkResult& Full = Context.AddResult(TEXT("DirtyRect"), FString::Printf(TEXT("mouth swap full %dx%d"), Canvas.X, Canvas.Y));
+        Full.Params.Add(TEXT("mode"), TEXT("full"));
+        Full.BytesPerIteration = FullFrameBytes;
+        Context.Measure(Full, [&]()
+        {
+            Compositor.SetLayerImage(Mouth, (bFlip = !bFlip) ? MouthB : MouthA);
+            Compositor.TakeDirtyRegions();
+            Compositor.Compose(Pixels);
+        });
+        Full.Metrics.Add(TEXT("uploaded_bytes_per_change"), (double)FullFrameBytes);
+        Full.Metrics.Add(TEXT("full_frame_bytes"), (double)FullFrameBytes);
+    }
+
+    static FWebPBenchmarkSuiteRegistrar BlendSuite(TEXT("Blend"), &RunBlend);
+    static FWebPBenchmarkSuiteRegistrar DirtyRectSuite(TEXT("DirtyRect"), &RunDirtyRect);
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
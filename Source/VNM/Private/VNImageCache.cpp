@@ -0,0 +1,186 @@
+#include "VNImageCache.h"
+#include "VNMemoryGovernor.h"
+#include "WebPStats.h"
+
+FVNImageCache::FVNImageCache(int64 InBudgetBytes)
+    : BudgetBytes(InBudgetBytes)
+{
+}
+
+FVNImageCache::~FVNImageCache()
+{
+    // The governor may be about to call our eviction delegate on another thread
+    SetGovernor(nullptr);
+    Empty();
+}
+
+void FVNImageCache::SetGovernor(FVNMemoryGovernor* InGovernor)
+{
+    FVNMemoryGovernor* Previous = nullptr;
+    {
+        FScopeLock Lock(&Mutex);
+        if (Governor == InGovernor)
+        {
+            return;
+        }
+        Previous = Governor;
+        Governor = InGovernor;
+        for (TPair<FName, FEntry>& Pair : Entries)
+        {
+            Pair.Value.GovernorHandle = 0;
+            Track_Locked(Pair.Key, Pair.Value);
+        }
+    }
+    // Outside the lock: a delegate of ours still running takes it
+    if (Previous)
+    {
+        Previous->UntrackAll(this);
+    }
+}
+
+void FVNImageCache::Track_Locked(FName Id, FEntry& Entry)
+{
+    if (Governor)
+    {
+        Governor->Untrack(Entry.GovernorHandle);
+        Entry.GovernorHandle = Governor->Track(this, Id, EVNMemoryCategory::Decoded, Entry.Image->GetSizeBytes(),
+            FVNMemoryGovernor::FOnEvict::CreateRaw(this, &FVNImageCache::OnGovernorEvict, Id));
+    }
+}
+
+FVNDecodedImagePtr FVNImageCache::Find(FName Id)
+{
+    FScopeLock Lock(&Mutex);
+    if (FEntry* Entry = Entries.Find(Id))
+    {
+        Entry->LastUse = ++UseCounter;
+        if (Governor)
+        {
+            Governor->Touch(Id);
+        }
+        INC_DWORD_STAT(STAT_WebP_CacheHits);
+        return Entry->Image;
+    }
+    INC_DWORD_STAT(STAT_WebP_CacheMisses);
+    return nullptr;
+}
+
+bool FVNImageCache::Contains(FName Id) const
+{
+    FScopeLock Lock(&Mutex);
+    return Entries.Contains(Id);
+}
+
+void FVNImageCache::Add(const FVNDecodedImagePtr& Image)
+{
+    if (!Image.IsValid())
+    {
+        return;
+    }
+
+    FScopeLock Lock(&Mutex);
+    // The replaced image goes first, entry and all, so eviction below can't pick it and count it a second time
+    FEntry Replaced;
+    if (Entries.RemoveAndCopyValue(Image->Id, Replaced))
+    {
+        UsedBytes -= Replaced.Image->GetSizeBytes();
+        if (Governor)
+        {
+            Governor->Untrack(Replaced.GovernorHandle);
+        }
+    }
+
+    // Make room before inserting so the new image itself is never the LRU victim
+    EvictToBudget_Locked(BudgetBytes - Image->GetSizeBytes());
+
+    FEntry& Entry = Entries.Add(Image->Id);
+    Entry.Image = Image;
+    Entry.LastUse = ++UseCounter;
+    UsedBytes += Image->GetSizeBytes();
+    Track_Locked(Image->Id, Entry);
+}
+
+bool FVNImageCache::OnGovernorEvict(uint64 Handle, FName Id)
+{
+    FScopeLock Lock(&Mutex);
+    const FEntry* Entry = Entries.Find(Id);
+    if (Entry && Entry->GovernorHandle == Handle)
+    {
+        UsedBytes -= Entry->Image->GetSizeBytes();
+        Entries.Remove(Id);
+        Governor->Untrack(Handle);
+    }
+    return true; // Already replaced or removed: nothing of this image left to free
+}
+
+void FVNImageCache::Remove(FName Id)
+{
+    FScopeLock Lock(&Mutex);
+    FEntry Removed;
+    if (Entries.RemoveAndCopyValue(Id, Removed))
+    {
+        UsedBytes -= Removed.Image->GetSizeBytes();
+        if (Governor)
+        {
+            Governor->Untrack(Removed.GovernorHandle);
+        }
+    }
+}
+
+void FVNImageCache::Empty()
+{
+    FScopeLock Lock(&Mutex);
+    if (Governor)
+    {
+        for (const TPair<FName, FEntry>& Pair : Entries)
+        {
+            Governor->Untrack(Pair.Value.GovernorHandle);
+        }
+    }
+    Entries.Empty();
+    UsedBytes = 0;
+}
+
+void FVNImageCache::SetBudgetBytes(int64 InBudgetBytes)
+{
+    FScopeLock Lock(&Mutex);
+    BudgetBytes = InBudgetBytes;
+    EvictToBudget_Locked(BudgetBytes);
+}
+
+int64 FVNImageCache::GetUsedBytes() const
+{
+    FScopeLock Lock(&Mutex);
+    return UsedBytes;
+}
+
+int32 FVNImageCache::Num() const
+{
+    FScopeLock Lock(&Mutex);
+    return Entries.Num();
+}
+
+void FVNImageCache::EvictToBudget_Locked(int64 Budget)
+{
+    // Linear scan for the LRU entry: a VN scene keeps tens of images cached, not thousands
+    while (UsedBytes > Budget && Entries.Num() > 0)
+    {
+        FName Oldest;
+        uint64 OldestUse = MAX_uint64;
+        for (const TPair<FName, FEntry>& Pair : Entries)
+        {
+            if (Pair.Value.LastUse < OldestUse)
+            {
+                OldestUse = Pair.Value.LastUse;
+                Oldest = Pair.Key;
+            }
+        }
+        FEntry Evicted;
+        Entries.RemoveAndCopyValue(Oldest, Evicted);
+        UsedBytes -= Evicted.Image->GetSizeBytes();
+        if (Governor)
+        {
+            Governor->Untrack(Evicted.GovernorHandle);
+        }
+    }
+}
@@ -0,0 +1,332 @@
+#include "VNImageLoader.h"
+#include "WebPBundle.h"
+#include "WebPStats.h"
+#include "WebPMemory.h"
+#include "WebPBufferPool.h"
+#include "HAL/FileManager.h"
+#include "Engine/Texture2D.h"
+#include "PixelFormat.h"
+#include "Misc/ScopeExit.h"
+#include "Misc/Paths.h"
+#include "WebPImageSupport/Private/WebpImageWrapper.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVNImageLoader, Log, All);
+
+// FFileHelper::LoadFileToArray into a pooled buffer
+static bool LoadLooseFile(const FString& Filename, TArray64<uint8>& OutBytes)
+{
+    TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename, FILEREAD_Silent));
+    if (!Reader)
+    {
+        return false;
+    }
+    const int64 Size = Reader->TotalSize();
+    OutBytes = FWebPBufferPool::Get().Acquire(Size);
+    Reader->Serialize(OutBytes.GetData(), Size);
+    return Reader->Close();
+}
+
+FVNImageLoader::FVNImageLoader()
+    : LooseFileRoot(FPaths::ProjectContentDir() / TEXT("VN"))
+{
+}
+
+FVNImageLoader::~FVNImageLoader() = default;
+
+bool FVNImageLoader::MountBundle(const FString& Filename)
+{
+    TUniquePtr<FWebPBundleReader> Reader = MakeUnique<FWebPBundleReader>();
+    if (!Reader->Open(Filename))
+    {
+        return false;
+    }
+
+    // Entries sharing a blob are duplicates; the first one (in index order) names them all. Names an earlier bundle
+    // already provides resolve there, so they are left alone, and so are trimmed copies placed differently on their
+    // canvas, since the decoded image carries its placement.
+    const auto IsShadowed = [this](uint64 NameHash)
+    {
+        return Bundles.ContainsByPredicate([NameHash](const TUniquePtr<FWebPBundleReader>& Bundle) { return Bundle->Find(NameHash) != nullptr; });
+    };
+    TMap<uint64, const FWebPBundleEntry*> FirstByOffset;
+    int32 NumDuplicates = 0;
+    for (const FWebPBundleEntry& Entry : Reader->GetEntries())
+    {
+        const FWebPBundleEntry*& First = FirstByOffset.FindOrAdd(Entry.DataOffset, &Entry);
+        const FWebPBundlePlacement Placement = Reader->GetPlacement(Entry);
+        const FWebPBundlePlacement FirstPlacement = Reader->GetPlacement(*First);
+        if (First != &Entry && !IsShadowed(Entry.NameHash) && !IsShadowed(First->NameHash)
+            && FMemory::Memcmp(&Placement, &FirstPlacement, sizeof(Placement)) == 0)
+        {
+            CanonicalIds.Add(Entry.NameHash, FName(*Reader->GetName(*First)));
+            ++NumDuplicates;
+        }
+    }
+
+    UE_LOG(LogVNImageLoader, Log, TEXT("Mounted %s (%d images, %d duplicates)"), *Filename, Reader->Num(), NumDuplicates);
+    Bundles.Add(MoveTemp(Reader));
+    return true;
+}
+
+void FVNImageLoader::UnmountAll()
+{
+    Bundles.Empty();
+    CanonicalIds.Empty();
+}
+
+FName FVNImageLoader::GetCanonicalId(FName Id) const
+{
+    if (CanonicalIds.Num() == 0 || Id.IsNone())
+    {
+        return Id;
+    }
+    const FName* Canonical = CanonicalIds.Find(WebPBundle::HashName(WebPBundle::NormalizeName(Id.ToString())));
+    return Canonical ? *Canonical : Id;
+}
+
+const FWebPBundleEntry* FVNImageLoader::FindBundleEntry(FName Id, const FWebPBundleReader*& OutBundle) const
+{
+    if (Bundles.Num() == 0)
+    {
+        return nullptr;
+    }
+    const uint64 Hash = WebPBundle::HashName(WebPBundle::NormalizeName(Id.ToString()));
+    for (const TUniquePtr<FWebPBundleReader>& Bundle : Bundles)
+    {
+        if (const FWebPBundleEntry* Entry = Bundle->Find(Hash))
+        {
+            OutBundle = Bundle.Get();
+            return Entry;
+        }
+    }
+    return nullptr;
+}
+
+TConstArrayView64<uint8> FVNImageLoader::FindCompressed(FName Id, TArray64<uint8>& OutLooseBytes) const
+{
+    const FString Name = Id.ToString();
+    const FWebPBundleReader* Bundle = nullptr;
+    if (const FWebPBundleEntry* Entry = FindBundleEntry(Id, Bundle))
+    {
+        return Bundle->GetData(*Entry);
+    }
+
+    const FString Filename = LooseFileRoot / WebPBundle::NormalizeName(Name) + TEXT(".webp");
+    {
+        WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_FileRead);
+        LLM_SCOPE_BYTAG(WebP_Compressed);
+        if (!LoadLooseFile(Filename, OutLooseBytes))
+        {
+            UE_LOG(LogVNImageLoader, Warning, TEXT("No bundle entry or file for image '%s'"), *Name);
+            return TConstArrayView64<uint8>();
+        }
+    }
+    return TConstArrayView64<uint8>(OutLooseBytes.GetData(), OutLooseBytes.Num());
+}
+
+bool FVNImageLoader::PreloadCompressed(FName Id) const
+{
+    const FWebPBundleReader* Bundle = nullptr;
+    if (const FWebPBundleEntry* Entry = FindBundleEntry(Id, Bundle))
+    {
+        Bundle->PreloadHint(*Entry);
+        return true;
+    }
+    return false;
+}
+
+void FVNImageLoader::GetPlacement(FName Id, FIntPoint& OutCanvasOffset, FIntPoint& OutCanvasSize) const
+{
+    OutCanvasOffset = FIntPoint::ZeroValue;
+    OutCanvasSize = FIntPoint::ZeroValue;
+    const FWebPBundleReader* Bundle = nullptr;
+    if (const FWebPBundleEntry* Entry = FindBundleEntry(Id, Bundle))
+    {
+        const FWebPBundlePlacement Placement = Bundle->GetPlacement(*Entry);
+        OutCanvasOffset = FIntPoint(Placement.OffsetX, Placement.OffsetY);
+        OutCanvasSize = FIntPoint(Placement.CanvasWidth, Placement.CanvasHeight);
+    }
+}
+
+bool FVNImageLoader::SetSource(FName Id, FWebpImageWrapper& Wrapper, TArray64<uint8>& OutLooseBytes) const
+{
+    const TConstArrayView64<uint8> Bytes = FindCompressed(Id, OutLooseBytes);
+    if (Bytes.Num() == 0)
+    {
+        return false;
+    }
+    if (!Wrapper.SetCompressedView(Bytes.GetData(), Bytes.Num()))
+    {
+        UE_LOG(LogVNImageLoader, Warning, TEXT("Image '%s' is not a valid WebP"), *Id.ToString());
+        return false;
+    }
+    return true;
+}
+
+FVNDecodedImagePtr FVNImageLoader::Decode(FName Id, int32 MaxDimension) const
+{
+    TArray64<uint8> LooseBytes; // Must outlive the decode when used
+    ON_SCOPE_EXIT { FWebPBufferPool::Get().Release(LooseBytes); };
+    const TConstArrayView64<uint8> Compressed = FindCompressed(Id, LooseBytes);
+    return Compressed.Num() > 0 ? DecodeCompressed(Id, Compressed, MaxDimension) : nullptr;
+}
+
+FVNDecodedImagePtr FVNImageLoader::DecodeCompressed(FName Id, TConstArrayView64<uint8> Compressed, int32 MaxDimension) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNImageLoader_Decode, WebPChannel);
+
+    FWebpImageWrapper Wrapper;
+    Wrapper.SetDebugOwner(Id.ToString());
+
+    FWebPDecodeOptions DecodeOptions;
+    DecodeOptions.bPremultiplyAlpha = bPremultiplyAlpha;
+    DecodeOptions.AlphaMaskCellSize = HitMaskCellSize;
+    Wrapper.SetDecodeOptions(DecodeOptions);
+
+    if (!Wrapper.SetCompressedView(Compressed.GetData(), Compressed.Num()))
+    {
+        UE_LOG(LogVNImageLoader, Warning, TEXT("Image '%s' is not a valid WebP"), *Id.ToString());
+        return nullptr;
+    }
+
+    const FIntPoint Size = GetScaledSize(FIntPoint((int32)Wrapper.GetWidth(), (int32)Wrapper.GetHeight()), MaxDimension);
+    if (Size.X != Wrapper.GetWidth() || Size.Y != Wrapper.GetHeight())
+    {
+        DecodeOptions.ScaledWidth = Size.X;
+        DecodeOptions.ScaledHeight = Size.Y;
+        Wrapper.SetDecodeOptions(DecodeOptions);
+    }
+
+    TSharedRef<FVNDecodedImage, ESPMode::ThreadSafe> Image = MakeShared<FVNDecodedImage, ESPMode::ThreadSafe>();
+    Image->Id = GetCanonicalId(Id);
+    Image->Width = Size.X;
+    Image->Height = Size.Y;
+    Image->bPremultiplied = bPremultiplyAlpha;
+    GetPlacement(Id, Image->CanvasOffset, Image->CanvasSize);
+    bool bDecoded = false;
+    if (DecodeOptions.ScaledWidth > 0)
+    {
+        // RawData is always full size; a scaled decode goes straight into the image's own buffer
+        {
+            LLM_SCOPE_BYTAG(WebP_Decoded);
+            Image->Pixels = FWebPBufferPool::Get().Acquire((int64)Size.X * Size.Y * 4);
+        }
+        bDecoded = Wrapper.DecodeInto(ERGBFormat::BGRA, 8, Image->Pixels.GetData(), (int64)Size.X * 4, Image->Pixels.Num());
+    }
+    else
+    {
+        bDecoded = Wrapper.ReleaseRaw(ERGBFormat::BGRA, 8, Image->Pixels);
+    }
+    if (!bDecoded)
+    {
+        UE_LOG(LogVNImageLoader, Warning, TEXT("Failed to decode image '%s'"), *Id.ToString());
+        return nullptr;
+    }
+    if (Wrapper.GetAlphaMask().IsValid())
+    {
+        Image->HitMask = MakeShared<FWebPAlphaMask, ESPMode::ThreadSafe>(Wrapper.ReleaseAlphaMask());
+    }
+    return Image;
+}
+
+UTexture2D* FVNImageLoader::DecodeToTexture(FName Id, int32 MaxDimension, FVNHitMaskPtr* OutHitMask) const
+{
+    return DecodeToTexture(Id, MaxDimension, ETextureFormat::BGRA8, OutHitMask);
+}
+
+UTexture2D* FVNImageLoader::DecodeGrayToTexture(FName Id, int32 MaxDimension) const
+{
+    return DecodeToTexture(Id, MaxDimension, ETextureFormat::Gray8, nullptr);
+}
+
+UTexture2D* FVNImageLoader::DecodeUIToTexture(FName Id, int32 MaxDimension) const
+{
+    return DecodeToTexture(Id, MaxDimension, ETextureFormat::UI, nullptr);
+}
+
+UTexture2D* FVNImageLoader::DecodeToTexture(FName Id, int32 MaxDimension, ETextureFormat Format, FVNHitMaskPtr* OutHitMask) const
+{
+    check(IsInGameThread());
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNImageLoader_DecodeToTexture, WebPChannel);
+
+    FWebpImageWrapper Wrapper;
+    Wrapper.SetDebugOwner(Id.ToString());
+
+    FWebPDecodeOptions DecodeOptions;
+    DecodeOptions.bPremultiplyAlpha = bPremultiplyAlpha;
+    DecodeOptions.AlphaMaskCellSize = Format == ETextureFormat::BGRA8 ? HitMaskCellSize : 0;
+    Wrapper.SetDecodeOptions(DecodeOptions);
+
+    TArray64<uint8> LooseBytes;
+    ON_SCOPE_EXIT { FWebPBufferPool::Get().Release(LooseBytes); };
+    if (!SetSource(Id, Wrapper, LooseBytes))
+    {
+        return nullptr;
+    }
+    if (Format == ETextureFormat::UI && (Wrapper.HasAlpha() || !GPixelFormats[PF_B5G6R5_UNORM].Supported))
+    {
+        Format = ETextureFormat::BGRA8;
+    }
+
+    const FIntPoint Size = GetScaledSize(FIntPoint((int32)Wrapper.GetWidth(), (int32)Wrapper.GetHeight()), MaxDimension);
+    if (Size.X != Wrapper.GetWidth() || Size.Y != Wrapper.GetHeight())
+    {
+        // Downscaled by the decoder while it writes rows, so no full-size buffer ever exists
+        DecodeOptions.ScaledWidth = Size.X;
+        DecodeOptions.ScaledHeight = Size.Y;
+        Wrapper.SetDecodeOptions(DecodeOptions);
+    }
+
+    LLM_SCOPE_BYTAG(WebP_TextureStaging);
+    const EPixelFormat PixelFormat = Format == ETextureFormat::Gray8 ? PF_G8 : Format == ETextureFormat::UI ? PF_B5G6R5_UNORM : PF_B8G8R8A8;
+    UTexture2D* Texture = UTexture2D::CreateTransient(Size.X, Size.Y, PixelFormat);
+    if (!Texture)
+    {
+        return nullptr;
+    }
+    if (Format == ETextureFormat::Gray8)
+    {
+        Texture->SRGB = false; // Rule values are thresholds, not colours
+    }
+
+    // The mip storage is the decode target: no intermediate RawData and no copy before the upload
+    FByteBulkData& BulkData = Texture->GetPlatformData()->Mips[0].BulkData;
+    const int64 MipSize = BulkData.GetBulkDataSize();
+    const int64 MipStride = MipSize / Size.Y;
+    void* MipData = BulkData.Lock(LOCK_READ_WRITE);
+    bool bDecoded = false;
+    if (MipData)
+    {
+        bDecoded = Format == ETextureFormat::UI
+            ? Wrapper.DecodeInto(EWebPPackedFormat::RGB565, MipData, MipStride, MipSize)
+            : Wrapper.DecodeInto(Format == ETextureFormat::Gray8 ? ERGBFormat::Gray : ERGBFormat::BGRA, 8, MipData, MipStride, MipSize);
+    }
+    BulkData.Unlock();
+
+    if (!bDecoded)
+    {
+        UE_LOG(LogVNImageLoader, Warning, TEXT("Failed to decode image '%s' into its texture"), *Id.ToString());
+        return nullptr;
+    }
+    if (OutHitMask && Wrapper.GetAlphaMask().IsValid())
+    {
+        *OutHitMask = MakeShared<FWebPAlphaMask, ESPMode::ThreadSafe>(Wrapper.ReleaseAlphaMask());
+    }
+
+    {
+        WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_TextureUpload);
+        Texture->UpdateResource();
+    }
+    return Texture;
+}
+
+FIntPoint FVNImageLoader::GetScaledSize(FIntPoint ImageSize, int32 MaxDimension)
+{
+    const int32 LongSide = FMath::Max(ImageSize.X, ImageSize.Y);
+    if (MaxDimension <= 0 || LongSide <= MaxDimension)
+    {
+        return ImageSize;
+    }
+    const double Scale = (double)MaxDimension / LongSide;
+    return FIntPoint(FMath::Max(1, FMath::RoundToInt32(ImageSize.X * Scale)), FMath::Max(1, FMath::RoundToInt32(ImageSize.Y * Scale)));
+}
@@ -0,0 +1,250 @@
+#include "VNImagePrefetcher.h"
+#include "VNImageCache.h"
+#include "VNImageLoader.h"
+#include "VNMemoryGovernor.h"
+#include "WebPStats.h"
+
+FVNImagePrefetcher::FVNImagePrefetcher(FVNImageLoader& InLoader, FVNImageCache& InCache)
+    : Loader(InLoader)
+    , Cache(InCache)
+{
+}
+
+FVNImagePrefetcher::~FVNImagePrefetcher()
+{
+    TArray<UE::Tasks::TTask<FVNDecodedImagePtr>> Running;
+    {
+        FScopeLock Lock(&Mutex);
+        bShuttingDown = true;
+        Queue.Empty();
+        for (TPair<FName, FInFlight>& Pair : InFlight)
+        {
+            Pair.Value.bCancelled->store(true);
+            Running.Add(Pair.Value.Task);
+        }
+    }
+    // Tasks call back into this object when they finish
+    UE::Tasks::Wait(Running);
+}
+
+int32 FVNImagePrefetcher::GetPriorityScore(int32 StepDistance, EVNImageKind Kind)
+{
+    // Full-screen art blocks the transition, sprites can pop in a frame later
+    int32 KindBias = 0;
+    switch (Kind)
+    {
+    case EVNImageKind::Background:
+    case EVNImageKind::CG:      KindBias = 0; break;
+    case EVNImageKind::Sprite:  KindBias = 3; break;
+    case EVNImageKind::Overlay: KindBias = 5; break;
+    case EVNImageKind::UI:      KindBias = 7; break;
+    }
+    return StepDistance * 10 + KindBias;
+}
+
+void FVNImagePrefetcher::UpdateLookahead(TConstArrayView<FVNScriptStep> UpcomingSteps)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNImagePrefetcher_UpdateLookahead, WebPChannel);
+
+    // Best score per image across the window
+    TMap<FName, int32> Wanted;
+    TMap<FName, EVNImageKind> Kinds; // Kind behind the best score, for the governor's eviction order
+    const int32 NumSteps = FMath::Min(UpcomingSteps.Num(), LookaheadSteps);
+    for (int32 StepIndex = 0; StepIndex < NumSteps; ++StepIndex)
+    {
+        for (const FVNScriptImageRef& Ref : UpcomingSteps[StepIndex].Images)
+        {
+            if (Ref.ImageId.IsNone())
+            {
+                continue;
+            }
+            // Duplicates under different names are one decode and one cache entry
+            const int32 Score = GetPriorityScore(StepIndex, Ref.Kind);
+            const FName Id = Loader.GetCanonicalId(Ref.ImageId);
+            int32& Best = Wanted.FindOrAdd(Id, MAX_int32);
+            if (Score < Best)
+            {
+                Best = Score;
+                Kinds.Add(Id, Ref.Kind);
+            }
+        }
+    }
+
+    if (Governor)
+    {
+        for (const TPair<FName, EVNImageKind>& Pair : Kinds)
+        {
+            Governor->SetKind(Pair.Key, Pair.Value);
+        }
+    }
+
+    FScopeLock Lock(&Mutex);
+
+    // Cancel running decodes that left the window
+    for (TPair<FName, FInFlight>& Pair : InFlight)
+    {
+        if (!Wanted.Contains(Pair.Key) && !Pair.Value.bCancelled->load())
+        {
+            Pair.Value.bCancelled->store(true);
+            ++Stats.Cancelled;
+        }
+    }
+
+    // Rebuild the queue from scratch: cheaper to reason about than patching priorities
+    Queue.Reset();
+    for (const TPair<FName, int32>& Pair : Wanted)
+    {
+        if (FInFlight* Running = InFlight.Find(Pair.Key))
+        {
+            if (!Running->bCancelled->load())
+            {
+                continue;
+            }
+        }
+        if (Cache.Contains(Pair.Key))
+        {
+            continue;
+        }
+        Queue.Add({ Pair.Key, Pair.Value });
+    }
+    Queue.Sort([](const FQueued& A, const FQueued& B) { return A.Score < B.Score; });
+
+    Pump_Locked();
+}
+
+void FVNImagePrefetcher::CancelAll()
+{
+    FScopeLock Lock(&Mutex);
+    Queue.Reset();
+    for (TPair<FName, FInFlight>& Pair : InFlight)
+    {
+        if (!Pair.Value.bCancelled->load())
+        {
+            Pair.Value.bCancelled->store(true);
+            ++Stats.Cancelled;
+        }
+    }
+}
+
+void FVNImagePrefetcher::Pump_Locked()
+{
+    int32 Running = 0;
+    for (const TPair<FName, FInFlight>& Pair : InFlight)
+    {
+        Running += Pair.Value.bCancelled->load() ? 0 : 1;
+    }
+
+    for (int32 QueueIndex = 0; !bShuttingDown && Running < MaxInFlight && QueueIndex < Queue.Num(); )
+    {
+        // A cancelled decode of the same image may still be finishing; leave it queued until that drains
+        if (InFlight.Contains(Queue[QueueIndex].Id))
+        {
+            ++QueueIndex;
+            continue;
+        }
+
+        // Speculative work never pushes the scene into eviction; the critical path gets the reserve
+        if (Governor && !Governor->CanPrefetch())
+        {
+            ++Stats.Throttled;
+            break;
+        }
+
+        const FQueued Next = Queue[QueueIndex];
+        Queue.RemoveAt(QueueIndex, 1, EAllowShrinking::No);
+
+        FInFlight& Request = InFlight.Add(Next.Id);
+        Request.Score = Next.Score;
+
+        const UE::Tasks::ETaskPriority Priority = Next.Score < 10 ? UE::Tasks::ETaskPriority::BackgroundHigh
+            : Next.Score < 30 ? UE::Tasks::ETaskPriority::BackgroundNormal
+            : UE::Tasks::ETaskPriority::BackgroundLow;
+
+        TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bCancelled = Request.bCancelled;
+        const FName Id = Next.Id;
+        Request.Task = UE::Tasks::Launch(TEXT("VNImagePrefetch"), [this, Id, bCancelled]() -> FVNDecodedImagePtr
+        {
+            FVNDecodedImagePtr Image;
+            if (!bCancelled->load())
+            {
+                Image = Loader.Decode(Id);
+                if (Image.IsValid() && !bCancelled->load())
+                {
+                    Cache.Add(Image);
+                }
+            }
+            OnTaskFinished(Id, bCancelled->load());
+            return Image;
+        }, Priority);
+
+        ++Stats.Issued;
+        ++Running;
+    }
+}
+
+void FVNImagePrefetcher::OnTaskFinished(FName Id, bool bWasCancelled)
+{
+    FScopeLock Lock(&Mutex);
+    InFlight.Remove(Id);
+    if (!bWasCancelled)
+    {
+        ++Stats.Completed;
+    }
+    Pump_Locked();
+}
+
+FVNDecodedImagePtr FVNImagePrefetcher::Acquire(FName RequestedId)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNImagePrefetcher_Acquire, WebPChannel);
+
+    const FName Id = Loader.GetCanonicalId(RequestedId);
+
+    if (FVNDecodedImagePtr Cached = Cache.Find(Id))
+    {
+        FScopeLock Lock(&Mutex);
+        ++Stats.AcquireHits;
+        return Cached;
+    }
+
+    UE::Tasks::TTask<FVNDecodedImagePtr> Pending;
+    {
+        FScopeLock Lock(&Mutex);
+        if (const FInFlight* Running = InFlight.Find(Id))
+        {
+            if (!Running->bCancelled->load())
+            {
+                Pending = Running->Task;
+                ++Stats.AcquireWaits;
+            }
+        }
+        Queue.RemoveAll([Id](const FQueued& Queued) { return Queued.Id == Id; });
+    }
+
+    if (Pending.IsValid())
+    {
+        // Already half way there; cheaper than starting over on this thread
+        if (FVNDecodedImagePtr Image = Pending.GetResult())
+        {
+            return Image;
+        }
+    }
+
+    {
+        FScopeLock Lock(&Mutex);
+        ++Stats.AcquireMisses;
+    }
+    FVNDecodedImagePtr Image = Loader.Decode(Id);
+    if (Governor && Image.IsValid())
+    {
+        // Needed now whatever it costs: off-screen images make room for it, before it's added so it isn't a victim
+        Governor->Reserve(Image->GetSizeBytes());
+    }
+    Cache.Add(Image);
+    return Image;
+}
+
+FVNImagePrefetcher::FStats FVNImagePrefetcher::GetStats() const
+{
+    FScopeLock Lock(&Mutex);
+    return Stats;
+}
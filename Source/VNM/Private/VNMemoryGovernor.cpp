@@ -0,0 +1,293 @@
+#include "VNMemoryGovernor.h"
+#include "WebPStats.h"
+#include "Engine/Texture.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVNMemoryGovernor, Log, All);
+
+FVNMemoryGovernor::FVNMemoryGovernor(int64 InBudgetBytes)
+    : BudgetBytes(InBudgetBytes)
+{
+}
+
+void FVNMemoryGovernor::SetBudgetBytes(int64 InBudgetBytes)
+{
+    FScopeLock Lock(&Mutex);
+    BudgetBytes = InBudgetBytes;
+}
+
+int64 FVNMemoryGovernor::GetBudgetBytes() const
+{
+    FScopeLock Lock(&Mutex);
+    return BudgetBytes;
+}
+
+void FVNMemoryGovernor::SetPrefetchReserveBytes(int64 InReserveBytes)
+{
+    FScopeLock Lock(&Mutex);
+    PrefetchReserveBytes = FMath::Max<int64>(InReserveBytes, 0);
+}
+
+FVNMemoryGovernor::FAllocationHandle FVNMemoryGovernor::Track(const void* Owner, FName Id, EVNMemoryCategory Category, int64 Bytes, FOnEvict OnEvict)
+{
+    FScopeLock Lock(&Mutex);
+    const FAllocationHandle Handle = ++LastHandle;
+    FAllocation& Allocation = Allocations.Add(Handle);
+    Allocation.Owner = Owner;
+    Allocation.Id = Id;
+    Allocation.Category = Category;
+    Allocation.Bytes = Bytes;
+    Allocation.LastUse = ++UseCounter;
+    Allocation.OnEvict = MoveTemp(OnEvict);
+    GetCategoryBytes(Category) += Bytes;
+    Stats.PeakBytes = FMath::Max(Stats.PeakBytes, Stats.GetUsedBytes());
+    return Handle;
+}
+
+void FVNMemoryGovernor::Remove_Locked(FAllocationHandle Handle)
+{
+    FAllocation Removed;
+    if (Allocations.RemoveAndCopyValue(Handle, Removed))
+    {
+        GetCategoryBytes(Removed.Category) -= Removed.Bytes;
+    }
+}
+
+void FVNMemoryGovernor::Untrack(FAllocationHandle Handle)
+{
+    FScopeLock Lock(&Mutex);
+    Remove_Locked(Handle);
+}
+
+void FVNMemoryGovernor::UntrackAll(const void* Owner)
+{
+    {
+        FScopeLock Lock(&Mutex);
+        TArray<FAllocationHandle> Owned;
+        for (const TPair<FAllocationHandle, FAllocation>& Pair : Allocations)
+        {
+            if (Pair.Value.Owner == Owner)
+            {
+                Owned.Add(Pair.Key);
+            }
+        }
+        for (FAllocationHandle Handle : Owned)
+        {
+            Remove_Locked(Handle);
+        }
+    }
+
+    // Nothing of Owner's can be picked any more; what remains is a delegate already past that point
+    for (;;)
+    {
+        {
+            FScopeLock Lock(&Mutex);
+            if (!EvictingOwners.Contains(Owner))
+            {
+                return;
+            }
+        }
+        FPlatformProcess::Yield();
+    }
+}
+
+void FVNMemoryGovernor::Touch(FName Id)
+{
+    FScopeLock Lock(&Mutex);
+    const uint64 Use = ++UseCounter;
+    for (TPair<FAllocationHandle, FAllocation>& Pair : Allocations)
+    {
+        if (Pair.Value.Id == Id)
+        {
+            Pair.Value.LastUse = Use;
+        }
+    }
+}
+
+void FVNMemoryGovernor::SetKind(FName Id, EVNImageKind Kind)
+{
+    FScopeLock Lock(&Mutex);
+    Kinds.Add(Id, Kind);
+}
+
+void FVNMemoryGovernor::AddOnScreen(FName Id)
+{
+    FScopeLock Lock(&Mutex);
+    ++OnScreen.FindOrAdd(Id, 0);
+}
+
+void FVNMemoryGovernor::RemoveOnScreen(FName Id)
+{
+    FScopeLock Lock(&Mutex);
+    int32* Count = OnScreen.Find(Id);
+    if (ensureMsgf(Count, TEXT("RemoveOnScreen of '%s' without a matching AddOnScreen"), *Id.ToString()) && --*Count == 0)
+    {
+        OnScreen.Remove(Id);
+    }
+}
+
+int64 FVNMemoryGovernor::GetUsedBytes() const
+{
+    FScopeLock Lock(&Mutex);
+    return Stats.GetUsedBytes();
+}
+
+int64 FVNMemoryGovernor::GetHeadroomBytes() const
+{
+    FScopeLock Lock(&Mutex);
+    return FMath::Max<int64>(BudgetBytes - Stats.GetUsedBytes(), 0);
+}
+
+bool FVNMemoryGovernor::CanPrefetch(int64 Bytes) const
+{
+    FScopeLock Lock(&Mutex);
+    return BudgetBytes - Stats.GetUsedBytes() - Bytes >= PrefetchReserveBytes;
+}
+
+int32 FVNMemoryGovernor::GetEvictionPriority(const EVNImageKind* Kind)
+{
+    if (!Kind)
+    {
+        return 0; // Not referenced by the lookahead: nothing upcoming needs it
+    }
+    // Sprites are small and swap every few lines; a background or CG missing on return is a visible stall
+    switch (*Kind)
+    {
+    case EVNImageKind::Sprite:     return 1;
+    case EVNImageKind::Overlay:    return 2;
+    case EVNImageKind::UI:         return 3;
+    case EVNImageKind::CG:         return 4;
+    case EVNImageKind::Background: return 5;
+    }
+    return 0;
+}
+
+int64 FVNMemoryGovernor::GetTextureBytes(const UTexture* Texture)
+{
+    return Texture ? (int64)Texture->CalcTextureMemorySizeEnum(TMC_ResidentMips) : 0;
+}
+
+void FVNMemoryGovernor::SelectVictims_Locked(int64 TargetBytes, const TSet<FAllocationHandle>& Skipped, TArray<FVictim>& OutVictims) const
+{
+    struct FCandidate
+    {
+        FAllocationHandle Handle;
+        const FAllocation* Allocation;
+        int32 Priority;
+    };
+
+    TArray<FCandidate> Candidates;
+    for (const TPair<FAllocationHandle, FAllocation>& Pair : Allocations)
+    {
+        const FAllocation& Allocation = Pair.Value;
+        if (Allocation.OnEvict.IsBound() && !OnScreen.Contains(Allocation.Id) && !Skipped.Contains(Pair.Key))
+        {
+            Candidates.Add({ Pair.Key, &Allocation, GetEvictionPriority(Kinds.Find(Allocation.Id)) });
+        }
+    }
+
+    // Decoded pixels go before textures of the same priority: a texture is what's drawn, the pixels are a re-upload
+    Candidates.Sort([](const FCandidate& A, const FCandidate& B)
+    {
+        if (A.Priority != B.Priority)
+        {
+            return A.Priority < B.Priority;
+        }
+        if (A.Allocation->Category != B.Allocation->Category)
+        {
+            return A.Allocation->Category == EVNMemoryCategory::Decoded;
+        }
+        return A.Allocation->LastUse < B.Allocation->LastUse;
+    });
+
+    int64 Used = Stats.GetUsedBytes();
+    for (const FCandidate& Candidate : Candidates)
+    {
+        if (Used <= TargetBytes)
+        {
+            break;
+        }
+        OutVictims.Add({ Candidate.Handle, Candidate.Allocation->Bytes });
+        Used -= Candidate.Allocation->Bytes;
+    }
+}
+
+int64 FVNMemoryGovernor::EvictTo(int64 TargetBytes)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNMemoryGovernor_Evict, WebPChannel);
+
+    int64 Freed = 0;
+    // Everything tried once is skipped afterwards, whether it went or refused, so this always terminates
+    TSet<FAllocationHandle> Skipped;
+    for (;;)
+    {
+        TArray<FVictim> Victims;
+        {
+            FScopeLock Lock(&Mutex);
+            if (Stats.GetUsedBytes() <= TargetBytes)
+            {
+                break;
+            }
+            SelectVictims_Locked(TargetBytes, Skipped, Victims);
+            if (Victims.Num() == 0)
+            {
+                ++Stats.OverBudget;
+                UE_LOG(LogVNMemoryGovernor, Verbose, TEXT("Over budget: %lld bytes used, target %lld, nothing left to evict"), Stats.GetUsedBytes(), TargetBytes);
+                break;
+            }
+        }
+
+        // Outside the lock: holders take their own locks and Untrack from inside the delegate
+        for (const FVictim& Victim : Victims)
+        {
+            Skipped.Add(Victim.Handle);
+
+            FOnEvict OnEvict;
+            const void* Owner = nullptr;
+            {
+                FScopeLock Lock(&Mutex);
+                const FAllocation* Allocation = Allocations.Find(Victim.Handle);
+                if (!Allocation)
+                {
+                    continue; // Freed since it was picked, maybe with its owner (UntrackAll)
+                }
+                OnEvict = Allocation->OnEvict;
+                Owner = Allocation->Owner;
+                EvictingOwners.Add(Owner); // Holds off the owner's UntrackAll until the delegate has returned
+            }
+
+            const bool bEvicted = OnEvict.Execute(Victim.Handle);
+
+            FScopeLock Lock(&Mutex);
+            EvictingOwners.RemoveSingleSwap(Owner, EAllowShrinking::No);
+            if (bEvicted)
+            {
+                ++Stats.Evictions;
+                Stats.EvictedBytes += Victim.Bytes;
+                Freed += Victim.Bytes;
+            }
+            else
+            {
+                ++Stats.Refusals;
+            }
+        }
+    }
+    return Freed;
+}
+
+int64 FVNMemoryGovernor::Enforce()
+{
+    return EvictTo(GetBudgetBytes());
+}
+
+int64 FVNMemoryGovernor::Reserve(int64 Bytes)
+{
+    EvictTo(GetBudgetBytes() - FMath::Max<int64>(Bytes, 0));
+    FScopeLock Lock(&Mutex);
+    return BudgetBytes - Stats.GetUsedBytes() - Bytes;
+}
+
+FVNMemoryGovernor::FStats FVNMemoryGovernor::GetStats() const
+{
+    FScopeLock Lock(&Mutex);
+    return Stats;
+}
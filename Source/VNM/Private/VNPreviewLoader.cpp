@@ -0,0 +1,173 @@
+#include "VNPreviewLoader.h"
+#include "VNImageLoader.h"
+#include "VNSceneCompositor.h"
+#include "WebPStats.h"
+#include "Engine/Texture2D.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVNPreviewLoader, Log, All);
+
+FVNPreviewLoader::FVNPreviewLoader(const FVNImageLoader& InLoader)
+    : Loader(InLoader)
+{
+}
+
+FVNPreviewLoader::~FVNPreviewLoader()
+{
+    CancelAll();
+}
+
+FVNPreviewLoader::FHandle::~FHandle()
+{
+    if (Governor)
+    {
+        Governor->Untrack(TextureAllocation);
+        Governor->RemoveOnScreen(CanonicalId);
+    }
+}
+
+void FVNPreviewLoader::FHandle::TrackTexture()
+{
+    if (Governor)
+    {
+        // No eviction delegate: the texture is what's on screen, only the handle going away frees it
+        Governor->Untrack(TextureAllocation);
+        TextureAllocation = Governor->Track(this, CanonicalId, EVNMemoryCategory::Texture, FVNMemoryGovernor::GetTextureBytes(Texture.Get()));
+    }
+}
+
+TSharedPtr<FVNPreviewLoader::FHandle> FVNPreviewLoader::Load(FName Id)
+{
+    check(IsInGameThread());
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNPreviewLoader_Load, WebPChannel);
+
+    TSharedPtr<FHandle> Handle = MakeShared<FHandle>();
+    Handle->Id = Id;
+    if (Governor)
+    {
+        Handle->Governor = Governor;
+        Handle->CanonicalId = Loader.GetCanonicalId(Id);
+        Governor->AddOnScreen(Handle->CanonicalId);
+    }
+
+    FPending& Entry = Pending.AddDefaulted_GetRef();
+    Entry.Handle = Handle;
+    Entry.StartSeconds = FPlatformTime::Seconds();
+    const FVNImageLoader* LoaderPtr = &Loader;
+    const int32 PreviewMaxDimension = Settings.PreviewMaxDimension;
+    TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bCancelled = Entry.bCancelled;
+    // Both on workers: even scaled, the preview decodes the whole bitstream, which is too long for the game thread
+    Entry.PreviewTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [LoaderPtr, Id, PreviewMaxDimension, bCancelled]() -> FVNDecodedImagePtr
+    {
+        return bCancelled->load(std::memory_order_relaxed) ? nullptr : LoaderPtr->Decode(Id, PreviewMaxDimension);
+    });
+    Entry.Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [LoaderPtr, Id, bCancelled]() -> FVNDecodedImagePtr
+    {
+        return bCancelled->load(std::memory_order_relaxed) ? nullptr : LoaderPtr->Decode(Id);
+    });
+
+    return Handle;
+}
+
+bool FVNPreviewLoader::ShowImage(FPending& Entry, const FVNDecodedImage& Image, bool bIsFullResolution)
+{
+    FHandle& Handle = *Entry.Handle;
+    if (Governor)
+    {
+        // The handle keeps its image on screen, so this evicts other images, never the one being shown
+        Governor->Reserve(Image.GetSizeBytes());
+    }
+    UTexture2D* Texture = FVNSceneCompositor::CreateTexture(Image.Pixels, FIntPoint(Image.Width, Image.Height));
+    if (!Texture)
+    {
+        return false;
+    }
+
+    const bool bIsFirstTexture = !Handle.Texture.IsValid();
+    Handle.Texture.Reset(Texture);
+    Handle.TrackTexture();
+    Handle.bIsFullResolution = bIsFullResolution;
+    if (Image.HitMask.IsValid())
+    {
+        Handle.HitMask = Image.HitMask; // Coarse for the preview; the pixels themselves go away with the task
+    }
+
+    const double Seconds = FPlatformTime::Seconds() - Entry.StartSeconds;
+    if (bIsFirstTexture)
+    {
+        Handle.TimeToFirstPixelSeconds = Seconds;
+        ++Stats.Loads;
+        Stats.TotalTimeToFirstPixelSeconds += Seconds;
+    }
+    if (bIsFullResolution)
+    {
+        Handle.TimeToFullResolutionSeconds = Seconds;
+        ++Stats.Swaps;
+        Stats.TotalTimeToFullResolutionSeconds += Seconds;
+        UE_LOG(LogVNPreviewLoader, Verbose, TEXT("%s: first pixel after %.2f ms, full resolution after %.2f ms"),
+            *Handle.Id.ToString(), Handle.TimeToFirstPixelSeconds * 1000.0, Handle.TimeToFullResolutionSeconds * 1000.0);
+    }
+    Handle.OnTextureChanged.Broadcast();
+    return true;
+}
+
+void FVNPreviewLoader::Tick()
+{
+    check(IsInGameThread());
+
+    for (int32 Index = 0; Index < Pending.Num();)
+    {
+        FPending& Entry = Pending[Index];
+        const bool bCancelled = Entry.bCancelled->load(std::memory_order_relaxed);
+
+        // Full resolution first: once it's in, a late preview would only be a step back
+        if (!Entry.Task.IsCompleted())
+        {
+            if (!Entry.bPreviewHandled && Entry.PreviewTask.IsCompleted())
+            {
+                Entry.bPreviewHandled = true;
+                const FVNDecodedImagePtr Preview = Entry.PreviewTask.GetResult();
+                if (Preview.IsValid() && !bCancelled)
+                {
+                    ShowImage(Entry, *Preview, false);
+                }
+            }
+            ++Index;
+            continue;
+        }
+
+        const FVNDecodedImagePtr Image = Entry.Task.GetResult();
+        if (Image.IsValid() && !bCancelled)
+        {
+            ShowImage(Entry, *Image, true);
+        }
+        else if (!bCancelled)
+        {
+            UE_LOG(LogVNPreviewLoader, Warning, TEXT("Full-resolution decode of '%s' failed%s"), *Entry.Handle->Id.ToString(),
+                Entry.Handle->Texture.IsValid() ? TEXT(", keeping the preview") : TEXT(""));
+        }
+
+        // The preview decode references the loader too; it's dropped, but has to be finished before the entry goes
+        Entry.bCancelled->store(true, std::memory_order_relaxed);
+        if (!Entry.PreviewTask.IsCompleted())
+        {
+            ++Index;
+            continue;
+        }
+        Pending.RemoveAt(Index);
+    }
+}
+
+void FVNPreviewLoader::CancelAll()
+{
+    for (FPending& Entry : Pending)
+    {
+        Entry.bCancelled->store(true, std::memory_order_relaxed);
+    }
+    // Decodes reference the loader, so they must not outlive this call's caller tearing things down
+    for (FPending& Entry : Pending)
+    {
+        Entry.PreviewTask.Wait();
+        Entry.Task.Wait();
+    }
+    Pending.Empty();
+}
@@ -0,0 +1,199 @@
+#include "VNProgressiveUploader.h"
+#include "VNImageLoader.h"
+#include "WebPBufferPool.h"
+#include "WebPIncrementalDecoder.h"
+#include "WebPStats.h"
+#include "WebPMemory.h"
+#include "Engine/Texture2D.h"
+#include "WebPImageSupport/Private/WebpImageWrapper.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVNProgressiveUploader, Log, All);
+
+FVNProgressiveUploader::FVNProgressiveUploader(const FVNImageLoader& InLoader)
+    : Loader(InLoader)
+{
+}
+
+FVNProgressiveUploader::~FVNProgressiveUploader()
+{
+    CancelAll();
+    LastTask.Wait();
+    for (const TSharedPtr<FJob, ESPMode::ThreadSafe>& Job : Jobs)
+    {
+        FWebPBufferPool::Get().Release(Job->LooseBytes);
+    }
+}
+
+UTexture2D* FVNProgressiveUploader::Load(FName Id)
+{
+    check(IsInGameThread());
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNProgressiveUploader_Load, WebPChannel);
+
+    TSharedPtr<FJob, ESPMode::ThreadSafe> Job = MakeShared<FJob, ESPMode::ThreadSafe>();
+    Job->Id = Id;
+    Job->StartSeconds = FPlatformTime::Seconds();
+    Job->Compressed = Loader.FindCompressed(Id, Job->LooseBytes);
+
+    // Header only, for the texture size
+    FWebpImageWrapper Probe;
+    if (Job->Compressed.Num() == 0 || !Probe.SetCompressedView(Job->Compressed.GetData(), Job->Compressed.Num()))
+    {
+        FWebPBufferPool::Get().Release(Job->LooseBytes);
+        return nullptr;
+    }
+    Job->Width = (int32)Probe.GetWidth();
+    Job->Height = (int32)Probe.GetHeight();
+
+    {
+        LLM_SCOPE_BYTAG(WebP_Decoded);
+        Job->Pixels = MakeShareable(new TArray64<uint8>(FWebPBufferPool::Get().Acquire((int64)Job->Width * Job->Height * 4)),
+            [](TArray64<uint8>* Buffer)
+            {
+                FWebPBufferPool::Get().Release(*Buffer);
+                delete Buffer;
+            });
+    }
+
+    {
+        LLM_SCOPE_BYTAG(WebP_TextureStaging);
+        UTexture2D* Texture = UTexture2D::CreateTransient(Job->Width, Job->Height, PF_B8G8R8A8);
+        if (!Texture)
+        {
+            FWebPBufferPool::Get().Release(Job->LooseBytes);
+            return nullptr;
+        }
+
+        // Black until the first band lands; the mip is only the initial contents, bands go through UpdateTextureRegions
+        FByteBulkData& BulkData = Texture->GetPlatformData()->Mips[0].BulkData;
+        FMemory::Memzero(BulkData.Lock(LOCK_READ_WRITE), BulkData.GetBulkDataSize());
+        BulkData.Unlock();
+        {
+            WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_TextureUpload);
+            Texture->UpdateResource();
+        }
+        Job->Texture.Reset(Texture);
+    }
+
+    // Chained so images decode in request order, one at a time
+    const FSettings TaskSettings = Settings;
+    auto Body = [Job, TaskSettings]() { DecodeJob(*Job, TaskSettings); };
+    LastTask = LastTask.IsValid()
+        ? UE::Tasks::Launch(UE_SOURCE_LOCATION, MoveTemp(Body), UE::Tasks::Prerequisites(LastTask))
+        : UE::Tasks::Launch(UE_SOURCE_LOCATION, MoveTemp(Body));
+
+    Jobs.Add(Job);
+    return Job->Texture.Get();
+}
+
+void FVNProgressiveUploader::DecodeJob(FJob& Job, const FSettings& Settings)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNProgressiveUploader_Decode, WebPChannel);
+    FWebPInFlightScope InFlight;
+
+    FWebPDecodeOptions Options;
+    Options.bPremultiplyAlpha = Settings.bPremultiplyAlpha;
+
+    FWebPIncrementalDecoder Decoder;
+    bool bSucceeded = false;
+    if (Decoder.Begin(ERGBFormat::BGRA, Options, Job.Pixels->GetData(), (int64)Job.Width * 4, Job.Pixels->Num()))
+    {
+        const int64 TotalBytes = Job.Compressed.Num();
+        const int64 ChunkBytes = FMath::Max<int64>(Settings.ChunkBytes, 1024);
+        int64 Available = 0;
+        while (!Job.bCancelled.load(std::memory_order_relaxed))
+        {
+            Available = FMath::Min(Available + ChunkBytes, TotalBytes);
+            const FWebPIncrementalDecoder::EStatus Status = Decoder.Update(Job.Compressed.GetData(), Available);
+            if (Status == FWebPIncrementalDecoder::EStatus::Done)
+            {
+                Job.DecodedRows.store(Job.Height, std::memory_order_release);
+                bSucceeded = true;
+                break;
+            }
+            if (Status == FWebPIncrementalDecoder::EStatus::Error || Available == TotalBytes)
+            {
+                break; // Corrupt or truncated
+            }
+            Job.DecodedRows.store(Decoder.GetDecodedRows(), std::memory_order_release);
+        }
+    }
+
+    Job.bDecodeFailed.store(!bSucceeded && !Job.bCancelled.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    Job.bDecodeFinished.store(true, std::memory_order_release);
+}
+
+void FVNProgressiveUploader::Tick()
+{
+    check(IsInGameThread());
+
+    for (int32 Index = 0; Index < Jobs.Num();)
+    {
+        FJob& Job = *Jobs[Index];
+
+        // Finished first: once it is set, DecodedRows is final
+        const bool bFinished = Job.bDecodeFinished.load(std::memory_order_acquire);
+        const int32 Rows = Job.DecodedRows.load(std::memory_order_acquire);
+
+        if (Job.Texture.IsValid() && Rows > Job.UploadedRows
+            && (bFinished || Rows - Job.UploadedRows >= Settings.MinBandRows))
+        {
+            UploadBand(Job, Rows);
+        }
+
+        if (!bFinished)
+        {
+            ++Index;
+            continue;
+        }
+
+        if (Job.bDecodeFailed.load(std::memory_order_relaxed))
+        {
+            UE_LOG(LogVNProgressiveUploader, Warning, TEXT("Failed to decode image '%s' (%d of %d rows shown)"),
+                *Job.Id.ToString(), Job.UploadedRows, Job.Height);
+        }
+        else if (!Job.bCancelled.load(std::memory_order_relaxed))
+        {
+            ++Stats.ImagesCompleted;
+            Stats.LastCompleteSeconds = FPlatformTime::Seconds() - Job.StartSeconds;
+        }
+        FWebPBufferPool::Get().Release(Job.LooseBytes);
+        Jobs.RemoveAt(Index);
+    }
+}
+
+void FVNProgressiveUploader::UploadBand(FJob& Job, int32 EndRow)
+{
+    WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_TextureUpload);
+
+    const uint32 Pitch = Job.Width * 4;
+    FUpdateTextureRegion2D* Region = new FUpdateTextureRegion2D(0, Job.UploadedRows, 0, Job.UploadedRows, Job.Width, EndRow - Job.UploadedRows);
+
+    // Rows above DecodedRows are never written again, so the render thread can read them from the decode target
+    // while the worker keeps writing below; the captured pointer keeps the buffer alive until the copy ran.
+    TSharedPtr<TArray64<uint8>, ESPMode::ThreadSafe> Pixels = Job.Pixels;
+    Job.Texture->UpdateTextureRegions(0, 1, Region, Pitch, 4, Pixels->GetData(),
+        [Pixels](uint8* SrcData, const FUpdateTextureRegion2D* InRegions)
+        {
+            delete InRegions;
+        });
+
+    const int64 BandBytes = (int64)(EndRow - Job.UploadedRows) * Pitch;
+    Job.UploadedRows = EndRow;
+    ++Stats.BandsUploaded;
+    Stats.BytesUploaded += BandBytes;
+    INC_DWORD_STAT_BY(STAT_WebP_UploadedBytes, BandBytes);
+
+    if (!Job.bFirstBandUploaded)
+    {
+        Job.bFirstBandUploaded = true;
+        Stats.LastFirstBandSeconds = FPlatformTime::Seconds() - Job.StartSeconds;
+    }
+}
+
+void FVNProgressiveUploader::CancelAll()
+{
+    for (const TSharedPtr<FJob, ESPMode::ThreadSafe>& Job : Jobs)
+    {
+        Job->bCancelled.store(true, std::memory_order_relaxed);
+    }
+}
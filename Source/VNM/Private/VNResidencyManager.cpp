@@ -0,0 +1,479 @@
+#include "VNResidencyManager.h"
+#include "VNImageLoader.h"
+#include "VNMemoryGovernor.h"
+#include "WebPStats.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVNResidency, Log, All);
+
+const TCHAR* LexToString(EVNResidency Residency)
+{
+    switch (Residency)
+    {
+    case EVNResidency::None:       return TEXT("None");
+    case EVNResidency::Compressed: return TEXT("Compressed");
+    case EVNResidency::Decoded:    return TEXT("Decoded");
+    }
+    return TEXT("Unknown");
+}
+
+FVNResidencyManager::FVNResidencyManager(const FVNImageLoader& InLoader, int64 InDecodedBudgetBytes)
+    : Loader(InLoader)
+    , DecodedBudgetBytes(InDecodedBudgetBytes)
+{
+}
+
+FVNResidencyManager::~FVNResidencyManager()
+{
+    // The governor may be about to call our eviction delegate on another thread
+    SetGovernor(nullptr);
+    Entries.Empty();
+}
+
+void FVNResidencyManager::SetGovernor(FVNMemoryGovernor* InGovernor)
+{
+    FVNMemoryGovernor* Previous = nullptr;
+    {
+        FScopeLock Lock(&Mutex);
+        if (Governor == InGovernor)
+        {
+            return;
+        }
+        Previous = Governor;
+        Governor = InGovernor;
+        for (TPair<FName, FEntry>& Pair : Entries)
+        {
+            if (Pair.Value.PinCount > 0)
+            {
+                if (Previous)
+                {
+                    Previous->RemoveOnScreen(Pair.Key);
+                }
+                if (Governor)
+                {
+                    Governor->AddOnScreen(Pair.Key);
+                }
+            }
+            Pair.Value.GovernorHandle = 0;
+            Track_Locked(Pair.Key, Pair.Value);
+        }
+    }
+    // Outside the lock: a delegate of ours still running takes it
+    if (Previous)
+    {
+        Previous->UntrackAll(this);
+    }
+}
+
+void FVNResidencyManager::Track_Locked(FName Id, FEntry& Entry)
+{
+    if (Governor && Entry.Decoded.IsValid())
+    {
+        Governor->Untrack(Entry.GovernorHandle);
+        Entry.GovernorHandle = Governor->Track(this, Id, EVNMemoryCategory::Decoded, Entry.Decoded->GetSizeBytes(),
+            FVNMemoryGovernor::FOnEvict::CreateRaw(this, &FVNResidencyManager::OnGovernorEvict, Id));
+    }
+}
+
+FVNResidencyManager::FCompressedPtr FVNResidencyManager::LoadCompressed(FName Id) const
+{
+    FCompressedPtr Compressed = MakeShared<FCompressed, ESPMode::ThreadSafe>();
+    Compressed->Bytes = Loader.FindCompressed(Id, Compressed->OwnedBytes);
+    if (Compressed->Bytes.Num() == 0)
+    {
+        return nullptr;
+    }
+    if (Compressed->OwnedBytes.Num() == 0)
+    {
+        // A slice of a mapped bundle: resident once the OS has paged it in, so ask for that now, not mid-decode
+        Loader.PreloadCompressed(Id);
+    }
+    return Compressed;
+}
+
+FVNResidencyManager::FEntry& FVNResidencyManager::FindOrAdd_Locked(FName Id, const FCompressedPtr& Loaded, TArray<FTransition>& OutTransitions)
+{
+    if (FEntry* Existing = Entries.Find(Id))
+    {
+        return *Existing; // Another thread loaded it first; Loaded just goes away
+    }
+    FEntry& Entry = Entries.Add(Id);
+    Entry.Compressed = Loaded;
+    Stats.CompressedBytes += Loaded->Bytes.Num();
+    OutTransitions.Add({ Id, EVNResidency::None, EVNResidency::Compressed });
+    return Entry;
+}
+
+void FVNResidencyManager::Remove_Locked(FName Id, TArray<FTransition>& OutTransitions)
+{
+    FEntry Removed;
+    if (Entries.RemoveAndCopyValue(Id, Removed))
+    {
+        Stats.CompressedBytes -= Removed.Compressed->Bytes.Num();
+        if (Removed.Decoded.IsValid())
+        {
+            Stats.DecodedBytes -= Removed.Decoded->GetSizeBytes();
+        }
+        if (Governor)
+        {
+            Governor->Untrack(Removed.GovernorHandle);
+            if (Removed.PinCount > 0)
+            {
+                Governor->RemoveOnScreen(Id); // ReleaseAll drops pinned images too
+            }
+        }
+        OutTransitions.Add({ Id, Removed.GetResidency(), EVNResidency::None });
+    }
+}
+
+int64 FVNResidencyManager::EvictDecoded_Locked(int64 MaxDecodedBytes, TArray<FTransition>& OutTransitions)
+{
+    // Linear scan like FVNImageCache: a chapter is hundreds of images at most, and only a few hold pixels
+    int64 Freed = 0;
+    while (Stats.DecodedBytes > MaxDecodedBytes)
+    {
+        FName Oldest;
+        FEntry* OldestEntry = nullptr;
+        for (TPair<FName, FEntry>& Pair : Entries)
+        {
+            FEntry& Entry = Pair.Value;
+            if (Entry.Decoded.IsValid() && Entry.PinCount == 0 && (!OldestEntry || Entry.LastUse < OldestEntry->LastUse))
+            {
+                Oldest = Pair.Key;
+                OldestEntry = &Entry;
+            }
+        }
+        if (!OldestEntry)
+        {
+            break; // Everything left is pinned
+        }
+
+        const int64 Size = OldestEntry->Decoded->GetSizeBytes();
+        OldestEntry->Decoded.Reset(); // Holders elsewhere keep their pixels; we just stop holding them
+        Stats.DecodedBytes -= Size;
+        Freed += Size;
+        ++Stats.Evictions;
+        OutTransitions.Add({ Oldest, EVNResidency::Decoded, EVNResidency::Compressed });
+        if (Governor)
+        {
+            Governor->Untrack(OldestEntry->GovernorHandle);
+            OldestEntry->GovernorHandle = 0;
+        }
+    }
+    return Freed;
+}
+
+bool FVNResidencyManager::OnGovernorEvict(uint64 Handle, FName Id)
+{
+    TArray<FTransition> Transitions;
+    {
+        FScopeLock Lock(&Mutex);
+        FEntry* Entry = Entries.Find(Id);
+        if (!Entry || !Entry->Decoded.IsValid() || Entry->GovernorHandle != Handle)
+        {
+            return true; // Already evicted or released
+        }
+        if (Entry->PinCount > 0)
+        {
+            return false;
+        }
+        Stats.DecodedBytes -= Entry->Decoded->GetSizeBytes();
+        ++Stats.Evictions;
+        Entry->Decoded.Reset();
+        Entry->GovernorHandle = 0;
+        Governor->Untrack(Handle);
+        Transitions.Add({ Id, EVNResidency::Decoded, EVNResidency::Compressed });
+    }
+    Broadcast(Transitions);
+    return true;
+}
+
+void FVNResidencyManager::Broadcast(const TArray<FTransition>& Transitions)
+{
+    for (const FTransition& Transition : Transitions)
+    {
+        UE_LOG(LogVNResidency, VeryVerbose, TEXT("%s: %s -> %s"), *Transition.Id.ToString(), LexToString(Transition.From), LexToString(Transition.To));
+        ResidencyChanged.Broadcast(Transition.Id, Transition.From, Transition.To);
+    }
+}
+
+bool FVNResidencyManager::MakeResident(FName RequestedId)
+{
+    const FName Id = Loader.GetCanonicalId(RequestedId);
+    {
+        FScopeLock Lock(&Mutex);
+        if (FEntry* Entry = Entries.Find(Id))
+        {
+            Entry->bInResidentSet = true;
+            return true;
+        }
+    }
+
+    const FCompressedPtr Loaded = LoadCompressed(Id);
+    if (!Loaded.IsValid())
+    {
+        return false;
+    }
+    TArray<FTransition> Transitions;
+    {
+        FScopeLock Lock(&Mutex);
+        FindOrAdd_Locked(Id, Loaded, Transitions).bInResidentSet = true;
+    }
+    Broadcast(Transitions);
+    return true;
+}
+
+void FVNResidencyManager::SetResidentSet(TConstArrayView<FName> Ids)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNResidencyManager_SetResidentSet, WebPChannel);
+
+    TSet<FName> Wanted;
+    Wanted.Reserve(Ids.Num());
+    for (FName Id : Ids)
+    {
+        if (!Id.IsNone())
+        {
+            Wanted.Add(Loader.GetCanonicalId(Id));
+        }
+    }
+
+    TArray<FTransition> Transitions;
+    {
+        FScopeLock Lock(&Mutex);
+        TArray<FName> Dropped;
+        for (TPair<FName, FEntry>& Pair : Entries)
+        {
+            Pair.Value.bInResidentSet = Wanted.Contains(Pair.Key);
+            if (!Pair.Value.bInResidentSet && Pair.Value.PinCount == 0)
+            {
+                Dropped.Add(Pair.Key);
+            }
+        }
+        for (FName Id : Dropped)
+        {
+            Remove_Locked(Id, Transitions);
+        }
+    }
+    Broadcast(Transitions);
+
+    // Loose files are disk reads: done one at a time outside the lock so decodes on other threads aren't held up
+    for (FName Id : Wanted)
+    {
+        MakeResident(Id);
+    }
+}
+
+void FVNResidencyManager::Release(FName RequestedId)
+{
+    const FName Id = Loader.GetCanonicalId(RequestedId);
+    TArray<FTransition> Transitions;
+    {
+        FScopeLock Lock(&Mutex);
+        if (FEntry* Entry = Entries.Find(Id))
+        {
+            Entry->bInResidentSet = false;
+            if (Entry->PinCount == 0)
+            {
+                Remove_Locked(Id, Transitions);
+            }
+        }
+    }
+    Broadcast(Transitions);
+}
+
+void FVNResidencyManager::ReleaseAll()
+{
+    TArray<FTransition> Transitions;
+    {
+        FScopeLock Lock(&Mutex);
+        TArray<FName> Ids;
+        Entries.GetKeys(Ids);
+        for (FName Id : Ids)
+        {
+            Remove_Locked(Id, Transitions);
+        }
+    }
+    Broadcast(Transitions);
+}
+
+FVNDecodedImagePtr FVNResidencyManager::Acquire(FName RequestedId)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNResidencyManager_Acquire, WebPChannel);
+
+    const FName Id = Loader.GetCanonicalId(RequestedId);
+    TArray<FTransition> Transitions;
+    FCompressedPtr Compressed;
+    {
+        FScopeLock Lock(&Mutex);
+        if (FEntry* Entry = Entries.Find(Id))
+        {
+            Entry->LastUse = ++UseCounter;
+            if (Entry->Decoded.IsValid())
+            {
+                ++Stats.DecodedHits;
+                if (Governor)
+                {
+                    Governor->Touch(Id);
+                }
+                return Entry->Decoded;
+            }
+            Compressed = Entry->Compressed;
+        }
+    }
+
+    if (!Compressed.IsValid())
+    {
+        const FCompressedPtr Loaded = LoadCompressed(Id);
+        if (!Loaded.IsValid())
+        {
+            return nullptr;
+        }
+        FScopeLock Lock(&Mutex);
+        ++Stats.ColdLoads;
+        FEntry& Entry = FindOrAdd_Locked(Id, Loaded, Transitions);
+        Entry.LastUse = ++UseCounter;
+        Compressed = Entry.Compressed;
+    }
+
+    // The trade this class makes: a decode from memory instead of holding the pixels all chapter
+    const double StartSeconds = FPlatformTime::Seconds();
+    const FVNDecodedImagePtr Image = Loader.DecodeCompressed(Id, Compressed->Bytes);
+    const double DecodeSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+    FVNDecodedImagePtr Result = Image;
+    if (Image.IsValid() && Governor)
+    {
+        // Needed now: off-screen images elsewhere make room, before it's tracked so it isn't a victim itself
+        Governor->Reserve(Image->GetSizeBytes());
+    }
+    if (Image.IsValid())
+    {
+        FScopeLock Lock(&Mutex);
+        ++Stats.Decodes;
+        Stats.TotalDecodeSeconds += DecodeSeconds;
+
+        FEntry* Entry = Entries.Find(Id);
+        if (Entry && Entry->Decoded.IsValid())
+        {
+            Result = Entry->Decoded; // Decoded concurrently by another thread; share one copy
+        }
+        else if (Entry)
+        {
+            // Room first, so the image just decoded is never its own eviction victim
+            EvictDecoded_Locked(DecodedBudgetBytes - Image->GetSizeBytes(), Transitions);
+            Entry = Entries.Find(Id);
+            Entry->Decoded = Image;
+            Entry->LastUse = ++UseCounter;
+            Stats.DecodedBytes += Image->GetSizeBytes();
+            Stats.PeakDecodedBytes = FMath::Max(Stats.PeakDecodedBytes, Stats.DecodedBytes);
+            Transitions.Add({ Id, EVNResidency::Compressed, EVNResidency::Decoded });
+            Track_Locked(Id, *Entry);
+        }
+        // No entry: released while decoding. The caller still gets its pixels, nothing is kept.
+    }
+    Broadcast(Transitions);
+    return Result;
+}
+
+void FVNResidencyManager::Pin(FName RequestedId)
+{
+    const FName Id = Loader.GetCanonicalId(RequestedId);
+    {
+        FScopeLock Lock(&Mutex);
+        if (FEntry* Entry = Entries.Find(Id))
+        {
+            if (++Entry->PinCount == 1 && Governor)
+            {
+                Governor->AddOnScreen(Id);
+            }
+            return;
+        }
+    }
+
+    const FCompressedPtr Loaded = LoadCompressed(Id);
+    if (!Loaded.IsValid())
+    {
+        return;
+    }
+    TArray<FTransition> Transitions;
+    {
+        FScopeLock Lock(&Mutex);
+        if (++FindOrAdd_Locked(Id, Loaded, Transitions).PinCount == 1 && Governor)
+        {
+            Governor->AddOnScreen(Id);
+        }
+    }
+    Broadcast(Transitions);
+}
+
+void FVNResidencyManager::Unpin(FName RequestedId)
+{
+    const FName Id = Loader.GetCanonicalId(RequestedId);
+    TArray<FTransition> Transitions;
+    {
+        FScopeLock Lock(&Mutex);
+        FEntry* Entry = Entries.Find(Id);
+        if (!Entry || !ensureMsgf(Entry->PinCount > 0, TEXT("Unpin of '%s' without a matching Pin"), *Id.ToString()))
+        {
+            return;
+        }
+        if (--Entry->PinCount > 0)
+        {
+            return;
+        }
+        // Pinned images may have pushed the decoded total over budget; they're fair game now
+        EvictDecoded_Locked(DecodedBudgetBytes, Transitions);
+        if (Governor)
+        {
+            Governor->RemoveOnScreen(Id);
+        }
+    }
+    Broadcast(Transitions);
+    if (Governor)
+    {
+        // Same for the scene-wide budget; outside the lock, the governor calls back into holders
+        Governor->Enforce();
+    }
+}
+
+void FVNResidencyManager::SetDecodedBudgetBytes(int64 InBudgetBytes)
+{
+    TArray<FTransition> Transitions;
+    {
+        FScopeLock Lock(&Mutex);
+        DecodedBudgetBytes = InBudgetBytes;
+        EvictDecoded_Locked(DecodedBudgetBytes, Transitions);
+    }
+    Broadcast(Transitions);
+}
+
+int64 FVNResidencyManager::GetDecodedBudgetBytes() const
+{
+    FScopeLock Lock(&Mutex);
+    return DecodedBudgetBytes;
+}
+
+int64 FVNResidencyManager::TrimDecoded(int64 MaxDecodedBytes)
+{
+    TArray<FTransition> Transitions;
+    int64 Freed = 0;
+    {
+        FScopeLock Lock(&Mutex);
+        Freed = EvictDecoded_Locked(FMath::Max<int64>(MaxDecodedBytes, 0), Transitions);
+    }
+    Broadcast(Transitions);
+    return Freed;
+}
+
+EVNResidency FVNResidencyManager::GetResidency(FName RequestedId) const
+{
+    const FName Id = Loader.GetCanonicalId(RequestedId);
+    FScopeLock Lock(&Mutex);
+    const FEntry* Entry = Entries.Find(Id);
+    return Entry ? Entry->GetResidency() : EVNResidency::None;
+}
+
+FVNResidencyManager::FStats FVNResidencyManager::GetStats() const
+{
+    FScopeLock Lock(&Mutex);
+    return Stats;
+}
@@ -0,0 +1,351 @@
+#include "VNSceneCompositor.h"
+#include "VNBlendKernels.h"
+#include "VNMemoryGovernor.h"
+#include "WebPStats.h"
+#include "WebPMemory.h"
+#include "Engine/Texture2D.h"
+
+int32 FVNSceneCompositor::AddLayer(const FVNCompositorLayer& Layer)
+{
+    const int32 Handle = NextHandle++;
+    Layers.Add(Handle, Layer);
+    MarkDirty(GetLayerBounds(Layer));
+    return Handle;
+}
+
+void FVNSceneCompositor::UpdateLayer(int32 Handle, const FVNCompositorLayer& NewState)
+{
+    if (FVNCompositorLayer* Layer = Layers.Find(Handle))
+    {
+        // Old footprint must be repainted with whatever was underneath, new one with the new content
+        MarkDirty(GetLayerBounds(*Layer));
+        *Layer = NewState;
+        MarkDirty(GetLayerBounds(*Layer));
+    }
+}
+
+void FVNSceneCompositor::RemoveLayer(int32 Handle)
+{
+    if (const FVNCompositorLayer* Layer = Layers.Find(Handle))
+    {
+        MarkDirty(GetLayerBounds(*Layer));
+        Layers.Remove(Handle);
+    }
+}
+
+void FVNSceneCompositor::ClearLayers()
+{
+    Layers.Empty();
+    MarkAllDirty();
+}
+
+void FVNSceneCompositor::SetLayerImage(int32 Handle, const FVNDecodedImagePtr& Image)
+{
+    if (const FVNCompositorLayer* Layer = Layers.Find(Handle))
+    {
+        FVNCompositorLayer NewState = *Layer;
+        NewState.Image = Image;
+        UpdateLayer(Handle, NewState);
+    }
+}
+
+void FVNSceneCompositor::SetLayerPosition(int32 Handle, FIntPoint Position)
+{
+    if (const FVNCompositorLayer* Layer = Layers.Find(Handle))
+    {
+        FVNCompositorLayer NewState = *Layer;
+        NewState.Position = Position;
+        UpdateLayer(Handle, NewState);
+    }
+}
+
+void FVNSceneCompositor::SetLayerOpacity(int32 Handle, float Opacity)
+{
+    if (const FVNCompositorLayer* Layer = Layers.Find(Handle))
+    {
+        FVNCompositorLayer NewState = *Layer;
+        NewState.Opacity = Opacity;
+        UpdateLayer(Handle, NewState);
+    }
+}
+
+void FVNSceneCompositor::MarkDirty(const FIntRect& InRect)
+{
+    FIntRect Rect = InRect;
+    Rect.Clip(FIntRect(FIntPoint::ZeroValue, CanvasSize));
+    if (Rect.IsEmpty())
+    {
+        return;
+    }
+
+    // Absorb every existing rect that overlaps or touches, repeating since the union can grow into others
+    bool bMerged = true;
+    while (bMerged)
+    {
+        bMerged = false;
+        for (int32 Index = DirtyRegions.Num() - 1; Index >= 0; --Index)
+        {
+            const FIntRect& Other = DirtyRegions[Index];
+            const bool bTouches = Rect.Min.X <= Other.Max.X && Other.Min.X <= Rect.Max.X
+                && Rect.Min.Y <= Other.Max.Y && Other.Min.Y <= Rect.Max.Y;
+            if (bTouches)
+            {
+                Rect.Union(Other);
+                DirtyRegions.RemoveAtSwap(Index);
+                bMerged = true;
+            }
+        }
+    }
+    DirtyRegions.Add(Rect);
+
+    if (DirtyRegions.Num() > MaxDirtyRegions)
+    {
+        FIntRect Bounds = DirtyRegions[0];
+        for (const FIntRect& Region : DirtyRegions)
+        {
+            Bounds.Union(Region);
+        }
+        DirtyRegions.Reset();
+        DirtyRegions.Add(Bounds);
+    }
+}
+
+TArray<FIntRect> FVNSceneCompositor::TakeDirtyRegions()
+{
+    TArray<FIntRect> Result = MoveTemp(DirtyRegions);
+    DirtyRegions.Reset();
+    return Result;
+}
+
+FIntRect FVNSceneCompositor::GetLayerBounds(const FVNCompositorLayer& Layer) const
+{
+    if (!Layer.Image.IsValid() || Layer.Opacity <= 0.0f)
+    {
+        return FIntRect();
+    }
+    // Position places the authored canvas; a trimmed image sits at its offset inside it
+    const FIntPoint Origin = Layer.Position + Layer.Image->CanvasOffset;
+    FIntRect Bounds(Origin, Origin + FIntPoint(Layer.Image->Width, Layer.Image->Height));
+    Bounds.Clip(FIntRect(FIntPoint::ZeroValue, CanvasSize));
+    return Bounds.IsEmpty() ? FIntRect() : Bounds;
+}
+
+TArray<const FVNCompositorLayer*> FVNSceneCompositor::GetSortedLayers() const
+{
+    TArray<TPair<int32, const FVNCompositorLayer*>> Sorted;
+    for (const TPair<int32, FVNCompositorLayer>& Pair : Layers)
+    {
+        Sorted.Emplace(Pair.Key, &Pair.Value);
+    }
+    Sorted.Sort([](const TPair<int32, const FVNCompositorLayer*>& A, const TPair<int32, const FVNCompositorLayer*>& B)
+    {
+        return A.Value->ZOrder != B.Value->ZOrder ? A.Value->ZOrder < B.Value->ZOrder : A.Key < B.Key;
+    });
+
+    TArray<const FVNCompositorLayer*> Result;
+    for (const TPair<int32, const FVNCompositorLayer*>& Pair : Sorted)
+    {
+        Result.Add(Pair.Value);
+    }
+    return Result;
+}
+
+void FVNSceneCompositor::Compose(TArray64<uint8>& OutPixels) const
+{
+    {
+        LLM_SCOPE_BYTAG(WebP_Decoded);
+        OutPixels.SetNumUninitialized((int64)CanvasSize.X * CanvasSize.Y * 4);
+    }
+    ComposeRegion(FIntRect(FIntPoint::ZeroValue, CanvasSize), OutPixels.GetData(), (int64)CanvasSize.X * 4);
+}
+
+void FVNSceneCompositor::ComposeRegion(const FIntRect& InRegion, uint8* Canvas, int64 CanvasStride) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNSceneCompositor_ComposeRegion, WebPChannel);
+
+    FIntRect Region = InRegion;
+    Region.Clip(FIntRect(FIntPoint::ZeroValue, CanvasSize));
+    if (Region.IsEmpty())
+    {
+        return;
+    }
+
+    for (int32 Y = Region.Min.Y; Y < Region.Max.Y; ++Y)
+    {
+        FMemory::Memzero(Canvas + Y * CanvasStride + Region.Min.X * 4, Region.Width() * 4);
+    }
+
+    const EWebPSimdBackend Backend = WebPSimd::GetBackend();
+    TArray<uint8> PremultipliedRow;
+
+    for (const FVNCompositorLayer* Layer : GetSortedLayers())
+    {
+        FIntRect Bounds = GetLayerBounds(*Layer);
+        Bounds.Clip(Region);
+        if (Bounds.IsEmpty())
+        {
+            continue;
+        }
+
+        const FVNDecodedImage& Image = *Layer->Image;
+        const uint8 Opacity = (uint8)FMath::Clamp(FMath::RoundToInt(Layer->Opacity * 255.0f), 0, 255);
+        const int32 RowPixels = Bounds.Width();
+        const int64 ImageStride = (int64)Image.Width * 4;
+        const FIntPoint Origin = Layer->Position + Image.CanvasOffset;
+        if (!Image.bPremultiplied)
+        {
+            PremultipliedRow.SetNumUninitialized(RowPixels * 4, EAllowShrinking::No);
+        }
+
+        for (int32 Y = Bounds.Min.Y; Y < Bounds.Max.Y; ++Y)
+        {
+            const uint8* Src = Image.Pixels.GetData() + (Y - Origin.Y) * ImageStride + (Bounds.Min.X - Origin.X) * 4;
+            uint8* Dst = Canvas + Y * CanvasStride + Bounds.Min.X * 4;
+            if (!Image.bPremultiplied)
+            {
+                VNBlend::PremultiplyRow(PremultipliedRow.GetData(), Src, RowPixels);
+                Src = PremultipliedRow.GetData();
+            }
+            VNBlend::BlendPremultipliedRow(Backend, Dst, Src, RowPixels, Opacity);
+        }
+    }
+}
+
+UTexture2D* FVNSceneCompositor::CreateTexture(const TArray64<uint8>& Pixels, FIntPoint Size)
+{
+    if (Size.X <= 0 || Size.Y <= 0 || Pixels.Num() < (int64)Size.X * Size.Y * 4)
+    {
+        return nullptr;
+    }
+
+    LLM_SCOPE_BYTAG(WebP_TextureStaging);
+    UTexture2D* Texture = UTexture2D::CreateTransient(Size.X, Size.Y, PF_B8G8R8A8);
+    if (!Texture)
+    {
+        return nullptr;
+    }
+
+    {
+        WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_TextureCopy);
+        void* TextureData = Texture->GetPlatformData()->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
+        FMemory::Memcpy(TextureData, Pixels.GetData(), (int64)Size.X * Size.Y * 4);
+        Texture->GetPlatformData()->Mips[0].BulkData.Unlock();
+    }
+    {
+        WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_TextureUpload);
+        Texture->UpdateResource();
+    }
+    return Texture;
+}
+
+FVNCompositedTexture::FVNCompositedTexture(FVNSceneCompositor& InCompositor)
+    : Compositor(InCompositor)
+{
+}
+
+FVNCompositedTexture::~FVNCompositedTexture()
+{
+    if (Governor)
+    {
+        Governor->Untrack(CanvasAllocation);
+        Governor->Untrack(TextureAllocation);
+    }
+}
+
+UTexture2D* FVNCompositedTexture::GetTexture() const
+{
+    return Texture.Get();
+}
+
+int64 FVNCompositedTexture::Update()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNCompositedTexture_Update, WebPChannel);
+
+    const FIntPoint Size = Compositor.GetCanvasSize();
+    const int64 Stride = (int64)Size.X * 4;
+    Stats.FullFrameBytes = Stride * Size.Y;
+
+    // First use or resize: full compose and full upload, there is nothing to be incremental against
+    if (!Texture.IsValid() || TextureSize != Size)
+    {
+        if (Governor)
+        {
+            // Both are replaced at the new size; the scene's own images are on screen, so off-screen ones make room
+            Governor->Untrack(CanvasAllocation);
+            Governor->Untrack(TextureAllocation);
+            Governor->Reserve(Stats.FullFrameBytes * 2);
+        }
+        Compositor.TakeDirtyRegions();
+        Compositor.Compose(Canvas);
+        Texture.Reset(FVNSceneCompositor::CreateTexture(Canvas, Size));
+        TextureSize = Size;
+        if (Governor)
+        {
+            // No eviction delegates: the canvas and texture are the frame itself
+            CanvasAllocation = Governor->Track(this, NAME_None, EVNMemoryCategory::Decoded, Canvas.Num());
+            TextureAllocation = Governor->Track(this, NAME_None, EVNMemoryCategory::Texture, FVNMemoryGovernor::GetTextureBytes(Texture.Get()));
+        }
+
+        Stats.LastUploadedBytes = Texture.IsValid() ? Stats.FullFrameBytes : 0;
+        Stats.LastRegionCount = 1;
+    }
+    else
+    {
+        const TArray<FIntRect> Regions = Compositor.TakeDirtyRegions();
+        if (Regions.Num() == 0)
+        {
+            Stats.LastUploadedBytes = 0;
+            Stats.LastRegionCount = 0;
+            return 0;
+        }
+
+        // Regions are disjoint after MarkDirty's merging, so they can be recomposed and staged independently.
+        // Staging packs them one below the other so the render thread never reads Canvas, which the game
+        // thread may recompose before the upload runs.
+        int32 StagingWidth = 0;
+        int32 StagingHeight = 0;
+        for (const FIntRect& Region : Regions)
+        {
+            Compositor.ComposeRegion(Region, Canvas.GetData(), Stride);
+            StagingWidth = FMath::Max(StagingWidth, Region.Width());
+            StagingHeight += Region.Height();
+        }
+
+        const uint32 StagingPitch = StagingWidth * 4;
+        uint8* Staging = (uint8*)FMemory::Malloc((SIZE_T)StagingPitch * StagingHeight);
+        FUpdateTextureRegion2D* UploadRegions = new FUpdateTextureRegion2D[Regions.Num()];
+
+        int64 UploadedBytes = 0;
+        int32 StagingY = 0;
+        for (int32 Index = 0; Index < Regions.Num(); ++Index)
+        {
+            const FIntRect& Region = Regions[Index];
+            for (int32 Row = 0; Row < Region.Height(); ++Row)
+            {
+                FMemory::Memcpy(Staging + (SIZE_T)(StagingY + Row) * StagingPitch,
+                    Canvas.GetData() + (Region.Min.Y + Row) * Stride + Region.Min.X * 4, Region.Width() * 4);
+            }
+            UploadRegions[Index] = FUpdateTextureRegion2D(Region.Min.X, Region.Min.Y, 0, StagingY, Region.Width(), Region.Height());
+            StagingY += Region.Height();
+            UploadedBytes += (int64)Region.Area() * 4;
+        }
+
+        {
+            WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_TextureUpload);
+            Texture->UpdateTextureRegions(0, Regions.Num(), UploadRegions, StagingPitch, 4, Staging,
+                [](uint8* SrcData, const FUpdateTextureRegion2D* InRegions)
+                {
+                    FMemory::Free(SrcData);
+                    delete[] InRegions;
+                });
+        }
+
+        Stats.LastUploadedBytes = UploadedBytes;
+        Stats.LastRegionCount = Regions.Num();
+    }
+
+    Stats.TotalUploadedBytes += Stats.LastUploadedBytes;
+    ++Stats.NumUpdates;
+    INC_DWORD_STAT_BY(STAT_WebP_UploadedBytes, Stats.LastUploadedBytes);
+    return Stats.LastUploadedBytes;
+}
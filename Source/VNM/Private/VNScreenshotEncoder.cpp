@@ -0,0 +1,206 @@
+#include "VNScreenshotEncoder.h"
+#include "VNImageLoader.h"
+#include "WebPStats.h"
+#include "Engine/GameViewportClient.h"
+#include "UnrealClient.h"
+#include "WebPImageSupport/Private/WebpImageWrapper.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVNScreenshotEncoder, Log, All);
+
+FVNScreenshotEncoder::~FVNScreenshotEncoder()
+{
+    CancelAll();
+}
+
+FIntPoint FVNScreenshotEncoder::GetThumbnailSize(FIntPoint CaptureSize, int32 MaxDimension)
+{
+    return FVNImageLoader::GetScaledSize(CaptureSize, MaxDimension);
+}
+
+uint32 FVNScreenshotEncoder::Encode(TArray<FColor>&& Pixels, FIntPoint Size, FOnEncoded OnEncoded)
+{
+    check(IsInGameThread());
+    return Launch(NextJobId++, MoveTemp(Pixels), Size, MoveTemp(OnEncoded));
+}
+
+uint32 FVNScreenshotEncoder::Launch(uint32 JobId, TArray<FColor>&& Pixels, FIntPoint Size, FOnEncoded OnEncoded)
+{
+    if (Size.X <= 0 || Size.Y <= 0 || Pixels.Num() < Size.X * Size.Y)
+    {
+        return 0;
+    }
+
+    FJob& Job = Jobs.AddDefaulted_GetRef();
+    Job.Id = JobId;
+    Job.OnEncoded = MoveTemp(OnEncoded);
+
+    FWebPEncodeOptions Options;
+    Options.Method = FMath::Clamp(Settings.Method, 0, 6);
+    Options.bIgnoreAlpha = true; // Scene colour readbacks carry no meaningful alpha
+    const FIntPoint Thumbnail = GetThumbnailSize(Size, Settings.MaxDimension);
+    if (Thumbnail != Size)
+    {
+        Options.ScaledWidth = Thumbnail.X;
+        Options.ScaledHeight = Thumbnail.Y;
+    }
+    const int32 Quality = Settings.Quality;
+
+    TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bCancelled = Job.bCancelled;
+    Job.Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Pixels = MoveTemp(Pixels), Size, Options, Quality, bCancelled]() mutable -> FResult
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNScreenshotEncoder_Encode, WebPChannel);
+        FResult Result;
+        if (bCancelled->load(std::memory_order_relaxed))
+        {
+            return Result;
+        }
+
+        const double StartSeconds = FPlatformTime::Seconds();
+        FWebPEncodeOptions JobOptions = Options;
+        JobOptions.CancelFlag = &bCancelled.Get();
+
+        // Imported straight from the capture: no staging copy before libwebp's own rescale
+        FWebpImageWrapper Wrapper;
+        Wrapper.SetEncodeOptions(JobOptions);
+        if (Wrapper.SetRawView(Pixels.GetData(), (int64)Pixels.Num() * sizeof(FColor), Size.X, Size.Y, ERGBFormat::BGRA, 8))
+        {
+            Result.Compressed = Wrapper.GetCompressed(Quality);
+        }
+        Result.EncodeSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+        Pixels.Empty(); // The full-size capture is the big allocation; don't keep it until Tick
+        return Result;
+    }, UE::Tasks::ETaskPriority::BackgroundNormal);
+
+    ++Stats.Started;
+    return JobId;
+}
+
+uint32 FVNScreenshotEncoder::CaptureViewport(bool bShowUI, FOnEncoded OnEncoded)
+{
+    check(IsInGameThread());
+    if (!GEngine || !GEngine->GameViewport)
+    {
+        return 0;
+    }
+
+    // One capture at a time: the engine's screenshot request is global
+    ClearPendingCapture();
+
+    FPendingCapture& Capture = PendingCapture.Emplace();
+    Capture.Id = NextJobId++;
+    Capture.OnEncoded = MoveTemp(OnEncoded);
+    // While bound, the viewport hands the pixels to us instead of writing a screenshot file
+    Capture.CapturedHandle = UGameViewportClient::OnScreenshotCaptured().AddRaw(this, &FVNScreenshotEncoder::OnScreenshotCaptured);
+    FScreenshotRequest::RequestScreenshot(bShowUI);
+    return Capture.Id;
+}
+
+void FVNScreenshotEncoder::OnScreenshotCaptured(int32 InWidth, int32 InHeight, const TArray<FColor>& InColors)
+{
+    if (!PendingCapture.IsSet())
+    {
+        return;
+    }
+
+    const uint32 JobId = PendingCapture->Id;
+    FOnEncoded OnEncoded = MoveTemp(PendingCapture->OnEncoded);
+    ClearPendingCapture();
+
+    // The engine's array only lives for this broadcast; this copy is the one the worker owns
+    TArray<FColor> Pixels = InColors;
+    if (Launch(JobId, MoveTemp(Pixels), FIntPoint(InWidth, InHeight), OnEncoded) == 0)
+    {
+        ++Stats.Failed;
+        TArray64<uint8> Empty;
+        OnEncoded.ExecuteIfBound(Empty);
+    }
+}
+
+void FVNScreenshotEncoder::ClearPendingCapture()
+{
+    if (PendingCapture.IsSet())
+    {
+        UGameViewportClient::OnScreenshotCaptured().Remove(PendingCapture->CapturedHandle);
+        PendingCapture.Reset();
+    }
+}
+
+void FVNScreenshotEncoder::Tick()
+{
+    check(IsInGameThread());
+
+    for (int32 Index = 0; Index < Jobs.Num();)
+    {
+        FJob& Job = Jobs[Index];
+        if (!Job.Task.IsCompleted())
+        {
+            ++Index;
+            continue;
+        }
+
+        // Removed before the callback, which may well start another job
+        FJob Finished = MoveTemp(Job);
+        Jobs.RemoveAt(Index);
+
+        if (Finished.bCancelled->load(std::memory_order_relaxed))
+        {
+            continue;
+        }
+
+        FResult& Result = Finished.Task.GetResult();
+        if (Result.Compressed.Num() > 0)
+        {
+            ++Stats.Completed;
+            Stats.TotalEncodeSeconds += Result.EncodeSeconds;
+            UE_LOG(LogVNScreenshotEncoder, Verbose, TEXT("Thumbnail %u: %lld bytes in %.2f ms"), Finished.Id, Result.Compressed.Num(), Result.EncodeSeconds * 1000.0);
+        }
+        else
+        {
+            ++Stats.Failed;
+            UE_LOG(LogVNScreenshotEncoder, Warning, TEXT("Thumbnail %u failed to encode"), Finished.Id);
+        }
+        Finished.OnEncoded.ExecuteIfBound(Result.Compressed);
+    }
+}
+
+void FVNScreenshotEncoder::Cancel(uint32 JobId)
+{
+    if (PendingCapture.IsSet() && PendingCapture->Id == JobId)
+    {
+        ClearPendingCapture();
+        ++Stats.Cancelled;
+        return;
+    }
+    for (FJob& Job : Jobs)
+    {
+        if (Job.Id == JobId && !Job.bCancelled->load(std::memory_order_relaxed))
+        {
+            // The encode stops at libwebp's next progress callback; Tick drops the job once the task returns
+            Job.bCancelled->store(true, std::memory_order_relaxed);
+            ++Stats.Cancelled;
+        }
+    }
+}
+
+void FVNScreenshotEncoder::CancelAll()
+{
+    if (PendingCapture.IsSet())
+    {
+        ClearPendingCapture();
+        ++Stats.Cancelled;
+    }
+    for (FJob& Job : Jobs)
+    {
+        if (!Job.bCancelled->load(std::memory_order_relaxed))
+        {
+            Job.bCancelled->store(true, std::memory_order_relaxed);
+            ++Stats.Cancelled;
+        }
+    }
+    for (FJob& Job : Jobs)
+    {
+        Job.Task.Wait();
+    }
+    Jobs.Empty();
+}
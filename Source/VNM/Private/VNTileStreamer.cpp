@@ -0,0 +1,292 @@
+#include "VNTileStreamer.h"
+#include "VNSceneCompositor.h"
+#include "VNMemoryGovernor.h"
+#include "WebPBufferPool.h"
+#include "WebPStats.h"
+#include "WebPMemory.h"
+#include "Engine/Texture2D.h"
+#include "WebPImageSupport/Private/WebpImageWrapper.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVNTileStreamer, Log, All);
+
+FVNTileStreamer::~FVNTileStreamer()
+{
+    Close();
+}
+
+bool FVNTileStreamer::OpenFile(const FString& Filename)
+{
+    Close();
+    return Source.LoadFile(Filename);
+}
+
+bool FVNTileStreamer::OpenView(TConstArrayView64<uint8> Data)
+{
+    Close();
+    return Source.InitializeView(Data);
+}
+
+void FVNTileStreamer::Close()
+{
+    // Decodes read from Source, so they must finish before it changes
+    for (TPair<FIntPoint, FPending>& Pair : Pending)
+    {
+        Pair.Value.bCancelled->store(true, std::memory_order_relaxed);
+    }
+    for (TPair<FIntPoint, FPending>& Pair : Pending)
+    {
+        Pair.Value.Task.Wait();
+    }
+    Pending.Empty();
+    Queue.Empty();
+    for (const TPair<FIntPoint, FTile>& Pair : Resident)
+    {
+        UntrackTile(Pair.Value);
+    }
+    Resident.Empty();
+    Stats.ResidentTiles = 0;
+    Stats.ResidentBytes = 0;
+    VisibleRange = FIntRect();
+    RequestRange = FIntRect();
+    Source.Reset();
+}
+
+void FVNTileStreamer::ResetStats()
+{
+    const int32 ResidentTiles = Stats.ResidentTiles;
+    const int64 ResidentBytes = Stats.ResidentBytes;
+    Stats = FStats();
+    Stats.ResidentTiles = ResidentTiles;
+    Stats.ResidentBytes = ResidentBytes;
+    Stats.PeakResidentBytes = ResidentBytes;
+}
+
+FIntRect FVNTileStreamer::GetTileRange(const FIntRect& PixelRect, int32 Rings) const
+{
+    const int32 TileSize = Source.GetTileSize();
+    FIntRect Range(
+        FIntPoint(FMath::FloorToInt((float)PixelRect.Min.X / TileSize), FMath::FloorToInt((float)PixelRect.Min.Y / TileSize)),
+        FIntPoint(FMath::DivideAndRoundUp(PixelRect.Max.X, TileSize), FMath::DivideAndRoundUp(PixelRect.Max.Y, TileSize)));
+    Range.InflateRect(Rings);
+    Range.Clip(FIntRect(0, 0, Source.GetNumTilesX(), Source.GetNumTilesY()));
+    return Range;
+}
+
+void FVNTileStreamer::Update(const FIntRect& Viewport)
+{
+    check(IsInGameThread());
+    if (!Source.IsValid())
+    {
+        return;
+    }
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNTileStreamer_Update, WebPChannel);
+
+    CollectFinished();
+
+    VisibleRange = GetTileRange(Viewport, 0);
+    RequestRange = GetTileRange(Viewport, FMath::Max(0, Settings.MarginTiles));
+    Evict(GetTileRange(Viewport, FMath::Max(0, Settings.MarginTiles) + FMath::Max(0, Settings.EvictSlackTiles)));
+
+    ++Stats.Updates;
+    for (int32 Y = VisibleRange.Min.Y; Y < VisibleRange.Max.Y; ++Y)
+    {
+        for (int32 X = VisibleRange.Min.X; X < VisibleRange.Max.X; ++X)
+        {
+            ++Stats.VisibleTiles;
+            Stats.VisibleMisses += Resident.Contains(FIntPoint(X, Y)) ? 0 : 1;
+        }
+    }
+
+    // Rebuild the queue: visible tiles first, then the margin ring, each by distance from the viewport centre
+    Queue.Reset();
+    for (int32 Y = RequestRange.Min.Y; Y < RequestRange.Max.Y; ++Y)
+    {
+        for (int32 X = RequestRange.Min.X; X < RequestRange.Max.X; ++X)
+        {
+            const FIntPoint Coord(X, Y);
+            if (!Resident.Contains(Coord) && !Pending.Contains(Coord))
+            {
+                Queue.Add(Coord);
+            }
+        }
+    }
+    const FVector2D Centre = FVector2D(VisibleRange.Min + VisibleRange.Max) * 0.5 - FVector2D(0.5, 0.5);
+    const FIntRect Visible = VisibleRange;
+    Queue.Sort([&Centre, &Visible](const FIntPoint& A, const FIntPoint& B)
+    {
+        const bool bVisibleA = Visible.Contains(A);
+        const bool bVisibleB = Visible.Contains(B);
+        if (bVisibleA != bVisibleB)
+        {
+            return bVisibleA;
+        }
+        return FVector2D::DistSquared(FVector2D(A), Centre) < FVector2D::DistSquared(FVector2D(B), Centre);
+    });
+
+    Launch();
+}
+
+void FVNTileStreamer::Flush()
+{
+    check(IsInGameThread());
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNTileStreamer_Flush, WebPChannel);
+
+    while (Pending.Num() > 0)
+    {
+        for (TPair<FIntPoint, FPending>& Pair : Pending)
+        {
+            Pair.Value.Task.Wait();
+        }
+        CollectFinished();
+        Launch();
+    }
+}
+
+void FVNTileStreamer::GetVisibleTiles(TArray<const FTile*>& OutTiles) const
+{
+    OutTiles.Reset();
+    for (int32 Y = VisibleRange.Min.Y; Y < VisibleRange.Max.Y; ++Y)
+    {
+        for (int32 X = VisibleRange.Min.X; X < VisibleRange.Max.X; ++X)
+        {
+            if (const FTile* Tile = Resident.Find(FIntPoint(X, Y)))
+            {
+                OutTiles.Add(Tile);
+            }
+        }
+    }
+}
+
+void FVNTileStreamer::CollectFinished()
+{
+    for (auto It = Pending.CreateIterator(); It; ++It)
+    {
+        FPending& Entry = It.Value();
+        if (!Entry.Task.IsCompleted())
+        {
+            continue;
+        }
+
+        const FDecodeResult& Result = Entry.Task.GetResult();
+        Stats.DecodeSeconds += Result.Seconds;
+        if (Entry.bCancelled->load(std::memory_order_relaxed))
+        {
+            ++Stats.TilesCancelled;
+        }
+        else if (Result.Image.IsValid())
+        {
+            ++Stats.TilesDecoded;
+            AddResident(It.Key(), Result.Image);
+        }
+        else
+        {
+            UE_LOG(LogVNTileStreamer, Warning, TEXT("Failed to decode tile %d,%d"), It.Key().X, It.Key().Y);
+        }
+        It.RemoveCurrent();
+    }
+}
+
+void FVNTileStreamer::AddResident(FIntPoint Coord, FVNDecodedImagePtr Image)
+{
+    FTile& Tile = Resident.Add(Coord);
+    Tile.Coord = Coord;
+    Tile.Rect = Source.GetTileRect(Coord.X, Coord.Y);
+    Tile.Image = MoveTemp(Image);
+    if (Settings.bCreateTextures)
+    {
+        LLM_SCOPE_BYTAG(WebP_TextureStaging);
+        Tile.Texture.Reset(FVNSceneCompositor::CreateTexture(Tile.Image->Pixels, Tile.Rect.Size()));
+    }
+    if (Governor)
+    {
+        // No eviction delegates: the viewport decides which tiles stay, Update() evicts the rest
+        Tile.ImageAllocation = Governor->Track(this, NAME_None, EVNMemoryCategory::Decoded, Tile.Image->GetSizeBytes());
+        if (Tile.Texture.IsValid())
+        {
+            Tile.TextureAllocation = Governor->Track(this, NAME_None, EVNMemoryCategory::Texture, FVNMemoryGovernor::GetTextureBytes(Tile.Texture.Get()));
+        }
+    }
+
+    ++Stats.ResidentTiles;
+    Stats.ResidentBytes += Tile.Image->GetSizeBytes();
+    Stats.PeakResidentBytes = FMath::Max(Stats.PeakResidentBytes, Stats.ResidentBytes);
+}
+
+void FVNTileStreamer::UntrackTile(const FTile& Tile)
+{
+    if (Governor)
+    {
+        Governor->Untrack(Tile.ImageAllocation);
+        Governor->Untrack(Tile.TextureAllocation);
+    }
+}
+
+void FVNTileStreamer::Evict(const FIntRect& KeepRange)
+{
+    for (auto It = Resident.CreateIterator(); It; ++It)
+    {
+        if (!KeepRange.Contains(It.Key()))
+        {
+            Stats.ResidentBytes -= It.Value().Image->GetSizeBytes();
+            --Stats.ResidentTiles;
+            ++Stats.TilesEvicted;
+            UntrackTile(It.Value());
+            It.RemoveCurrent();
+        }
+    }
+
+    // Not started yet: the task sees the flag and returns nothing; already decoding: the result is dropped on collect
+    for (TPair<FIntPoint, FPending>& Pair : Pending)
+    {
+        if (!KeepRange.Contains(Pair.Key))
+        {
+            Pair.Value.bCancelled->store(true, std::memory_order_relaxed);
+        }
+    }
+}
+
+void FVNTileStreamer::Launch()
+{
+    int32 NumLaunched = 0;
+    while (NumLaunched < Queue.Num() && Pending.Num() < FMath::Max(1, Settings.MaxInFlight))
+    {
+        const FIntPoint Coord = Queue[NumLaunched++];
+
+        FPending& Entry = Pending.Add(Coord);
+        const FWebPTiledImage* SourcePtr = &Source;
+        const bool bPremultiply = Settings.bPremultiplyAlpha;
+        TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bCancelled = Entry.bCancelled;
+        Entry.Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [SourcePtr, Coord, bPremultiply, bCancelled]() -> FDecodeResult
+        {
+            FDecodeResult Result;
+            if (bCancelled->load(std::memory_order_relaxed))
+            {
+                return Result;
+            }
+            TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FVNTileStreamer_DecodeTile, WebPChannel);
+            FWebPInFlightScope InFlight;
+            const double StartSeconds = FPlatformTime::Seconds();
+
+            const FIntRect Rect = SourcePtr->GetTileRect(Coord.X, Coord.Y);
+            TSharedRef<FVNDecodedImage, ESPMode::ThreadSafe> Image = MakeShared<FVNDecodedImage, ESPMode::ThreadSafe>();
+            Image->Width = Rect.Width();
+            Image->Height = Rect.Height();
+            Image->bPremultiplied = bPremultiply;
+            {
+                LLM_SCOPE_BYTAG(WebP_Decoded);
+                Image->Pixels = FWebPBufferPool::Get().Acquire((int64)Image->Width * Image->Height * 4);
+            }
+
+            FWebPDecodeOptions Options;
+            Options.bPremultiplyAlpha = bPremultiply;
+            if (SourcePtr->DecodeTile(Coord.X, Coord.Y, ERGBFormat::BGRA, Options, Image->Pixels.GetData(), (int64)Image->Width * 4, Image->Pixels.Num())
+                && !bCancelled->load(std::memory_order_relaxed))
+            {
+                Result.Image = Image;
+            }
+            Result.Seconds = FPlatformTime::Seconds() - StartSeconds;
+            return Result;
+        });
+    }
+    Queue.RemoveAt(0, NumLaunched);
+}
@@ -0,0 +1,94 @@
+// Pan replay over an oversized panorama with FVNTileStreamer: a viewport sweeps across and back, each frame
+// runs Update() and then waits for the requested tiles. Reports misses (visible tiles not resident when the
+// frame started), tile decode time per frame and resident memory against the size of the whole image.
+// -run=WebPBenchmark -Suite=TileStreaming, or the WebP.Perf.Benchmark.* tests.
+#include "WebPBenchmark.h"
+#include "WebPSyntheticImage.h"
+#include "WebPTiledImage.h"
+#include "VNTileStreamer.h"
+#include "WebPImageSupport/Private/WebpImageWrapper.h"
+
+#if WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
+
+namespace VNTileStreamerBenchmarks
+{
+    // Viewport origin at Frame: left to right and back, with a slow vertical drift
+    static FIntPoint GetPanPosition(int32 Frame, int32 NumFrames, FIntPoint ImageSize, FIntPoint Viewport)
+    {
+        const double T = (double)Frame / FMath::Max(1, NumFrames - 1);
+        const double Sweep = T < 0.5 ? T * 2.0 : (1.0 - T) * 2.0;
+        const double Drift = 0.5 - 0.5 * FMath::Cos(T * 2.0 * UE_DOUBLE_PI);
+        return FIntPoint(
+            (int32)(Sweep * (ImageSize.X - Viewport.X)),
+            (int32)(Drift * (ImageSize.Y - Viewport.Y)));
+    }
+
+    static void Run(FWebPBenchmarkContext& Context)
+    {
+        const FIntPoint ImageSize = Context.bQuick ? FIntPoint(4096, 1536) : FIntPoint(8192, 3072);
+        const FIntPoint Viewport = Context.bQuick ? FIntPoint(1280, 720) : FIntPoint(1920, 1080);
+        const int32 NumFrames = Context.bQuick ? 120 : 360;
+        const int64 FullImageBytes = (int64)ImageSize.X * ImageSize.Y * 4;
+
+        TArray64<uint8> Pixels;
+        FWebPSyntheticImage::Generate(ImageSize.X, ImageSize.Y, EWebPSyntheticContent::Photo, 1234, Pixels);
+        TArray64<uint8> File;
+        if (!FWebPTiledImageBuilder::Encode(Pixels.GetData(), ImageSize.X, ImageSize.Y, (int64)ImageSize.X * 4,
+                                            FWebPTiledImageBuilder::DefaultTileSize, FWebPEncodeOptions(), 85, File))
+        {
+            return;
+        }
+        Pixels.Empty();
+
+        const int32 Margins[] = { 0, 1, 2 };
+        for (int32 Margin : Margins)
+        {
+            FVNTileStreamer::FSettings Settings;
+            Settings.MarginTiles = Margin;
+            Settings.bCreateTextures = false;
+
+            FWebPBenchmarkResult& Result = Context.AddResult(TEXT("TileStreaming"),
+                FString::Printf(TEXT("pan %dx%d in %dx%d margin=%d"), Viewport.X, Viewport.Y, ImageSize.X, ImageSize.Y, Margin));
+            Result.Params.Add(TEXT("image_width"), LexToString(ImageSize.X));
+            Result.Params.Add(TEXT("image_height"), LexToString(ImageSize.Y));
+            Result.Params.Add(TEXT("viewport_width"), LexToString(Viewport.X));
+            Result.Params.Add(TEXT("viewport_height"), LexToString(Viewport.Y));
+            Result.Params.Add(TEXT("tile_size"), LexToString(FWebPTiledImageBuilder::DefaultTileSize));
+            Result.Params.Add(TEXT("margin_tiles"), LexToString(Margin));
+            Result.Params.Add(TEXT("frames"), LexToString(NumFrames));
+
+            FVNTileStreamer::FStats Stats;
+            double MaxFrameDecodeSeconds = 0.0;
+            Context.Measure(Result, [&]()
+            {
+                FVNTileStreamer Streamer;
+                Streamer.SetSettings(Settings);
+                Streamer.OpenView(TConstArrayView64<uint8>(File.GetData(), File.Num()));
+
+                MaxFrameDecodeSeconds = 0.0;
+                for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+                {
+                    const double DecodeBefore = Streamer.GetStats().DecodeSeconds;
+                    const FIntPoint Origin = GetPanPosition(Frame, NumFrames, ImageSize, Viewport);
+                    Streamer.Update(FIntRect(Origin, Origin + Viewport));
+                    Streamer.Flush();
+                    MaxFrameDecodeSeconds = FMath::Max(MaxFrameDecodeSeconds, Streamer.GetStats().DecodeSeconds - DecodeBefore);
+                }
+                Stats = Streamer.GetStats();
+            });
+
+            Result.Metrics.Add(TEXT("misses_per_frame"), (double)Stats.VisibleMisses / NumFrames);
+            // The first frame always misses everything; the steady state is what panning feels like
+            Result.Metrics.Add(TEXT("visible_miss_rate"), Stats.VisibleTiles > 0 ? (double)Stats.VisibleMisses / Stats.VisibleTiles : 0.0);
+            Result.Metrics.Add(TEXT("tiles_decoded_per_frame"), (double)Stats.TilesDecoded / NumFrames);
+            Result.Metrics.Add(TEXT("decode_ms_per_frame"), Stats.DecodeSeconds / NumFrames * 1000.0);
+            Result.Metrics.Add(TEXT("max_frame_decode_ms"), MaxFrameDecodeSeconds * 1000.0);
+            Result.Metrics.Add(TEXT("peak_resident_mb"), Stats.PeakResidentBytes / (1024.0 * 1024.0));
+            Result.Metrics.Add(TEXT("full_image_mb"), FullImageBytes / (1024.0 * 1024.0));
+        }
+    }
+
+    static FWebPBenchmarkSuiteRegistrar TileStreamingSuite(TEXT("TileStreaming"), &Run);
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS || !UE_BUILD_SHIPPING
@@ -13,6 +13,8 @@
 // Assuming WebPImageSupport is a plugin and its Public folder is in include paths:
 #include "Components/Image.h"
 #include "WebPImageSupport/Private/WebpImageWrapper.h" // Adjust if necessary
+#include "WebPStats.h"
+#include "WebPMemory.h"
 
 // If WebPImageWrapper.h is in a Private folder of the same module as this test widget, it might be:
 // #include "../Private/WebPImageWrapper.h"
@@ -20,6 +22,7 @@
 
 void UWebPTestWidget::PerformWebPTest()
 {
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(UWebPTestWidget_PerformWebPTest, WebPChannel);
     UE_LOG(LogTemp, Log, TEXT("PerformWebPTest called!"));
 
     // --- 1. Instantiate your Wrapper ---
@@ -31,6 +34,7 @@ void UWebPTestWidget::PerformWebPTest()
         UE_LOG(LogTemp, Error, TEXT("Failed to create FWebpImageWrapper instance."));
         return;
     }
+    WebPWrapper->SetDebugOwner(GetName());
 
     // --- 2. Load .webp file from disk ---
     TArray<uint8> CompressedFileData;
@@ -39,10 +43,14 @@ void UWebPTestWidget::PerformWebPTest()
     FString TestWebPPath = FPaths::ProjectContentDir() / TEXT("TestImages/test.webp");
     UE_LOG(LogTemp, Log, TEXT("Attempting to load WebP from: %s"), *TestWebPPath);
 
-    if (!FFileHelper::LoadFileToArray(CompressedFileData, *TestWebPPath))
     {
-        UE_LOG(LogTemp, Error, TEXT("Failed to load .webp file from disk: %s"), *TestWebPPath);
-        return;
+        WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_FileRead);
+        LLM_SCOPE_BYTAG(WebP_Compressed);
+        if (!FFileHelper::LoadFileToArray(CompressedFileData, *TestWebPPath))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to load .webp file from disk: %s"), *TestWebPPath);
+            return;
+        }
     }
     UE_LOG(LogTemp, Log, TEXT("Loaded %d bytes from .webp file."), CompressedFileData.Num());
 
@@ -54,23 +62,15 @@ void UWebPTestWidget::PerformWebPTest()
     }
     UE_LOG(LogTemp, Log, TEXT("SetCompressed Succeeded. Detected Width: %lld, Height: %lld"), WebPWrapper->GetWidth(), WebPWrapper->GetHeight());
 
-    // --- 4. Get Raw Pixel Data (as BGRA8, common for UTexture2D) ---
-    TArray64<uint8> RawPixelData;
-    if (!WebPWrapper->GetRaw(ERGBFormat::BGRA, 8, RawPixelData))
-    {
-        UE_LOG(LogTemp, Error, TEXT("WebPWrapper->GetRaw Failed."));
-        return;
-    }
-    UE_LOG(LogTemp, Log, TEXT("GetRaw Succeeded. Raw data size: %lld bytes."), RawPixelData.Num());
-
-    if (WebPWrapper->GetWidth() <= 0 || WebPWrapper->GetHeight() <= 0 || RawPixelData.Num() == 0)
+    if (WebPWrapper->GetWidth() <= 0 || WebPWrapper->GetHeight() <= 0)
     {
-        UE_LOG(LogTemp, Error, TEXT("Image dimensions or raw data are invalid after GetRaw."));
+        UE_LOG(LogTemp, Error, TEXT("Image dimensions are invalid after SetCompressed."));
         return;
     }
 
-    // --- 5. Create a UTexture2D from the Raw Data ---
+    // --- 4. Create a UTexture2D to decode into ---
     // Option A: Manual UTexture2D creation (more control, what we discussed)
+    LLM_SCOPE_BYTAG(WebP_TextureStaging);
     UTexture2D* NewTexture = UTexture2D::CreateTransient(WebPWrapper->GetWidth(), WebPWrapper->GetHeight(), PF_B8G8R8A8); // PF_B8G8R8A8 for BGRA
     if (!NewTexture)
     {
@@ -78,19 +78,36 @@ void UWebPTestWidget::PerformWebPTest()
         return;
     }
 
-    // Lock the texture for writing
-    void* TextureData = NewTexture->GetPlatformData()->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
-    if (!TextureData)
+    // --- 5. Decode (as BGRA8, common for UTexture2D) straight into the mip ---
+    // No intermediate raw buffer: libwebp writes rows directly into the locked mip memory at its stride.
     {
-        UE_LOG(LogTemp, Error, TEXT("Failed to lock texture data."));
-        // NewTexture->MarkAsGarbage(); // Clean up if lock fails
-        return;
+        FByteBulkData& BulkData = NewTexture->GetPlatformData()->Mips[0].BulkData;
+        const int64 MipSize = BulkData.GetBulkDataSize();
+        const int64 MipStride = MipSize / WebPWrapper->GetHeight();
+
+        // Lock the texture for writing
+        void* TextureData = BulkData.Lock(LOCK_READ_WRITE);
+        if (!TextureData)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to lock texture data."));
+            // NewTexture->MarkAsGarbage(); // Clean up if lock fails
+            return;
+        }
+
+        const bool bDecoded = WebPWrapper->DecodeInto(ERGBFormat::BGRA, 8, TextureData, MipStride, MipSize);
+        BulkData.Unlock();
+
+        if (!bDecoded)
+        {
+            UE_LOG(LogTemp, Error, TEXT("WebPWrapper->DecodeInto Failed."));
+            return;
+        }
+        UE_LOG(LogTemp, Log, TEXT("DecodeInto Succeeded. Mip size: %lld bytes, stride %lld."), MipSize, MipStride);
+    }
+    {
+        WEBP_SCOPE_CYCLE_COUNTER(STAT_WebP_TextureUpload);
+        NewTexture->UpdateResource(); // IMPORTANT: This uploads the data to the GPU
     }
-
-    FMemory::Memcpy(TextureData, RawPixelData.GetData(), RawPixelData.Num());
-
-    NewTexture->GetPlatformData()->Mips[0].BulkData.Unlock();
-    NewTexture->UpdateResource(); // IMPORTANT: This uploads the data to the GPU
 
     UE_LOG(LogTemp, Log, TEXT("Successfully created and updated UTexture2D from WebP raw data!"));
 
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/StrongObjectPtr.h"
+#include "VNImageTypes.h"
+#include "WebPAnimation.h"
+
+class FVNImageLoader;
+class UTexture2D;
+class FVNMemoryGovernor;
+
+/**
+ * One decode stream of an animated WebP, shared by every instance that shows the same source on the same time base
+ * (rain, sparkles, a looping effect placed in several widgets). Instances hold a TSharedPtr to it; the stream lives
+ * as long as any instance does.
+ *
+ * The current frame is picked from the absolute time, so all instances always agree on it. Fully composed frames
+ * are kept in a small ring; once a whole loop fits, later loops are served from the ring without decoding.
+ */
+class VNM_API FVNSharedAnimation
+{
+public:
+    FVNSharedAnimation() = default;
+    ~FVNSharedAnimation();
+
+    FVNSharedAnimation(const FVNSharedAnimation&) = delete;
+    FVNSharedAnimation& operator=(const FVNSharedAnimation&) = delete;
+
+    FName GetId() const { return Id; }
+    double GetTimeBaseSeconds() const { return TimeBaseSeconds; }
+    FIntPoint GetCanvasSize() const { return Animation.GetCanvasSize(); }
+    int32 GetFrameIndex() const { return ShownFrame; }
+
+    // Shared texture with the current frame (null when the cache doesn't create textures)
+    UTexture2D* GetTexture() const { return Texture.Get(); }
+
+    // Current frame's pixels (BGRA8, straight alpha) if they are in the ring, for CPU consumers such as the compositor
+    FVNDecodedImagePtr GetFramePixels() const { return Ring.IsValidIndex(ShownFrame) ? Ring[ShownFrame] : nullptr; }
+
+private:
+    friend class FVNAnimationCache;
+
+    FName Id;
+    double TimeBaseSeconds = 0.0;
+    TArray64<uint8> LooseBytes;
+    FWebPAnimation Animation;
+    TUniquePtr<FWebPAnimationCanvas> Canvas;
+    TStrongObjectPtr<UTexture2D> Texture;
+    FVNMemoryGovernor* Governor = nullptr;
+    uint64 TextureAllocation = 0;
+
+    TArray<FVNDecodedImagePtr> Ring;    // Composed frames by frame index, at most RingCapacity set
+    TArray<int32> RingOrder;            // Oldest first, for eviction
+    int32 RingCapacity = 0;
+
+    int32 ShownFrame = INDEX_NONE;
+    double LastAdvanceSeconds = -1.0;
+};
+
+/**
+ * Hands out FVNSharedAnimation streams keyed by (image id, time base) and advances every live stream once per Tick,
+ * however many instances show it. N instances of the same effect cost one decode and one texture upload per frame.
+ * Game thread only.
+ */
+class VNM_API FVNAnimationCache
+{
+public:
+    struct FSettings
+    {
+        int64 MaxRingBytesPerStream = 16 * 1024 * 1024; // Composed frames kept per stream
+        bool bCreateTextures = true;                    // Off for headless use (benchmarks)
+    };
+
+    struct FStats
+    {
+        int32 StreamsCreated = 0;
+        int32 Acquires = 0;
+        int32 SharedAcquires = 0;       // Acquires that joined an existing stream
+        int32 FramesDecoded = 0;
+        int32 RingHits = 0;             // Frames shown from the ring instead of decoding
+        int64 UploadedBytes = 0;
+    };
+
+    explicit FVNAnimationCache(const FVNImageLoader& InLoader);
+    ~FVNAnimationCache();
+
+    FVNAnimationCache(const FVNAnimationCache&) = delete;
+    FVNAnimationCache& operator=(const FVNAnimationCache&) = delete;
+
+    void SetSettings(const FSettings& InSettings) { Settings = InSettings; }
+    // Counts stream textures against Governor's budget. Set before the first Acquire(); must outlive the streams.
+    void SetGovernor(FVNMemoryGovernor* InGovernor) { Governor = InGovernor; }
+
+    // Instances that should play in lockstep pass the same TimeBaseSeconds (e.g. the scene's start time).
+    // Null if the image can't be loaded. Dropping the returned pointer releases the instance.
+    TSharedPtr<FVNSharedAnimation> Acquire(FName Id, double TimeBaseSeconds);
+
+    // Once per frame: advances every stream that still has instances and forgets the others
+    void Tick(double NowSeconds);
+
+    int32 GetNumStreams() const { return Streams.Num(); }
+    const FStats& GetStats() const { return Stats; }
+
+private:
+    typedef TTuple<FName, double> FStreamKey;
+
+    int32 GetFrameAt(const FVNSharedAnimation& Stream, double NowSeconds) const;
+    void Advance(FVNSharedAnimation& Stream, double NowSeconds);
+    const uint8* ComposeFrame(FVNSharedAnimation& Stream, int32 FrameIndex);
+    void Upload(FVNSharedAnimation& Stream, const FIntRect& Rect, const uint8* FramePixels);
+
+    const FVNImageLoader& Loader;
+    FSettings Settings;
+    FStats Stats;
+    FVNMemoryGovernor* Governor = nullptr;
+    TMap<FStreamKey, TWeakPtr<FVNSharedAnimation>> Streams;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/StrongObjectPtr.h"
+#include "WebPAnimation.h"
+
+class FVNImageLoader;
+class UTexture2D;
+
+/**
+ * Plays an animated WebP (blinks, lip-sync loops, effects) into a single texture.
+ *
+ * Frames are reconstructed on the CPU canvas by FWebPAnimationCanvas; Tick() then uploads only the rectangle
+ * that changed since the last upload (the union over every frame that came due this tick), not the whole canvas.
+ * Game thread only.
+ */
+class VNM_API FVNAnimationPlayer
+{
+public:
+    struct FStats
+    {
+        int32 FramesDecoded = 0;
+        int32 Uploads = 0;
+        int64 UploadedBytes = 0;
+        int64 FullCanvasBytes = 0;      // What re-uploading the whole canvas on every upload would have cost
+
+        double GetUploadRatio() const { return FullCanvasBytes > 0 ? (double)UploadedBytes / FullCanvasBytes : 0.0; }
+    };
+
+    explicit FVNAnimationPlayer(const FVNImageLoader& InLoader);
+    ~FVNAnimationPlayer();
+
+    FVNAnimationPlayer(const FVNAnimationPlayer&) = delete;
+    FVNAnimationPlayer& operator=(const FVNAnimationPlayer&) = delete;
+
+    // Loads the animation and shows frame 0. False if the image is missing or not a valid WebP.
+    bool Open(FName Id);
+    void Close();
+
+    // Advances playback; decodes every frame that came due and uploads their combined dirty rectangle
+    void Tick(float DeltaSeconds);
+
+    // Back to frame 0 and playing
+    void Restart();
+
+    UTexture2D* GetTexture() const { return Texture.Get(); }
+    FIntPoint GetCanvasSize() const { return Animation.GetCanvasSize(); }
+    int32 GetFrameIndex() const { return Canvas.IsValid() ? Canvas->GetFrameIndex() : INDEX_NONE; }
+    bool IsFinished() const { return bFinished; } // Ran out of loops; the last frame stays up
+    const FStats& GetStats() const { return Stats; }
+
+private:
+    bool ShowNextFrame(FIntRect& InOutDirtyRect);
+    void Upload(const FIntRect& Rect);
+
+    const FVNImageLoader& Loader;
+    FName Id;
+    TArray64<uint8> LooseBytes;         // Owns the file when it did not come from a bundle
+    FWebPAnimation Animation;
+    TUniquePtr<FWebPAnimationCanvas> Canvas;
+    TStrongObjectPtr<UTexture2D> Texture;
+
+    double TimeInFrameMs = 0.0;
+    int32 LoopsCompleted = 0;
+    bool bFinished = false;
+    FStats Stats;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WebPSimd.h"
+
+// Row kernels for compositing BGRA8 layers. Everything is premultiplied alpha:
+//   Dst = Src * Opacity + Dst * (1 - SrcAlpha * Opacity)
+// Rounding matches across backends (exact x / 255), so backends produce identical output.
+namespace VNBlend
+{
+    // Uses WebPSimd::GetBackend()
+    VNM_API void BlendPremultipliedRow(uint8* Dst, const uint8* Src, int32 NumPixels, uint8 Opacity);
+    VNM_API void BlendPremultipliedRow(EWebPSimdBackend Backend, uint8* Dst, const uint8* Src, int32 NumPixels, uint8 Opacity);
+
+    // Straight -> premultiplied alpha, for layers that weren't decoded as MODE_bgrA
+    VNM_API void PremultiplyRow(uint8* Dst, const uint8* Src, int32 NumPixels);
+
+    FORCEINLINE uint32 Div255(uint32 X)
+    {
+        X += 128;
+        return (X + (X >> 8)) >> 8;
+    }
+}
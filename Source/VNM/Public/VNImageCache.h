@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VNImageTypes.h"
+
+class FVNMemoryGovernor;
+
+// Thread-safe, byte-bounded LRU of decoded images. Entries that are still referenced elsewhere can be
+// evicted from the cache without affecting their users (shared pointers keep the pixels alive).
+class VNM_API FVNImageCache
+{
+public:
+    explicit FVNImageCache(int64 InBudgetBytes = 256ll * 1024 * 1024);
+    ~FVNImageCache();
+
+    FVNImageCache(const FVNImageCache&) = delete;
+    FVNImageCache& operator=(const FVNImageCache&) = delete;
+
+    // Counts a hit or miss in STATGROUP_WebP
+    FVNDecodedImagePtr Find(FName Id);
+    bool Contains(FName Id) const;
+
+    void Add(const FVNDecodedImagePtr& Image);
+    void Remove(FName Id);
+    void Empty();
+
+    // Reports entries to Governor as decoded bytes and lets it evict them; null detaches (waiting for an eviction of
+    // ours still running). Not from inside a governor eviction.
+    void SetGovernor(FVNMemoryGovernor* InGovernor);
+
+    void SetBudgetBytes(int64 InBudgetBytes);
+    int64 GetBudgetBytes() const { return BudgetBytes; }
+    int64 GetUsedBytes() const;
+    int32 Num() const;
+
+private:
+    void EvictToBudget_Locked(int64 Budget);
+    // FVNMemoryGovernor's eviction delegate. Handle tells a stale call apart from a re-added entry (the image's
+    // address can't: a re-decode may be allocated where the evicted one was).
+    bool OnGovernorEvict(uint64 Handle, FName Id);
+
+    struct FEntry
+    {
+        FVNDecodedImagePtr Image;
+        uint64 LastUse = 0;
+        uint64 GovernorHandle = 0;
+    };
+
+    // (Re)reports Entry to the governor, if any
+    void Track_Locked(FName Id, FEntry& Entry);
+
+    mutable FCriticalSection Mutex;
+    TMap<FName, FEntry> Entries;
+    int64 BudgetBytes;
+    int64 UsedBytes = 0;
+    uint64 UseCounter = 0;
+    FVNMemoryGovernor* Governor = nullptr;
+};
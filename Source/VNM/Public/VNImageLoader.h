@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VNImageTypes.h"
+
+class FWebPBundleReader;
+struct FWebPBundleEntry;
+class FWebpImageWrapper;
+class UTexture2D;
+
+// Resolves an image id ("backgrounds/school_day") to WebP bytes and decodes it.
+// Looks in mounted bundles first (zero-copy from the mapping), then in loose files under Content/.
+// Decode() is safe to call from worker threads; Mount/Unmount must not race with decodes.
+class VNM_API FVNImageLoader
+{
+public:
+    FVNImageLoader();
+    ~FVNImageLoader();
+
+    bool MountBundle(const FString& Filename);
+    void UnmountAll();
+
+    // Root for loose files, defaults to <ProjectContent>/VN
+    void SetLooseFileRoot(const FString& InRoot) { LooseFileRoot = InRoot; }
+
+    // Decode straight to premultiplied BGRA (what FVNSceneCompositor blends natively)
+    void SetPremultiplyAlpha(bool bInPremultiply) { bPremultiplyAlpha = bInPremultiply; }
+
+    // Id of the image whose bytes Id shares: bundles store duplicates once, and keying caches by this id means such
+    // images are decoded, cached and uploaded once. Id itself when it has no duplicate (or isn't in a bundle).
+    FName GetCanonicalId(FName Id) const;
+
+    // The result's Id is GetCanonicalId(Id). MaxDimension > 0 downscales like DecodeToTexture (previews).
+    FVNDecodedImagePtr Decode(FName Id, int32 MaxDimension = 0) const;
+    // Decode() from bytes the caller already holds (FindCompressed earlier, e.g. FVNResidencyManager)
+    FVNDecodedImagePtr DecodeCompressed(FName Id, TConstArrayView64<uint8> Compressed, int32 MaxDimension = 0) const;
+
+    // > 0: decodes also build an alpha hit-test mask (FVNDecodedImage::HitMask, DecodeToTexture's OutHitMask) with
+    // one bit per CellSize x CellSize pixels. 0 (default) builds none.
+    void SetHitMaskCellSize(int32 InCellSize) { HitMaskCellSize = FMath::Max(InCellSize, 0); }
+
+    // Compressed bytes of an image: a slice of a mounted bundle, or OutLooseBytes filled from the loose file
+    // (pooled; release with FWebPBufferPool). Empty if the image can't be found.
+    TConstArrayView64<uint8> FindCompressed(FName Id, TArray64<uint8>& OutLooseBytes) const;
+    // Bundle entries only: has the OS start paging the image's compressed bytes in. False for loose files.
+    bool PreloadCompressed(FName Id) const;
+
+    // Where the decoded image goes on its authored canvas (bundles built with -Trim store sprites cropped). Identity
+    // placement for untrimmed and loose images. Decode() fills FVNDecodedImage::CanvasOffset/CanvasSize from this;
+    // DecodeToTexture callers place the texture with it.
+    void GetPlacement(FName Id, FIntPoint& OutCanvasOffset, FIntPoint& OutCanvasSize) const;
+
+    // Game thread only. Creates a transient BGRA8 texture and decodes straight into its mip memory,
+    // skipping the decoded-pixels buffer and the copy into the mip. MaxDimension > 0 has the decoder
+    // downscale so the longer side fits (aspect kept), e.g. for previews. OutHitMask receives the hit mask at the
+    // texture's size when hit masks are enabled, so no CPU copy of the pixels is needed for hit testing at all.
+    UTexture2D* DecodeToTexture(FName Id, int32 MaxDimension = 0, FVNHitMaskPtr* OutHitMask = nullptr) const;
+
+    // DecodeToTexture for single-channel images (transition rules, masks): a linear G8 texture holding the image's
+    // luma, decoded from the Y plane without RGB conversion, at a quarter of the BGRA memory and upload bandwidth.
+    UTexture2D* DecodeGrayToTexture(FName Id, int32 MaxDimension = 0) const;
+
+    // DecodeToTexture for menu/UI art that doesn't need 8 bits per channel: opaque images become RGB565
+    // (PF_B5G6R5_UNORM), half the decoded and GPU memory of BGRA8. Images with alpha, and RHIs without 565 support,
+    // still get BGRA8: the engine has no 4-4-4-4 pixel format to upload FWebpImageWrapper's RGBA4444 output to.
+    UTexture2D* DecodeUIToTexture(FName Id, int32 MaxDimension = 0) const;
+
+    // ImageSize shrunk so its longer side is at most MaxDimension (unchanged if it already fits or MaxDimension <= 0)
+    static FIntPoint GetScaledSize(FIntPoint ImageSize, int32 MaxDimension);
+
+private:
+    const FWebPBundleEntry* FindBundleEntry(FName Id, const FWebPBundleReader*& OutBundle) const;
+
+    enum class ETextureFormat : uint8
+    {
+        BGRA8,
+        Gray8,
+        UI,     // RGB565 where possible, see DecodeUIToTexture
+    };
+    UTexture2D* DecodeToTexture(FName Id, int32 MaxDimension, ETextureFormat Format, FVNHitMaskPtr* OutHitMask) const;
+
+    // Points the wrapper at the bundle slice or at OutLooseBytes, which must outlive the decode
+    bool SetSource(FName Id, FWebpImageWrapper& Wrapper, TArray64<uint8>& OutLooseBytes) const;
+
+    TArray<TUniquePtr<FWebPBundleReader>> Bundles;
+    TMap<uint64, FName> CanonicalIds; // Name hash of a deduplicated entry -> id of the first entry sharing its blob
+    FString LooseFileRoot;
+    bool bPremultiplyAlpha = false;
+    int32 HitMaskCellSize = 0;
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include <atomic>
+#include "VNImageTypes.h"
+
+class FVNImageLoader;
+class FVNImageCache;
+class FVNMemoryGovernor;
+
+// One image referenced by a script line (background swap, sprite enter, CG...)
+struct FVNScriptImageRef
+{
+    FName ImageId;
+    EVNImageKind Kind = EVNImageKind::Background;
+};
+
+// The images a single upcoming script step will need
+struct FVNScriptStep
+{
+    TArray<FVNScriptImageRef> Images;
+};
+
+/**
+ * Decodes the images of the next few script steps on worker threads so that swaps on the critical path
+ * are cache hits. Nearer steps and backgrounds/CGs go first; requests that fall out of the lookahead
+ * window (jump, skip, load) are dropped or cancelled.
+ *
+ * Game thread API. Decodes run as UE::Tasks and publish into the shared FVNImageCache.
+ */
+class VNM_API FVNImagePrefetcher
+{
+public:
+    struct FStats
+    {
+        int32 Issued = 0;
+        int32 Completed = 0;
+        int32 Cancelled = 0;
+        int32 AcquireHits = 0;          // Acquire() served from cache
+        int32 AcquireWaits = 0;         // Acquire() had to wait for a prefetch already running
+        int32 AcquireMisses = 0;        // Acquire() decoded synchronously
+        int32 Throttled = 0;            // Pumps that held launches back for lack of memory headroom
+    };
+
+    FVNImagePrefetcher(FVNImageLoader& InLoader, FVNImageCache& InCache);
+    ~FVNImagePrefetcher();
+
+    FVNImagePrefetcher(const FVNImagePrefetcher&) = delete;
+    FVNImagePrefetcher& operator=(const FVNImagePrefetcher&) = delete;
+
+    // Max concurrent background decodes and how many upcoming steps are considered
+    void SetMaxInFlight(int32 InMaxInFlight) { MaxInFlight = FMath::Max(1, InMaxInFlight); }
+    void SetLookaheadSteps(int32 InLookaheadSteps) { LookaheadSteps = FMath::Max(1, InLookaheadSteps); }
+
+    // Optional. Launches wait while Governor->CanPrefetch() is false (they resume on the next UpdateLookahead or
+    // finished decode), the lookahead's image kinds feed its eviction priorities, and synchronous Acquire() decodes
+    // enforce its budget. Set before use; null detaches.
+    void SetGovernor(FVNMemoryGovernor* InGovernor) { Governor = InGovernor; }
+
+    // Call whenever the script position changes; UpcomingSteps[0] is the next step to be shown.
+    // Anything queued or running that is no longer in the window is cancelled.
+    void UpdateLookahead(TConstArrayView<FVNScriptStep> UpcomingSteps);
+
+    // Player jumped, skipped or loaded a save: drop every queued and running prefetch
+    void CancelAll();
+
+    // Critical path: cache hit, else wait for a matching in-flight prefetch, else decode synchronously
+    FVNDecodedImagePtr Acquire(FName Id);
+
+    FStats GetStats() const;
+
+    // Lower is more urgent
+    static int32 GetPriorityScore(int32 StepDistance, EVNImageKind Kind);
+
+private:
+    struct FQueued
+    {
+        FName Id;
+        int32 Score = 0;
+    };
+
+    struct FInFlight
+    {
+        int32 Score = 0;
+        TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bCancelled = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+        UE::Tasks::TTask<FVNDecodedImagePtr> Task;
+    };
+
+    void Pump_Locked();
+    void OnTaskFinished(FName Id, bool bWasCancelled);
+
+    FVNImageLoader& Loader;
+    FVNImageCache& Cache;
+    FVNMemoryGovernor* Governor = nullptr;
+
+    mutable FCriticalSection Mutex;
+    TArray<FQueued> Queue;              // Sorted by Score, not launched yet
+    TMap<FName, FInFlight> InFlight;
+    FStats Stats;
+
+    int32 MaxInFlight = 2;
+    int32 LookaheadSteps = 8;
+    bool bShuttingDown = false;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WebPBufferPool.h"
+#include "WebPAlphaMask.h"
+
+// What an image is used for in a scene. Drives prefetch priority and (later) eviction order.
+enum class EVNImageKind : uint8
+{
+    Background,
+    CG,
+    Sprite,
+    Overlay,
+    UI,
+};
+
+// Alpha hit-test mask of an image; small enough to keep after the pixels have been uploaded and dropped
+typedef TSharedPtr<const FWebPAlphaMask, ESPMode::ThreadSafe> FVNHitMaskPtr;
+
+// Decoded pixels shared between the cache, the prefetcher and whoever displays them.
+// Immutable once published, so it can be handed across threads freely.
+struct FVNDecodedImage
+{
+    FName Id;
+    int32 Width = 0;
+    int32 Height = 0;
+    TArray64<uint8> Pixels; // BGRA8, tightly packed
+    bool bPremultiplied = false; // Colour already multiplied by alpha (decoded as MODE_bgrA)
+    FVNHitMaskPtr HitMask;  // When the loader builds hit masks; holders can keep just this once the texture is up
+    // Bundles may store sprites trimmed to their non-transparent bounds: Pixels then cover only that part, and this
+    // is where it sits on the authored canvas. Zero offset and Width x Height for untrimmed images.
+    FIntPoint CanvasOffset = FIntPoint::ZeroValue;
+    FIntPoint CanvasSize = FIntPoint::ZeroValue;
+
+    FVNDecodedImage() = default;
+    ~FVNDecodedImage()
+    {
+        // Evicted images feed the next decode instead of going back to the general allocator
+        FWebPBufferPool::Get().Release(Pixels);
+    }
+
+    FVNDecodedImage(const FVNDecodedImage&) = delete;
+    FVNDecodedImage& operator=(const FVNDecodedImage&) = delete;
+
+    FIntPoint GetCanvasSize() const { return CanvasSize.X > 0 ? CanvasSize : FIntPoint(Width, Height); }
+
+    int64 GetSizeBytes() const { return Pixels.GetAllocatedSize() + (HitMask.IsValid() ? HitMask->GetAllocatedSize() : 0); }
+};
+
+typedef TSharedPtr<const FVNDecodedImage, ESPMode::ThreadSafe> FVNDecodedImagePtr;
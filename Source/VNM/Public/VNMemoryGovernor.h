@@ -0,0 +1,141 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VNImageTypes.h"
+
+class UTexture;
+
+// What a tracked allocation is: CPU pixels from a decode, or GPU memory of a texture made from one
+enum class EVNMemoryCategory : uint8
+{
+    Decoded,
+    Texture,
+};
+
+/**
+ * One memory budget for everything the WebP pipeline keeps alive in a scene: decoded pixels (FVNImageCache,
+ * FVNResidencyManager) and the textures made from them. Without it each holder stays within its own budget while
+ * together a heavy CG sequence runs out of memory.
+ *
+ * - Holders Track() what they allocate and Untrack() what they free, with a delegate the governor can call to make
+ *   them free it: FVNImageCache and FVNResidencyManager for decoded pixels; FVNPreviewLoader, FVNCompositedTexture,
+ *   FVNTileStreamer and FVNAnimationCache for their textures (and canvas / tile pixels), which count against the budget
+ *   but are only freed by their owners. Pinned residency images and live preview handles are AddOnScreen()ed.
+ * - Enforce() / Reserve() evict down to the budget: images not on screen only, sprites first and backgrounds last
+ *   (GetEvictionPriority), least recently used first within a kind, decoded pixels before textures. Critical-path
+ *   loads (prefetcher misses, residency decodes, preview and scene textures) Reserve() before they allocate.
+ * - GetHeadroomBytes() / CanPrefetch() let the prefetcher and loaders throttle themselves instead of overshooting:
+ *   speculative work stops while headroom is below the prefetch reserve, keeping that room for the critical path.
+ *
+ * Thread-safe. Eviction delegates run outside the governor's lock, on the thread that called Enforce / Reserve;
+ * holders call UntrackAll() before they go away so none runs on a destroyed holder.
+ * Images are keyed by FVNImageLoader::GetCanonicalId, like FVNImageCache.
+ */
+class VNM_API FVNMemoryGovernor
+{
+public:
+    struct FStats
+    {
+        int64 DecodedBytes = 0;
+        int64 TextureBytes = 0;
+        int64 PeakBytes = 0;
+        int32 Evictions = 0;
+        int64 EvictedBytes = 0;
+        int32 Refusals = 0;             // Eviction delegates that declined (pinned, in use)
+        int32 OverBudget = 0;           // Enforce / Reserve that ran out of evictable allocations
+
+        int64 GetUsedBytes() const { return DecodedBytes + TextureBytes; }
+    };
+
+    // Identifies one Track()ed allocation; 0 is never handed out
+    typedef uint64 FAllocationHandle;
+
+    // Frees the allocation and Untracks it; returns false if it can't go right now (pinned, in use). Allocations
+    // tracked without a bound delegate count against the budget but are never evicted. Handle tells a stale call apart
+    // from a newer allocation of the same image.
+    DECLARE_DELEGATE_RetVal_OneParam(bool, FOnEvict, FAllocationHandle /*Handle*/);
+
+    explicit FVNMemoryGovernor(int64 InBudgetBytes = 512ll * 1024 * 1024);
+
+    FVNMemoryGovernor(const FVNMemoryGovernor&) = delete;
+    FVNMemoryGovernor& operator=(const FVNMemoryGovernor&) = delete;
+
+    // Doesn't evict by itself; the next Enforce() does
+    void SetBudgetBytes(int64 InBudgetBytes);
+    int64 GetBudgetBytes() const;
+    // Headroom kept free for critical-path loads: CanPrefetch() is false once headroom drops below it
+    void SetPrefetchReserveBytes(int64 InReserveBytes);
+
+    // Adds an allocation of Owner (the holder, for UntrackAll) and returns its handle. Any number of holders may track
+    // the same Id: the cache and the residency manager can both hold an image's pixels. Never evicts, so holders can
+    // call it under their own locks.
+    FAllocationHandle Track(const void* Owner, FName Id, EVNMemoryCategory Category, int64 Bytes, FOnEvict OnEvict = FOnEvict());
+    // No-op for 0 or an allocation already untracked
+    void Untrack(FAllocationHandle Handle);
+    // Untracks all of Owner's allocations and waits for its eviction delegates still running on other threads, so
+    // Owner may be destroyed once this returns. Not from inside Owner's delegate or under a lock the delegate takes.
+    void UntrackAll(const void* Owner);
+    // Marks Id's allocations as just used (LRU order within a priority)
+    void Touch(FName Id);
+
+    // Scene state behind the eviction priorities. Ids with no kind (not seen by the prefetcher's lookahead) are
+    // evicted before any known kind; on-screen images are never evicted. On-screen marks are counted so several
+    // holders can report the same image: every AddOnScreen needs a RemoveOnScreen.
+    void SetKind(FName Id, EVNImageKind Kind);
+    void AddOnScreen(FName Id);
+    void RemoveOnScreen(FName Id);
+
+    int64 GetUsedBytes() const;
+    // Budget minus used bytes, 0 when over budget
+    int64 GetHeadroomBytes() const;
+    // Whether speculative work needing Bytes more should start now
+    bool CanPrefetch(int64 Bytes = 0) const;
+
+    // Evicts down to the budget; returns the bytes freed
+    int64 Enforce();
+    // Evicts until Bytes more fit in the budget (before a critical-path decode or texture). Returns the headroom left
+    // once Bytes are counted, negative if they still don't fit.
+    int64 Reserve(int64 Bytes);
+
+    FStats GetStats() const;
+
+    // Lower is evicted first
+    static int32 GetEvictionPriority(const EVNImageKind* Kind);
+    // GPU memory of a texture's resident mips
+    static int64 GetTextureBytes(const UTexture* Texture);
+
+private:
+    struct FAllocation
+    {
+        const void* Owner = nullptr;
+        FName Id;
+        EVNMemoryCategory Category = EVNMemoryCategory::Decoded;
+        int64 Bytes = 0;
+        uint64 LastUse = 0;
+        FOnEvict OnEvict;
+    };
+
+    struct FVictim
+    {
+        FAllocationHandle Handle;
+        int64 Bytes;
+    };
+
+    int64& GetCategoryBytes(EVNMemoryCategory Category) { return Category == EVNMemoryCategory::Decoded ? Stats.DecodedBytes : Stats.TextureBytes; }
+    void Remove_Locked(FAllocationHandle Handle);
+
+    // Picks the evictable allocations, in eviction order, that bring usage down to TargetBytes
+    void SelectVictims_Locked(int64 TargetBytes, const TSet<FAllocationHandle>& Skipped, TArray<FVictim>& OutVictims) const;
+    int64 EvictTo(int64 TargetBytes);
+
+    mutable FCriticalSection Mutex;
+    TMap<FAllocationHandle, FAllocation> Allocations;
+    TMap<FName, EVNImageKind> Kinds;
+    TMap<FName, int32> OnScreen;            // AddOnScreen count per id
+    TArray<const void*> EvictingOwners;     // Owner of each eviction delegate running right now, for UntrackAll
+    FStats Stats;
+    int64 BudgetBytes;
+    int64 PrefetchReserveBytes = 64ll * 1024 * 1024;
+    uint64 UseCounter = 0;
+    FAllocationHandle LastHandle = 0;
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include "UObject/StrongObjectPtr.h"
+#include <atomic>
+#include "VNImageTypes.h"
+#include "VNMemoryGovernor.h"
+
+class FVNImageLoader;
+class UTexture2D;
+
+/**
+ * Two-stage load for chapter starts: a blurry background on screen right away instead of a blank frame.
+ *
+ * Load() starts two decodes on workers: a heavily downscaled preview (libwebp scales while it writes rows, so no
+ * full-size buffer, but it still decodes the whole bitstream) and the full image. The game thread never decodes.
+ * Tick() shows the preview as soon as it's ready and swaps the full-resolution texture in once that decode has
+ * finished; if the full decode wins, the preview is skipped. TimeToFirstPixel next to TimeToFullResolution in the
+ * stats is what the preview buys over a plain full decode.
+ *
+ * With a governor, a handle's image is on screen for as long as the handle lives, and its texture counts against the
+ * budget; each texture Reserve()s its room before it's created.
+ */
+class VNM_API FVNPreviewLoader
+{
+public:
+    struct FSettings
+    {
+        int32 PreviewMaxDimension = 160; // Longer side of the preview, in pixels
+    };
+
+    // One load. Texture is null until the first Tick() after the preview decode, then the preview until
+    // bIsFullResolution is set; OnTextureChanged fires on each change.
+    struct FHandle
+    {
+        FName Id;
+        TStrongObjectPtr<UTexture2D> Texture;
+        bool bIsFullResolution = false;
+        FVNHitMaskPtr HitMask;                      // With FVNImageLoader::SetHitMaskCellSize; test with HitTestUV
+        double TimeToFirstPixelSeconds = 0.0;       // Load() until the first texture is created and queued for upload
+        double TimeToFullResolutionSeconds = 0.0;   // Load() until the full texture replaced it
+        FSimpleMulticastDelegate OnTextureChanged;
+
+        FHandle() = default;
+        ~FHandle(); // Untracks the texture and takes the image off screen
+
+        FHandle(const FHandle&) = delete;
+        FHandle& operator=(const FHandle&) = delete;
+
+    private:
+        friend class FVNPreviewLoader;
+
+        void TrackTexture();
+
+        FVNMemoryGovernor* Governor = nullptr;
+        FName CanonicalId;                              // What the governor knows the image as
+        FVNMemoryGovernor::FAllocationHandle TextureAllocation = 0;
+    };
+
+    struct FStats
+    {
+        int32 Loads = 0;                            // Loads that got a texture, preview or full
+        int32 Swaps = 0;
+        double TotalTimeToFirstPixelSeconds = 0.0;
+        double TotalTimeToFullResolutionSeconds = 0.0;
+
+        double GetAverageTimeToFirstPixelMs() const { return Loads > 0 ? TotalTimeToFirstPixelSeconds / Loads * 1000.0 : 0.0; }
+        double GetAverageTimeToFullResolutionMs() const { return Swaps > 0 ? TotalTimeToFullResolutionSeconds / Swaps * 1000.0 : 0.0; }
+    };
+
+    explicit FVNPreviewLoader(const FVNImageLoader& InLoader);
+    ~FVNPreviewLoader(); // Waits for running decodes
+
+    FVNPreviewLoader(const FVNPreviewLoader&) = delete;
+    FVNPreviewLoader& operator=(const FVNPreviewLoader&) = delete;
+
+    void SetSettings(const FSettings& InSettings) { Settings = InSettings; }
+    const FSettings& GetSettings() const { return Settings; }
+    // Set before the first Load(); must outlive the handles
+    void SetGovernor(FVNMemoryGovernor* InGovernor) { Governor = InGovernor; }
+
+    // Game thread. Returns right away; a failed decode is logged by Tick() and leaves the handle without a texture.
+    TSharedPtr<FHandle> Load(FName Id);
+
+    // Game thread, once per frame: shows finished previews and swaps in finished full-resolution textures
+    void Tick();
+
+    // Drops pending swaps; handles keep their preview
+    void CancelAll();
+
+    int32 GetNumPending() const { return Pending.Num(); }
+    const FStats& GetStats() const { return Stats; }
+
+private:
+    struct FPending
+    {
+        TSharedPtr<FHandle> Handle;
+        double StartSeconds = 0.0;
+        TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bCancelled = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+        UE::Tasks::TTask<FVNDecodedImagePtr> PreviewTask;
+        UE::Tasks::TTask<FVNDecodedImagePtr> Task;
+        bool bPreviewHandled = false;
+    };
+
+    // Replaces the handle's texture with one made from Image; false if it couldn't be created
+    bool ShowImage(FPending& Entry, const FVNDecodedImage& Image, bool bIsFullResolution);
+
+    const FVNImageLoader& Loader;
+    FSettings Settings;
+    FStats Stats;
+    FVNMemoryGovernor* Governor = nullptr;
+    TArray<FPending> Pending;
+};
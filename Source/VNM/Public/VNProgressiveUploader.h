@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include "UObject/StrongObjectPtr.h"
+#include <atomic>
+
+class FVNImageLoader;
+class UTexture2D;
+
+/**
+ * Shows large images (CGs, backgrounds) top-down while they decode instead of after.
+ *
+ * A worker feeds each bitstream to an incremental decoder in chunks and publishes how many rows are final;
+ * Tick() on the game thread uploads the newly completed row band of every image with UpdateTextureRegions.
+ * Images decode one after another on a single task chain, so the upload of an image's last band overlaps
+ * the decode of the next one.
+ */
+class VNM_API FVNProgressiveUploader
+{
+public:
+    struct FSettings
+    {
+        int64 ChunkBytes = 64 * 1024;   // Bitstream fed to the decoder per step
+        int32 MinBandRows = 64;         // Smaller bands wait for the next Tick (the last band always goes)
+        bool bPremultiplyAlpha = false;
+    };
+
+    struct FStats
+    {
+        int32 ImagesCompleted = 0;
+        int32 BandsUploaded = 0;
+        int64 BytesUploaded = 0;
+        double LastFirstBandSeconds = 0.0;  // Load() to the first band upload of the most recent image
+        double LastCompleteSeconds = 0.0;   // Load() to the last band upload
+    };
+
+    explicit FVNProgressiveUploader(const FVNImageLoader& InLoader);
+    ~FVNProgressiveUploader(); // Cancels and waits for the decode chain
+
+    FVNProgressiveUploader(const FVNProgressiveUploader&) = delete;
+    FVNProgressiveUploader& operator=(const FVNProgressiveUploader&) = delete;
+
+    void SetSettings(const FSettings& InSettings) { Settings = InSettings; }
+
+    // Game thread. Returns the (black) texture immediately and queues the decode; null if the image is missing.
+    UTexture2D* Load(FName Id);
+
+    // Game thread, once per frame: uploads completed row bands and retires finished images
+    void Tick();
+
+    // Stops decoding; textures keep whatever bands were already uploaded
+    void CancelAll();
+
+    int32 GetNumPending() const { return Jobs.Num(); }
+    const FStats& GetStats() const { return Stats; }
+
+private:
+    struct FJob
+    {
+        FName Id;
+        int32 Width = 0;
+        int32 Height = 0;
+        double StartSeconds = 0.0;
+        bool bFirstBandUploaded = false;
+
+        TArray64<uint8> LooseBytes;                 // Owns the bitstream when it did not come from a bundle
+        TConstArrayView64<uint8> Compressed;
+
+        // Decode target; shared with render commands so it outlives an upload still in flight
+        TSharedPtr<TArray64<uint8>, ESPMode::ThreadSafe> Pixels;
+
+        std::atomic<int32> DecodedRows { 0 };
+        std::atomic<bool> bDecodeFinished { false };
+        std::atomic<bool> bDecodeFailed { false };
+        std::atomic<bool> bCancelled { false };
+
+        // Game thread only
+        TStrongObjectPtr<UTexture2D> Texture;
+        int32 UploadedRows = 0;
+    };
+
+    static void DecodeJob(FJob& Job, const FSettings& Settings);
+    void UploadBand(FJob& Job, int32 EndRow);
+
+    const FVNImageLoader& Loader;
+    FSettings Settings;
+    FStats Stats;
+
+    TArray<TSharedPtr<FJob, ESPMode::ThreadSafe>> Jobs;
+    UE::Tasks::FTask LastTask; // Tail of the decode chain
+};
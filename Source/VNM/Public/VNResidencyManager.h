@@ -0,0 +1,139 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VNImageTypes.h"
+
+class FVNImageLoader;
+class FVNMemoryGovernor;
+
+// Where an image's data currently lives, from cheapest to most expensive to hold
+enum class EVNResidency : uint8
+{
+    None,           // Nothing held; the next use reads the bundle mapping / loose file
+    Compressed,     // WebP bytes resident, a decode away from being drawable
+    Decoded,        // Decoded pixels held as well
+};
+
+VNM_API const TCHAR* LexToString(EVNResidency Residency);
+
+/**
+ * Compressed-resident mode for long chapters. Every image of the chapter is kept as WebP bytes (a tenth of the
+ * pixels, or less), and decoded pixels are held only for what is on screen or about to be: a decode costs a few
+ * milliseconds, holding a chapter's worth of BGRA costs hundreds of megabytes.
+ *
+ * - SetResidentSet() at chapter start: loose files are read into memory, bundle entries are views into the mapping
+ *   that the OS is asked to page in.
+ * - Acquire() decodes on demand from the resident bytes and keeps the pixels, LRU-bounded by the decoded budget.
+ * - Pin() marks images on screen / imminent; their pixels are never evicted, even over budget.
+ * - OnResidencyChanged reports every transition (logging, debug overlays, the memory governor).
+ *
+ * Thread-safe; decodes run on the calling thread outside the lock. Images are keyed by
+ * FVNImageLoader::GetCanonicalId, like FVNImageCache.
+ */
+class VNM_API FVNResidencyManager
+{
+public:
+    struct FStats
+    {
+        int32 Decodes = 0;              // Compressed -> Decoded
+        int32 Evictions = 0;            // Decoded -> Compressed to stay in budget
+        int32 DecodedHits = 0;          // Acquire() served without decoding
+        int32 ColdLoads = 0;            // Acquire() of an image that wasn't even compressed-resident
+        int64 CompressedBytes = 0;      // Resident WebP bytes (mapped bundle slices included)
+        int64 DecodedBytes = 0;
+        int64 PeakDecodedBytes = 0;
+        double TotalDecodeSeconds = 0.0;
+
+        double GetAverageDecodeMs() const { return Decodes > 0 ? TotalDecodeSeconds / Decodes * 1000.0 : 0.0; }
+    };
+
+    // Fired on the thread that caused the transition, outside the manager's lock
+    DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnResidencyChanged, FName /*Id*/, EVNResidency /*From*/, EVNResidency /*To*/);
+
+    explicit FVNResidencyManager(const FVNImageLoader& InLoader, int64 InDecodedBudgetBytes = 128ll * 1024 * 1024);
+    ~FVNResidencyManager();
+
+    FVNResidencyManager(const FVNResidencyManager&) = delete;
+    FVNResidencyManager& operator=(const FVNResidencyManager&) = delete;
+
+    // Makes exactly Ids compressed-resident: missing ones are loaded, others dropped (pinned images stay)
+    void SetResidentSet(TConstArrayView<FName> Ids);
+    bool MakeResident(FName Id);
+    void Release(FName Id);
+    void ReleaseAll();
+
+    // Decoded pixels, decoding from the resident bytes if needed (loading them first if the image isn't resident)
+    FVNDecodedImagePtr Acquire(FName Id);
+
+    // Pinned images keep their decoded pixels regardless of the budget. Counted: every Pin needs an Unpin.
+    void Pin(FName Id);
+    void Unpin(FName Id);
+
+    // Reports decoded pixels to Governor and lets it evict unpinned ones; pinned images are on screen for it.
+    // Null detaches (waiting for an eviction of ours still running). Not from inside a governor eviction.
+    void SetGovernor(FVNMemoryGovernor* InGovernor);
+
+    // Drops decoded pixels of unpinned images down to the budget, least recently used first
+    void SetDecodedBudgetBytes(int64 InBudgetBytes);
+    int64 GetDecodedBudgetBytes() const;
+    // Drops decoded pixels of unpinned images until at most MaxDecodedBytes remain; returns the bytes freed
+    int64 TrimDecoded(int64 MaxDecodedBytes);
+
+    EVNResidency GetResidency(FName Id) const;
+    FStats GetStats() const;
+    FOnResidencyChanged& OnResidencyChanged() { return ResidencyChanged; }
+
+private:
+    // Shared so a decode running outside the lock keeps the bytes alive through a concurrent Release
+    struct FCompressed
+    {
+        TArray64<uint8> OwnedBytes;             // Loose files (pooled); bundle entries borrow the mapping instead
+        TConstArrayView64<uint8> Bytes;
+
+        FCompressed() = default;
+        ~FCompressed() { FWebPBufferPool::Get().Release(OwnedBytes); }
+        FCompressed(const FCompressed&) = delete;
+        FCompressed& operator=(const FCompressed&) = delete;
+    };
+    typedef TSharedPtr<FCompressed, ESPMode::ThreadSafe> FCompressedPtr;
+
+    struct FEntry
+    {
+        FCompressedPtr Compressed;
+        FVNDecodedImagePtr Decoded;
+        uint64 GovernorHandle = 0;              // Governor allocation of Decoded, 0 when untracked
+        uint64 LastUse = 0;
+        int32 PinCount = 0;
+        bool bInResidentSet = false;            // Listed by SetResidentSet / MakeResident, not just pinned or acquired
+
+        EVNResidency GetResidency() const { return Decoded.IsValid() ? EVNResidency::Decoded : EVNResidency::Compressed; }
+    };
+
+    struct FTransition
+    {
+        FName Id;
+        EVNResidency From;
+        EVNResidency To;
+    };
+
+    // Reads / maps the compressed bytes; called outside the lock
+    FCompressedPtr LoadCompressed(FName Id) const;
+    FEntry& FindOrAdd_Locked(FName Id, const FCompressedPtr& Loaded, TArray<FTransition>& OutTransitions);
+    void Remove_Locked(FName Id, TArray<FTransition>& OutTransitions);
+    int64 EvictDecoded_Locked(int64 MaxDecodedBytes, TArray<FTransition>& OutTransitions);
+    void Broadcast(const TArray<FTransition>& Transitions);
+    // FVNMemoryGovernor's eviction delegate: refuses pinned images. Handle, not the image's address, identifies the
+    // pixels it was bound for; a re-decode can land at the same address.
+    bool OnGovernorEvict(uint64 Handle, FName Id);
+    void Track_Locked(FName Id, FEntry& Entry);
+
+    const FVNImageLoader& Loader;
+    FOnResidencyChanged ResidencyChanged;
+
+    mutable FCriticalSection Mutex;
+    TMap<FName, FEntry> Entries;
+    FStats Stats;
+    int64 DecodedBudgetBytes;
+    uint64 UseCounter = 0;
+    FVNMemoryGovernor* Governor = nullptr;
+};
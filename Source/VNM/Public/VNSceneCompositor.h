@@ -0,0 +1,115 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VNImageTypes.h"
+#include "UObject/StrongObjectPtr.h"
+
+class UTexture2D;
+class FVNMemoryGovernor;
+
+// One decoded image placed on the canvas
+struct FVNCompositorLayer
+{
+    FVNDecodedImagePtr Image;
+    FIntPoint Position = FIntPoint::ZeroValue; // Top-left corner of the image's authored canvas, may be off-canvas
+    float Opacity = 1.0f;
+    int32 ZOrder = 0;                          // Lower is further back; ties keep insertion order
+};
+
+/**
+ * Flattens a VN shot (background + character layers + overlays) into one premultiplied BGRA8 buffer on the CPU,
+ * so a static shot is a single texture / single UImage instead of one per layer.
+ * Rows are blended with the VNBlend kernels (AVX2 / NEON / scalar).
+ */
+class VNM_API FVNSceneCompositor
+{
+public:
+    void SetCanvasSize(FIntPoint InSize) { CanvasSize = InSize; MarkAllDirty(); }
+    FIntPoint GetCanvasSize() const { return CanvasSize; }
+
+    // Returns a handle for GetLayer / UpdateLayer / RemoveLayer. Every mutation dirties the area it touches.
+    int32 AddLayer(const FVNCompositorLayer& Layer);
+    const FVNCompositorLayer* GetLayer(int32 Handle) const { return Layers.Find(Handle); }
+    void UpdateLayer(int32 Handle, const FVNCompositorLayer& NewState);
+    void RemoveLayer(int32 Handle);
+    void ClearLayers();
+    int32 NumLayers() const { return Layers.Num(); }
+
+    // Convenience mutators for the common per-line changes (expression swap, slide, fade)
+    void SetLayerImage(int32 Handle, const FVNDecodedImagePtr& Image);
+    void SetLayerPosition(int32 Handle, FIntPoint Position);
+    void SetLayerOpacity(int32 Handle, float Opacity);
+
+    // Areas that changed since the last TakeDirtyRegions(); overlapping rects are merged
+    void MarkDirty(const FIntRect& Rect);
+    void MarkAllDirty() { MarkDirty(FIntRect(FIntPoint::ZeroValue, CanvasSize)); }
+    bool IsDirty() const { return DirtyRegions.Num() > 0; }
+    TArray<FIntRect> TakeDirtyRegions();
+
+    // Canvas rectangle a layer covers (clipped to the canvas), empty if the layer has no image
+    FIntRect GetLayerBounds(const FVNCompositorLayer& Layer) const;
+
+    // Whole canvas into OutPixels (resized to CanvasSize, tightly packed)
+    void Compose(TArray64<uint8>& OutPixels) const;
+
+    // Recomposes only Region of an existing canvas buffer with the given row stride in bytes
+    void ComposeRegion(const FIntRect& Region, uint8* Canvas, int64 CanvasStride) const;
+
+    // Transient PF_B8G8R8A8 texture with the composed pixels
+    static UTexture2D* CreateTexture(const TArray64<uint8>& Pixels, FIntPoint Size);
+
+private:
+    // Layers in draw order
+    TArray<const FVNCompositorLayer*> GetSortedLayers() const;
+
+    // Past this many rects the bookkeeping costs more than the overdraw; collapse to one bounding rect
+    static constexpr int32 MaxDirtyRegions = 16;
+
+    FIntPoint CanvasSize = FIntPoint(1920, 1080);
+    TMap<int32, FVNCompositorLayer> Layers;
+    int32 NextHandle = 0;
+    TArray<FIntRect> DirtyRegions;
+};
+
+/**
+ * Owns a composed canvas and its texture, and keeps them in sync with the compositor incrementally:
+ * only dirty regions are recomposed and only those regions are uploaded (UpdateTextureRegions),
+ * instead of locking and re-uploading the full mip.
+ */
+class VNM_API FVNCompositedTexture
+{
+public:
+    struct FUploadStats
+    {
+        int64 LastUploadedBytes = 0;
+        int64 TotalUploadedBytes = 0;
+        int64 FullFrameBytes = 0;     // What a full re-upload would have cost per update
+        int32 NumUpdates = 0;
+        int32 LastRegionCount = 0;
+    };
+
+    explicit FVNCompositedTexture(FVNSceneCompositor& InCompositor);
+    ~FVNCompositedTexture();
+
+    // Recomposes dirty regions and uploads them. Creates (or recreates on resize) the texture with a full upload.
+    // Returns the bytes sent to the GPU by this call.
+    int64 Update();
+
+    // Counts the canvas and texture against Governor's budget, and Reserve()s room before (re)creating them.
+    // Set before the first Update(); must outlive this.
+    void SetGovernor(FVNMemoryGovernor* InGovernor) { Governor = InGovernor; }
+
+    UTexture2D* GetTexture() const;
+    const TArray64<uint8>& GetCanvas() const { return Canvas; }
+    const FUploadStats& GetUploadStats() const { return Stats; }
+
+private:
+    FVNSceneCompositor& Compositor;
+    TArray64<uint8> Canvas;
+    FIntPoint TextureSize = FIntPoint::ZeroValue;
+    TStrongObjectPtr<UTexture2D> Texture;
+    FUploadStats Stats;
+    FVNMemoryGovernor* Governor = nullptr;
+    uint64 CanvasAllocation = 0;
+    uint64 TextureAllocation = 0;
+};
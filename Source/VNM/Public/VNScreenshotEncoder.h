@@ -0,0 +1,99 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include <atomic>
+
+/**
+ * Save-slot thumbnails without a game-thread hitch: the capture is handed to a worker that downsamples and encodes
+ * it with a fast WebP setting, and Tick() delivers the bytes back on the game thread for the save system to store.
+ *
+ * Jobs can be cancelled at any point (new save over the same slot, leaving the menu): a running encode stops at
+ * libwebp's next progress callback instead of finishing a thumbnail nobody wants.
+ */
+class VNM_API FVNScreenshotEncoder
+{
+public:
+    struct FSettings
+    {
+        int32 MaxDimension = 320;   // Longer side of the thumbnail, in pixels (0 = capture size)
+        int32 Quality = 70;
+        int32 Method = 0;           // WebPConfig.method: 0 is the fastest, thumbnails don't need better
+    };
+
+    struct FStats
+    {
+        int32 Started = 0;
+        int32 Completed = 0;
+        int32 Cancelled = 0;
+        int32 Failed = 0;
+        double TotalEncodeSeconds = 0.0;    // Worker time of the completed jobs
+
+        double GetAverageEncodeMs() const { return Completed > 0 ? TotalEncodeSeconds / Completed * 1000.0 : 0.0; }
+    };
+
+    // WebP bytes of the thumbnail (the callee may move them out); empty if the encode failed. Not called for
+    // cancelled jobs.
+    DECLARE_DELEGATE_OneParam(FOnEncoded, TArray64<uint8>& /*Compressed*/);
+
+    FVNScreenshotEncoder() = default;
+    ~FVNScreenshotEncoder(); // Cancels and waits for running encodes
+
+    FVNScreenshotEncoder(const FVNScreenshotEncoder&) = delete;
+    FVNScreenshotEncoder& operator=(const FVNScreenshotEncoder&) = delete;
+
+    void SetSettings(const FSettings& InSettings) { Settings = InSettings; }
+    const FSettings& GetSettings() const { return Settings; }
+
+    // Game thread. Takes the capture (FColor is BGRA8 in memory; alpha is ignored) and starts encoding it on a
+    // worker. Returns the job id for Cancel, 0 if the capture is empty.
+    uint32 Encode(TArray<FColor>&& Pixels, FIntPoint Size, FOnEncoded OnEncoded);
+
+    // Game thread. Requests a screenshot of the game viewport (UI included or not) and encodes it once the renderer
+    // has read it back, a frame or two later. Returns the job id, 0 if there is no game viewport.
+    uint32 CaptureViewport(bool bShowUI, FOnEncoded OnEncoded);
+
+    // Game thread, once per frame: fires OnEncoded for finished jobs
+    void Tick();
+
+    void Cancel(uint32 JobId);
+    void CancelAll();
+
+    int32 GetNumPending() const { return Jobs.Num() + (PendingCapture.IsSet() ? 1 : 0); }
+    const FStats& GetStats() const { return Stats; }
+
+    // Thumbnail size for a capture: longer side shrunk to MaxDimension, aspect kept
+    static FIntPoint GetThumbnailSize(FIntPoint CaptureSize, int32 MaxDimension);
+
+private:
+    struct FResult
+    {
+        TArray64<uint8> Compressed;
+        double EncodeSeconds = 0.0;
+    };
+
+    struct FJob
+    {
+        uint32 Id = 0;
+        FOnEncoded OnEncoded;
+        TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bCancelled = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+        UE::Tasks::TTask<FResult> Task;
+    };
+
+    struct FPendingCapture
+    {
+        uint32 Id = 0;
+        FOnEncoded OnEncoded;
+        FDelegateHandle CapturedHandle;
+    };
+
+    void OnScreenshotCaptured(int32 InWidth, int32 InHeight, const TArray<FColor>& InColors);
+    uint32 Launch(uint32 JobId, TArray<FColor>&& Pixels, FIntPoint Size, FOnEncoded OnEncoded);
+    void ClearPendingCapture();
+
+    FSettings Settings;
+    FStats Stats;
+    TArray<FJob> Jobs;
+    TOptional<FPendingCapture> PendingCapture;
+    uint32 NextJobId = 1;
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include "UObject/StrongObjectPtr.h"
+#include <atomic>
+#include "VNImageTypes.h"
+#include "WebPTiledImage.h"
+
+class UTexture2D;
+class FVNMemoryGovernor;
+
+/**
+ * Virtual-texture-style streaming for backgrounds far larger than the screen (panoramas the camera pans across).
+ *
+ * The source is a .webptiles image (see FWebPTiledImage). Update() takes the viewport in image pixels each frame,
+ * keeps the visible tiles plus a margin ring decoded (one UE::Tasks decode per tile, visible tiles first) and
+ * evicts tiles once they are further out than margin + slack. Resident memory therefore follows the viewport
+ * size, not the image size. With a governor, resident tiles and their textures count against the scene budget.
+ *
+ * Game thread API.
+ */
+class VNM_API FVNTileStreamer
+{
+public:
+    struct FSettings
+    {
+        int32 MarginTiles = 1;          // Ring decoded ahead around the visible tiles
+        int32 EvictSlackTiles = 1;      // Extra ring a resident tile survives in, so jitter at a tile edge doesn't thrash
+        int32 MaxInFlight = 4;          // Concurrent tile decodes
+        bool bCreateTextures = true;    // One texture per resident tile; off for headless use (replays, benchmarks)
+        bool bPremultiplyAlpha = false;
+    };
+
+    struct FStats
+    {
+        int32 Updates = 0;
+        int32 VisibleTiles = 0;         // Summed over updates
+        int32 VisibleMisses = 0;        // Visible tiles that were not resident yet when Update() ran
+        int32 TilesDecoded = 0;
+        int32 TilesEvicted = 0;
+        int32 TilesCancelled = 0;       // Decodes dropped because the camera moved on first
+        double DecodeSeconds = 0.0;     // Worker time spent decoding tiles
+        int32 ResidentTiles = 0;
+        int64 ResidentBytes = 0;
+        int64 PeakResidentBytes = 0;
+    };
+
+    struct FTile
+    {
+        FIntPoint Coord = FIntPoint::ZeroValue;
+        FIntRect Rect;                  // Pixels of the full image this tile covers
+        FVNDecodedImagePtr Image;
+        TStrongObjectPtr<UTexture2D> Texture; // Null unless bCreateTextures
+        uint64 ImageAllocation = 0;     // Governor handles, 0 without one
+        uint64 TextureAllocation = 0;
+    };
+
+    FVNTileStreamer() = default;
+    ~FVNTileStreamer(); // Waits for running decodes
+
+    FVNTileStreamer(const FVNTileStreamer&) = delete;
+    FVNTileStreamer& operator=(const FVNTileStreamer&) = delete;
+
+    void SetSettings(const FSettings& InSettings) { Settings = InSettings; }
+    const FSettings& GetSettings() const { return Settings; }
+
+    // Replace the current image (everything resident is dropped). OpenView borrows Data, which must outlive Close().
+    bool OpenFile(const FString& Filename);
+    bool OpenView(TConstArrayView64<uint8> Data);
+    void Close();
+
+    bool IsOpen() const { return Source.IsValid(); }
+    FIntPoint GetImageSize() const { return FIntPoint(Source.GetWidth(), Source.GetHeight()); }
+
+    // Once per frame with the visible part of the image, in image pixels
+    void Update(const FIntRect& Viewport);
+
+    // Blocks until everything the last Update() asked for is resident (loading screens, replays)
+    void Flush();
+
+    // Resident tile at a tile coordinate, or null while it is not decoded
+    const FTile* FindTile(FIntPoint Coord) const { return Resident.Find(Coord); }
+
+    // Resident tiles overlapping the last viewport, for drawing; missing tiles are simply absent
+    void GetVisibleTiles(TArray<const FTile*>& OutTiles) const;
+
+    const FStats& GetStats() const { return Stats; }
+    void ResetStats();
+
+private:
+    struct FDecodeResult
+    {
+        FVNDecodedImagePtr Image;
+        double Seconds = 0.0;
+    };
+
+    struct FPending
+    {
+        TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe> bCancelled = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+        UE::Tasks::TTask<FDecodeResult> Task;
+    };
+
+    // Tile coordinate range covering a pixel rect (Max exclusive), grown by Rings and clamped to the grid
+    FIntRect GetTileRange(const FIntRect& PixelRect, int32 Rings) const;
+
+    // Set before Open; must outlive this
+    void SetGovernor(FVNMemoryGovernor* InGovernor) { Governor = InGovernor; }
+
+    void CollectFinished();
+    void Evict(const FIntRect& KeepRange);
+    void Launch();
+    void AddResident(FIntPoint Coord, FVNDecodedImagePtr Image);
+    void UntrackTile(const FTile& Tile);
+
+    FSettings Settings;
+    FStats Stats;
+    FVNMemoryGovernor* Governor = nullptr;
+
+    FWebPTiledImage Source;
+    FIntRect VisibleRange;
+    FIntRect RequestRange;
+
+    TMap<FIntPoint, FTile> Resident;
+    TMap<FIntPoint, FPending> Pending;
+    TArray<FIntPoint> Queue;            // Wanted, not launched yet; most urgent first
+};